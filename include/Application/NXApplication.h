@@ -30,9 +30,10 @@
 @interface Application : NXObject {
 @private
   id<ApplicationDelegate> _delegate; ///< The application delegate
-  BOOL _run;       ///< Flag to indicate if the application is running
-  int _exitstatus; ///< Exit status of the application
-  NXArray *_args;  ///< Command-line arguments passed to the application
+  BOOL _run;        ///< Flag to indicate if the application is running
+  int _exitstatus;  ///< Exit status of the application
+  NXArray *_args;   ///< Command-line arguments passed to the application
+  NXZone *_scratch; ///< Scratch zone, reset on each run loop iteration
 }
 
 /**
@@ -51,6 +52,20 @@
  */
 - (NXArray *)args;
 
+/**
+ * @brief Returns the scratch zone for the run loop.
+ * @return A scratch zone, or nil if it could not be created.
+ *
+ * Objects which are only needed while handling one event, such as
+ * formatted strings, can be allocated in this zone with allocWithZone:.
+ * After each run loop iteration the autorelease pool is drained and then
+ * the zone is reset, so these objects must not be kept or retained past
+ * the end of the event.
+ *
+ * @see NXZone scratchZoneWithSize:
+ */
+- (NXZone *)scratchZone;
+
 /**
  * @brief Gets the current application delegate.
  * @return The current application delegate, or nil if no delegate is set.
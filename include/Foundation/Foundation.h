@@ -17,6 +17,8 @@
 @class NXAutoreleasePool;
 @class NXData;
 @class NXDate;
+@class NXJSON;
+@class NXJSONWriter;
 @class NXNull;
 @class NXNumber;
 @class NXMap;
@@ -36,6 +38,7 @@
 // Protocols and Category Definitions
 #include "Collection+Protocol.h"
 #include "JSON+Protocol.h"
+#include "JSONDelegate+Protocol.h"
 #include "Object+Description.h"
 #include "Retain+Protocol.h"
 
@@ -44,6 +47,8 @@
 #include "NXAutoreleasePool.h"
 #include "NXData.h"
 #include "NXDate.h"
+#include "NXJSON.h"
+#include "NXJSONWriter.h"
 #include "NXMap.h"
 #include "NXNull.h"
 #include "NXNumber.h"
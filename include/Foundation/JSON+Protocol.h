@@ -32,4 +32,16 @@
  */
 - (size_t)JSONBytes;
 
+@optional
+/**
+ * @brief Writes the JSON representation of the instance.
+ * @param writer The writer to which the JSON is appended.
+ * @return YES on success, or NO if the writer failed.
+ *
+ * Objects which implement this method are written without creating a
+ * string for their JSON representation, and collections write their
+ * elements to the same writer as they are traversed.
+ */
+- (BOOL)writeJSON:(NXJSONWriter *)writer;
+
 @end
@@ -0,0 +1,59 @@
+/**
+ * @file JSONDelegate+Protocol.h
+ * @brief Defines a protocol for receiving the events of a JSON parser.
+ */
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+
+/**
+ * @brief Events which are passed to the delegate of a JSON parser.
+ * @ingroup Foundation
+ */
+typedef enum {
+  NXJSONEventNull,        ///< A null value
+  NXJSONEventTrue,        ///< A true value
+  NXJSONEventFalse,       ///< A false value
+  NXJSONEventNumber,      ///< A number, as text
+  NXJSONEventString,      ///< A string value
+  NXJSONEventKey,         ///< The key of the next value in an object
+  NXJSONEventObjectStart, ///< The start of an object
+  NXJSONEventObjectEnd,   ///< The end of an object
+  NXJSONEventArrayStart,  ///< The start of an array
+  NXJSONEventArrayEnd,    ///< The end of an array
+} NXJSONEvent;
+
+///////////////////////////////////////////////////////////////////////////////
+// PROTOCOL DEFINITIONS
+
+/**
+ * @protocol JSONDelegate
+ * @ingroup Foundation
+ * @headerfile JSONDelegate+Protocol.h Foundation/Foundation.h
+ * @brief A protocol for receiving the events of a JSON parser.
+ *
+ * A parser created with a delegate does not create any objects. Instead, the
+ * delegate receives an event for each value, key and the start and end of
+ * each array and object, in the order they appear in the input.
+ */
+@protocol JSONDelegate
+
+@required
+/**
+ * @brief Called for each event of the parser.
+ * @param parser The parser.
+ * @param event The event.
+ * @param bytes For numbers, the text of the number, which is not
+ * null-terminated. For strings and keys, the unescaped UTF-8 bytes, which
+ * are null-terminated. Otherwise NULL. The bytes are only valid during the
+ * call.
+ * @param length The number of bytes, not including a null terminator.
+ * @return YES to continue parsing, or NO to stop the parser with an error.
+ */
+- (BOOL)parser:(NXJSON *)parser
+      didParse:(NXJSONEvent)event
+         bytes:(const char *)bytes
+        length:(size_t)length;
+
+@end
@@ -17,6 +17,15 @@
  * all objects that have been added to it. This is particularly useful in loops
  * where many temporary objects are created.
  *
+ * Objects are stored in pages of object pointers, so adding an object to
+ * the pool is a single store, and the pool is drained in order through
+ * memory. An object can be added to a pool more than once, and is sent a
+ * `release` message each time.
+ *
+ * Each thread has its own stack of autorelease pools, so a thread which
+ * autoreleases objects needs to create a pool first, and drain it itself.
+ * A pool must be used and released only on the thread which created it.
+ *
  * \headerfile NXAutoreleasePool.h Foundation/Foundation.h
  */
 @interface NXAutoreleasePool : NXObject {
@@ -28,17 +37,18 @@
   id _prev;
 
   /**
-   * @var _tail
-   * @brief A pointer to the last NXObject added to the stack.
+   * @var _page
+   * @brief The page which objects are added to, which is linked to the
+   * previous pages.
    */
-  id _tail;
+  void *_page;
 }
 
 /**
  * @brief The current autorelease pool.
  *
- * This variable holds the current autorelease pool that is being used.
- * It is automatically set when an autorelease pool is created.
+ * This returns the most recent autorelease pool created by the calling
+ * thread which has not been released, or nil if the thread has no pool.
  */
 + (id)currentPool;
 
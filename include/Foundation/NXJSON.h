@@ -0,0 +1,151 @@
+/**
+ * @file NXJSON.h
+ * @brief Defines a class which parses JSON into objects.
+ */
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS
+
+/**
+ * @brief Maximum depth of nested arrays and objects which can be parsed.
+ */
+#define NXJSON_MAX_DEPTH 64
+
+///////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+
+/**
+ * @brief Options for parsing JSON.
+ * @ingroup Foundation
+ */
+typedef enum {
+  NXJSONOptionNone = 0, ///< Strings are copied from the input
+  /**
+   * Strings are unescaped in the input, which is modified, and reference it
+   * instead of being copied. The input must not be changed or freed while
+   * the strings are in use.
+   */
+  NXJSONOptionNoCopy = (1 << 0),
+} NXJSONOptions;
+
+///////////////////////////////////////////////////////////////////////////////
+// CLASS DEFINITIONS
+
+/**
+ * @brief A class which parses JSON.
+ * @ingroup Foundation
+ *
+ * A parser reads JSON in chunks of any size, passed to parseBytes:length:
+ * as they arrive, followed by finish. Without a delegate, the parser creates
+ * objects as it reads: NXMap for objects, NXArray for arrays, NXString for
+ * strings, NXNumber for integers, true and false, and NXNull for null. Maps,
+ * arrays and strings can be allocated from a zone. Numbers with
+ * a fraction or exponent, and integers which do not fit in 64 bits, are
+ * returned as an NXString of the number, since there is no floating-point
+ * NXNumber.
+ *
+ * A parser with a delegate does not create objects, and passes an event to
+ * the delegate for each token instead.
+ *
+ * \headerfile NXJSON.h Foundation/Foundation.h
+ */
+@interface NXJSON : NXObject {
+@private
+  void *_parser;               ///< Parser state
+  id<JSONDelegate> _delegate;  ///< Receives the events, or nil
+  NXZone *_objectZone;         ///< Zone for the parsed objects, or nil
+  id _object;                  ///< The parsed object
+  id _key;                     ///< Key for the next value in a map
+  size_t _depth;               ///< Number of open arrays and maps
+  id _stack[NXJSON_MAX_DEPTH]; ///< The open arrays and maps
+  BOOL _nocopy;                ///< Strings reference the input
+  BOOL _finished;              ///< The input was one complete value
+}
+
+/**
+ * @brief Returns the object parsed from JSON data.
+ * @param data The JSON data, which must be a complete value.
+ * @return An autoreleased object, or nil if the data is not valid JSON.
+ */
++ (id)objectWithData:(NXData *)data;
+
+/**
+ * @brief Returns the object parsed from a JSON string.
+ * @param string The JSON string, which must be a complete value.
+ * @return An autoreleased object, or nil if the string is not valid JSON.
+ */
++ (id)objectWithString:(id<NXConstantStringProtocol>)string;
+
+/**
+ * @brief Returns the object parsed from JSON data, allocated from a zone.
+ * @param data The JSON data, which must be a complete value.
+ * @param zone The zone for the maps, arrays and strings, or nil for the
+ * default zone.
+ * @param options NXJSONOptionNoCopy to parse the data in place, so that
+ * strings are not copied. The data is modified, and must not be changed or
+ * released while the strings are in use.
+ * @return An autoreleased object, or nil if the data is not valid JSON.
+ */
++ (id)objectWithData:(NXData *)data
+                zone:(NXZone *)zone
+             options:(NXJSONOptions)options;
+
+/**
+ * @brief Initializes a parser which creates objects in the default zone.
+ */
+- (id)init;
+
+/**
+ * @brief Initializes a parser which creates objects in a zone.
+ * @param zone The zone for the maps, arrays and strings, or nil for the
+ * default zone. The zone is not retained.
+ */
+- (id)initWithZone:(NXZone *)zone;
+
+/**
+ * @brief Initializes a parser which passes events to a delegate.
+ * @param delegate The delegate, which is not retained.
+ */
+- (id)initWithDelegate:(id<JSONDelegate>)delegate;
+
+/**
+ * @brief Parses a chunk of JSON.
+ * @param bytes The chunk, which is not modified.
+ * @param length The number of bytes in the chunk.
+ * @return YES on success, or NO if the input is not valid JSON or the
+ * delegate stopped the parser. Once a chunk fails, the parser must be
+ * reset before it is used again.
+ *
+ * Tokens may be split between chunks.
+ */
+- (BOOL)parseBytes:(const void *)bytes length:(size_t)length;
+
+/**
+ * @brief Completes parsing at the end of the input.
+ * @return YES if the input was one complete JSON value, or NO otherwise.
+ */
+- (BOOL)finish;
+
+/**
+ * @brief Returns the parsed object.
+ * @return The object, or nil if parsing has not finished successfully or the
+ * parser has a delegate.
+ */
+- (id)object;
+
+/**
+ * @brief Returns the reason parsing failed.
+ * @return A description of the error and its offset in the input, or nil if
+ * parsing has not failed.
+ */
+- (NXString *)error;
+
+/**
+ * @brief Resets the parser, so that it can parse another value.
+ *
+ * The parsed object is released.
+ */
+- (void)reset;
+
+@end
@@ -0,0 +1,161 @@
+/**
+ * @file NXJSONWriter.h
+ * @brief Defines a class which writes the JSON representation of objects.
+ */
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// TYPE DEFINITIONS
+
+/**
+ * @brief A function which receives the output of a JSON writer.
+ * @ingroup Foundation
+ * @param context The context pointer passed when the writer was created.
+ * @param bytes The bytes to output, which are not null-terminated.
+ * @param length The number of bytes to output.
+ * @return YES if the bytes were written, or NO to stop the writer.
+ */
+typedef BOOL (*NXJSONSink)(void *context, const char *bytes, size_t length);
+
+///////////////////////////////////////////////////////////////////////////////
+// CLASS DEFINITIONS
+
+/**
+ * @brief A class which writes objects as JSON in a single pass.
+ * @ingroup Foundation
+ *
+ * A writer appends the JSON representation of objects, with nested arrays
+ * and maps written as they are traversed, to one buffer which grows as
+ * needed. The buffer can then be returned as a string without copying it.
+ * Alternatively, a writer created with a sink passes its output to the sink
+ * function in chunks, so that the output does not need to fit in memory.
+ *
+ * Objects which implement writeJSON: from the JSONProtocol are asked to
+ * write themselves. Other objects which conform to the protocol are written
+ * with their JSONString method, and any other object is written as the
+ * quoted string of its description.
+ *
+ * \headerfile NXJSONWriter.h Foundation/Foundation.h
+ */
+@interface NXJSONWriter : NXObject {
+@private
+  char *_data;      ///< Buffer for the output
+  size_t _length;   ///< Number of bytes in the buffer
+  size_t _cap;      ///< Capacity of the buffer in bytes
+  size_t _written;  ///< Number of bytes already passed to the sink
+  NXJSONSink _sink; ///< Sink for the output, or NULL
+  void *_context;   ///< Context pointer passed to the sink
+  BOOL _failed;     ///< Set when a write fails
+}
+
+/**
+ * @brief Returns a new writer which writes to a buffer.
+ * @param capacity The initial capacity of the buffer in bytes.
+ * @return A new autoreleased writer, or nil if the allocation failed.
+ */
++ (NXJSONWriter *)writerWithCapacity:(size_t)capacity;
+
+/**
+ * @brief Returns a new writer which passes its output to a sink function.
+ * @param sink The function which receives the output.
+ * @param context A pointer passed to the sink function.
+ * @return A new autoreleased writer, or nil if the allocation failed.
+ *
+ * Output is collected in a small buffer, which is passed to the sink when
+ * it is full and when flush is called.
+ */
++ (NXJSONWriter *)writerWithSink:(NXJSONSink)sink context:(void *)context;
+
+/**
+ * @brief Returns the JSON representation of an object.
+ * @param object The object to write, or nil for a JSON null.
+ * @return A new autoreleased string, or nil if the object could not be
+ * written.
+ */
++ (NXString *)stringWithObject:(id)object;
+
+/**
+ * @brief Initializes a writer which writes to a buffer.
+ * @param capacity The initial capacity of the buffer in bytes.
+ */
+- (id)initWithCapacity:(size_t)capacity;
+
+/**
+ * @brief Initializes a writer which passes its output to a sink function.
+ * @param sink The function which receives the output.
+ * @param context A pointer passed to the sink function.
+ */
+- (id)initWithSink:(NXJSONSink)sink context:(void *)context;
+
+/**
+ * @brief Writes the JSON representation of an object.
+ * @param object The object to write, or nil for a JSON null.
+ * @return YES on success, or NO if this or an earlier write failed.
+ */
+- (BOOL)writeObject:(id)object;
+
+/**
+ * @brief Writes bytes to the output without escaping them.
+ * @param bytes The bytes to write.
+ * @param length The number of bytes to write.
+ * @return YES on success, or NO if this or an earlier write failed.
+ */
+- (BOOL)writeBytes:(const char *)bytes length:(size_t)length;
+
+/**
+ * @brief Writes a null-terminated string to the output without escaping it.
+ * @param cStr The string to write.
+ * @return YES on success, or NO if this or an earlier write failed.
+ */
+- (BOOL)writeCString:(const char *)cStr;
+
+/**
+ * @brief Writes bytes as a quoted JSON string.
+ * @param bytes The bytes of the string, which may include null bytes.
+ * @param length The number of bytes in the string.
+ * @return YES on success, or NO if this or an earlier write failed.
+ *
+ * Quotes, backslashes and control characters are escaped. Runs of bytes
+ * which do not need escaping are copied at once.
+ */
+- (BOOL)writeQuotedBytes:(const char *)bytes length:(size_t)length;
+
+/**
+ * @brief Writes a signed integer in decimal.
+ * @param value The value to write.
+ * @return YES on success, or NO if this or an earlier write failed.
+ */
+- (BOOL)writeInt64:(int64_t)value;
+
+/**
+ * @brief Writes an unsigned integer in decimal.
+ * @param value The value to write.
+ * @return YES on success, or NO if this or an earlier write failed.
+ */
+- (BOOL)writeUnsignedInt64:(uint64_t)value;
+
+/**
+ * @brief Passes any buffered output to the sink.
+ * @return YES on success, or NO if this or an earlier write failed. A writer
+ * without a sink returns YES unless a write failed.
+ */
+- (BOOL)flush;
+
+/**
+ * @brief Returns the output of a writer without a sink as a string.
+ * @return A new autoreleased string, or nil if a write failed or the writer
+ * has a sink.
+ *
+ * The buffer is passed to the string without copying it, and the writer is
+ * empty afterwards, so it can be reused.
+ */
+- (NXString *)string;
+
+/**
+ * @brief Returns the number of bytes written.
+ * @return The number of bytes written, including bytes which have been
+ * passed to the sink.
+ */
+- (size_t)length;
+
+@end
@@ -108,7 +108,10 @@
 
 /**
  * @brief Returns the capacity of the map.
- * @return The maximum number of elements the map can hold before resizing.
+ * @return The number of slots in the hash table of the map, which is a power
+ * of two. The table is resized when three quarters of the slots hold a key
+ * or a removed key, so the map holds fewer elements than this before it is
+ * resized.
  */
 - (size_t)capacity;
 
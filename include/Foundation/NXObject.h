@@ -8,6 +8,37 @@
  */
 #pragma once
 
+/**
+ * @brief Keeps the instances of a class in a pool of fixed-size slots.
+ * @param count The number of slots added to the pool at a time.
+ *
+ * Place this macro in the implementation of a class to define its
+ * objectPool method. Instances allocated with alloc, or allocWithZone: with
+ * a nil zone, are then taken from a pool zone for the class and returned to
+ * it when they are deallocated. The pool is created on first use and is
+ * never freed. Subclasses share the pool, and instances which are too large
+ * for a slot are allocated from the default zone.
+ *
+ * Only use a pool for classes which do not allocate other memory from the
+ * zone of the instance, since a pool zone only allocates slots.
+ */
+#define NXOBJECT_POOL(count)                                                   \
+  +(NXZone *)objectPool {                                                      \
+    static NXZone *pool = nil;                                                 \
+    NXZone *zone = __atomic_load_n(&pool, __ATOMIC_ACQUIRE);                   \
+    if (zone == nil) {                                                         \
+      @synchronized([NXZone class]) {                                          \
+        zone = pool;                                                           \
+        if (zone == nil) {                                                     \
+          zone = [NXZone poolZoneWithSize:class_getInstanceSize(self)          \
+                                    count:(count)];                            \
+          __atomic_store_n(&pool, zone, __ATOMIC_RELEASE);                     \
+        }                                                                      \
+      }                                                                        \
+    }                                                                          \
+    return zone;                                                               \
+  }
+
 /**
  * @brief The base class for objects in the Foundation framework.
  * @ingroup Foundation
@@ -28,15 +59,9 @@
 
   /**
    * @var _retain
-   * @brief The retain count of the object.
-   */
-  unsigned short _retain;
-
-  /**
-   * @var _next
-   * @brief The next object in an autorelease pool.
+   * @brief The retain count of the object, which is updated atomically.
    */
-  id _next;
+  sys_atomic_t _retain;
 }
 
 /**
@@ -47,6 +72,14 @@
  */
 + (id)allocWithZone:(NXZone *)zone;
 
+/**
+ * @brief Returns the pool zone for instances of the class.
+ * @return The pool zone, or nil if the class does not use a pool.
+ *
+ * This returns nil unless the class uses NXOBJECT_POOL().
+ */
++ (NXZone *)objectPool;
+
 /**
  * @brief Increases the retain count of the receiver.
  * @return The receiver, with its retain count incremented.
@@ -5,6 +5,19 @@
  */
 #pragma once
 
+///////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS
+
+/**
+ * @brief Size of the buffer within each string, in bytes.
+ *
+ * Strings which fit in this many bytes, including the null terminator, are
+ * stored in the string object rather than in separately allocated memory.
+ * The size keeps the object, with its cached hash, within 64 bytes on 64-bit
+ * targets.
+ */
+#define NXSTRING_INLINE_SIZE 12
+
 ///////////////////////////////////////////////////////////////////////////////
 // CLASS DEFINITIONS
 
@@ -20,10 +33,12 @@
 @interface NXString : NXObject <NXConstantStringProtocol, JSONProtocol> {
 @private
   const char *_value; ///< Pointer to the string data
+  char *_data;        ///< Pointer to the retained string data
   unsigned int
-      _length; ///< Length of the string in bytes, excluding null terminator
-  char *_data; ///< Pointer to the retained string data
-  size_t _cap; ///< Capacity of the retained string data buffer
+      _length;       ///< Length of the string in bytes, excluding null terminator
+  unsigned int _cap; ///< Capacity of the retained string data buffer
+  char _inline[NXSTRING_INLINE_SIZE]; ///< Retained data for short strings
+  uint32_t _hash; ///< Cached hash of the string, or zero if not computed
 }
 
 /**
@@ -143,6 +158,15 @@
  */
 - (unsigned int)length;
 
+/**
+ * @brief Returns a hash of the string content.
+ * @return The hash, which is the same for strings which are equal.
+ *
+ * The hash is computed when it is first needed and cached, until the string
+ * is changed.
+ */
+- (uintptr_t)hash;
+
 /**
  * @brief Returns the mutable C-string representation of the string.
  * @return A pointer to a null-terminated C-string representing the string
@@ -16,7 +16,22 @@
  *
  * NXZone provides a mechanism for managing memory allocations. It can
  * be used to create memory arenas of a fixed size, from which objects can be
- * allocated.
+ * allocated. Small allocations are made from slabs of fixed-size blocks, so
+ * that allocating and freeing them takes constant time.
+ *
+ * Each thread keeps a cache of small free blocks for the first zone it
+ * allocates from, so that most small allocations do not take the zone lock.
+ * Blocks in a thread cache are counted as used until the cache is flushed,
+ * which happens when the thread exits.
+ *
+ * A scratch zone, created with scratchZoneWithSize:, is for objects which
+ * only live for a short time, such as one iteration of a run loop. Memory
+ * is allocated by moving a pointer forward, freeing memory does nothing, and
+ * all the memory is recycled at once when the zone is reset.
+ *
+ * A pool zone, created with poolZoneWithSize:count:, holds slots of one
+ * size on a free list, so allocating and freeing a slot is a push or pop.
+ * A class can keep its instances in a pool zone with NXOBJECT_POOL().
  *
  * \headerfile NXZone.h Foundation/Foundation.h
  */
@@ -25,8 +40,11 @@
   size_t _size;  ///< Initial allocated size of the memory zone in bytes
   size_t _count; ///< Current number of active allocations in the zone
 @private
-  void *_root; ///< Root arena data pointer
-  void *_cur;  ///< Current arena data pointer
+  void *_root;    ///< Root arena data pointer
+  void *_cur;     ///< Current arena data pointer
+  void *_slabs;   ///< Size-class slab data pointer
+  void *_caches;  ///< Thread caches for the zone
+  void *_profile; ///< Allocation statistics, when built with NXZONE_PROFILE
 }
 
 /**
@@ -46,6 +64,39 @@
  */
 + (id)zoneWithSize:(size_t)size;
 
+/**
+ * @brief Creates a new scratch zone with a specified size.
+ * @param size The size of the scratch zone with initial capacity in bytes.
+ * @return A new NXZone instance, or nil if the allocation failed.
+ *
+ * Allocations from a scratch zone take the next free bytes, and are not
+ * freed individually: the free: method does nothing, and all allocations are
+ * recycled at once by calling reset. The zone grows by at least the initial
+ * capacity when it runs out of space. A scratch zone is never used as the
+ * default zone.
+ *
+ * Objects can be created in a scratch zone with allocWithZone:, and must
+ * not be used after the zone is reset, even if they are still retained.
+ */
++ (id)scratchZoneWithSize:(size_t)size;
+
+/**
+ * @brief Creates a new pool zone of fixed-size slots.
+ * @param size The size of each slot in bytes.
+ * @param count The number of slots to allocate at first, and each time the
+ * pool runs out of free slots.
+ * @return A new NXZone instance, or nil if the allocation failed.
+ *
+ * Allocations which are not larger than the slot size take the most
+ * recently freed slot, and larger allocations return NULL. A pool zone is
+ * never used as the default zone. The bytesUsed, bytesFree and dump
+ * methods report the slots in use, the free slots and the highest number
+ * of slots used.
+ *
+ * @see NXOBJECT_POOL
+ */
++ (id)poolZoneWithSize:(size_t)size count:(size_t)count;
+
 /**
  * @brief Deallocates the memory zone.
  * @details This frees the memory block managed by the zone.
@@ -65,6 +116,40 @@
  */
 - (void)free:(void *)ptr;
 
+/**
+ * @brief Changes the size of a block of memory allocated from the zone.
+ * @param ptr A pointer to the memory block, or NULL to allocate a new block.
+ * @param size The new size of the memory block in bytes, or zero to free it.
+ * @return A pointer to the resized memory, which may have moved, or NULL if
+ * the allocation fails, in which case the original block is unchanged.
+ *
+ * The block is resized in place when there is free space after it, so that
+ * a buffer which grows does not need two copies of its contents at once.
+ * Otherwise the contents are copied to a new block and the old block is
+ * freed. A pool zone returns NULL for sizes larger than its slots.
+ */
+- (void *)reallocWithPtr:(void *)ptr size:(size_t)size;
+
+/**
+ * @brief Returns the small blocks cached by the calling thread to the zone.
+ *
+ * A thread which has finished allocating from the zone, but which does not
+ * exit, can call this method so that other threads can reuse the blocks in
+ * its cache. The cache of a thread is flushed and freed when the thread
+ * exits, and the caches of all threads are flushed when the zone is
+ * deallocated.
+ */
+- (void)flushCache;
+
+/**
+ * @brief Recycles all the memory allocated from a scratch zone.
+ *
+ * Every allocation from a scratch zone becomes invalid, and the memory is
+ * reused by the next allocations. This method does nothing for other zones,
+ * where memory is freed one allocation at a time.
+ */
+- (void)reset;
+
 /**
  * @brief Walks through the zone and outputs information about allocations.
  *
@@ -73,6 +158,30 @@
  */
 - (void)dump;
 
+/**
+ * @brief Prints the live allocations in the zone for each class.
+ * @param limit The maximum number of classes to print, or zero for all.
+ *
+ * When Foundation is built with `-D NXZONE_PROFILE=ON`, each zone records
+ * the class of every object allocated with allocWithZone:, and keeps the
+ * live count, live bytes and high-water marks for each class, and the
+ * allocation rate. This method prints the totals, and a histogram of the
+ * classes ordered by live bytes. Memory which is not an object is printed
+ * as one row. Without the option, a warning is printed.
+ *
+ * A zone which is deallocated with live allocations prints the same
+ * report before it panics, so leaked objects can be found by class.
+ */
+- (void)dumpProfile:(size_t)limit;
+
+/**
+ * @brief Resets the high-water marks and the allocation rate of the zone.
+ *
+ * The live counts and bytes are kept. This method does nothing unless
+ * Foundation is built with `-D NXZONE_PROFILE=ON`.
+ */
+- (void)resetProfile;
+
 /**
  * @brief Returns the total size of the memory zone.
  * @return The total size of the zone in bytes.
@@ -49,4 +49,12 @@
  */
 - (unsigned int)length;
 
+/**
+ * @brief Returns a hash of the string content.
+ * @return The djb2 hash of the bytes of the string, truncated to 32 bits.
+ *         Strings which are equal have the same hash, whatever class they
+ *         are.
+ */
+- (uintptr_t)hash;
+
 @end
@@ -36,6 +36,12 @@
  */
 - (unsigned int)length;
 
+/**
+ * @brief Returns a hash of the constant string.
+ * @return The djb2 hash of the string, truncated to 32 bits.
+ */
+- (uintptr_t)hash;
+
 @end
 
 #ifdef __clang__
@@ -90,6 +90,33 @@ OBJC_ROOT_CLASS
  */
 + (const char *)name;
 
+/**
+ * @brief Returns the implementation of an instance method.
+ * @param aSelector The selector of the method.
+ * @return The function which is called when aSelector is sent to the
+ * receiver, or NULL if the receiver does not respond to it.
+ *
+ * The implementation can be called directly, bypassing message dispatch,
+ * which is useful when the same message is sent many times in a loop.
+ */
+- (IMP)methodForSelector:(SEL)aSelector;
+
+/**
+ * @brief Returns the implementation of a class method.
+ * @param aSelector The selector of the method.
+ * @return The function which is called when aSelector is sent to the class,
+ * or NULL if the class does not respond to it.
+ */
++ (IMP)methodForSelector:(SEL)aSelector;
+
+/**
+ * @brief Returns the implementation of an instance method of the class.
+ * @param aSelector The selector of the method.
+ * @return The function which is called when aSelector is sent to an instance
+ * of the class, or NULL if instances do not respond to it.
+ */
++ (IMP)instanceMethodForSelector:(SEL)aSelector;
+
 /**
  * @brief Compares the receiver to another object for equality.
  * @param anObject The object to compare with the receiver.
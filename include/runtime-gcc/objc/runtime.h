@@ -214,6 +214,37 @@ BOOL class_metaclassRespondsToSelector(Class cls, SEL sel);
  */
 BOOL class_respondsToSelector(Class cls, SEL sel);
 
+/**
+ * @brief Returns the implementation of an instance method.
+ * @ingroup objc
+ * @param cls The class to inspect.
+ * @param sel The selector of the method.
+ * @return The function which is called when the selector is sent to an
+ * instance of the class, or `NULL` if instances do not respond to it.
+ *
+ * The class is sent +initialize, and categories are loaded, before the
+ * implementation is looked up. The result can be called directly, in place of
+ * sending a message, and remains valid for the lifetime of the program:
+ *
+ * @code
+ * IMP imp = class_getMethodImplementation([obj class], @selector(draw));
+ * for (size_t i = 0; i < count; i++) {
+ *   ((void (*)(id, SEL))imp)(objs[i], @selector(draw));
+ * }
+ * @endcode
+ */
+IMP class_getMethodImplementation(Class cls, SEL sel);
+
+/**
+ * @brief Returns the implementation of a class method.
+ * @ingroup objc
+ * @param cls The class to inspect.
+ * @param sel The selector of the method.
+ * @return The function which is called when the selector is sent to the
+ * class, or `NULL` if the class does not respond to it.
+ */
+IMP class_getClassMethodImplementation(Class cls, SEL sel);
+
 /**
  * @brief Returns the name of a selector.
  * @ingroup objc
@@ -222,6 +253,79 @@ BOOL class_respondsToSelector(Class cls, SEL sel);
  */
 const char *sel_getName(SEL sel);
 
+/**
+ * @brief Registers a selector name with the runtime.
+ * @ingroup objc
+ * @param name The name of the selector to register.
+ * @return The selector, or `NULL` if `name` is `NULL`.
+ *
+ * Selectors are unique by name, so registering the same name twice returns
+ * selectors which compare equal with sel_isEqual(). The name is copied if it
+ * has not been registered before.
+ */
+SEL sel_registerName(const char *name);
+
+/**
+ * @brief Returns the selector for a name, registering it if necessary.
+ * @ingroup objc
+ * @param name The name of the selector.
+ * @return The selector, or `NULL` if the name is `NULL`.
+ *
+ * This is the same as sel_registerName(), as in the GNU and Apple runtimes.
+ */
+SEL sel_getUid(const char *name);
+
+/**
+ * @brief Checks if two selectors have the same name.
+ * @ingroup objc
+ * @param sel The first selector.
+ * @param other The second selector.
+ * @return `YES` if the selectors have the same name, `NO` otherwise.
+ *
+ * Selector names are uniqued when they are registered, so this is a pointer
+ * comparison.
+ */
+BOOL sel_isEqual(SEL sel, SEL other);
+
+/**
+ * @brief Prints the message sends with the highest counts.
+ * @ingroup objc
+ * @param limit The maximum number of rows to print, or 0 to print all rows.
+ *
+ * For each class and selector, prints the number of messages sent, the
+ * number of lookups which missed the dispatch cache, the number of
+ * superclasses walked by those lookups, and the number of times +initialize
+ * was sent. Rows are ordered by the number of messages sent.
+ *
+ * The counters are only maintained when the runtime is built with the
+ * `OBJC_PROFILE` CMake option, otherwise this function prints a warning.
+ */
+void objc_profile_dump(size_t limit);
+
+/**
+ * @brief Resets the counters printed by objc_profile_dump().
+ * @ingroup objc
+ */
+void objc_profile_reset(void);
+
+/**
+ * @brief Returns the counters printed by objc_profile_dump() for a class and
+ * selector.
+ * @ingroup objc
+ * @param cls The class of the receiver, which is the metaclass for class
+ * methods.
+ * @param sel The selector.
+ * @param sends Updated with the number of messages sent, or NULL.
+ * @param lookups Updated with the number of lookups which missed the
+ * dispatch cache, or NULL.
+ * @param hops Updated with the number of superclasses walked by those
+ * lookups, or NULL.
+ * @return YES if the runtime was built with the `OBJC_PROFILE` CMake option,
+ * or NO if it was not, in which case the counters are zero.
+ */
+BOOL objc_profile_counters(Class cls, SEL sel, uint32_t *sends,
+                           uint32_t *lookups, uint32_t *hops);
+
 /**
  * @brief Returns the name of a protocol.
  * @ingroup objc
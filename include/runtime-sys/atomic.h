@@ -7,6 +7,10 @@
  * This API allows you to maintain a uint32_t value across threads safely.
  * The operations are to get, set, increment and decrement. For the increment
  * and decrement operations return the new value.
+ *
+ * Most operations use relaxed ordering. The acquire and release variants, and
+ * compare-and-swap, can be used when the value guards other memory, for
+ * example a reference count which guards the object it counts.
  */
 #pragma once
 #include <stdbool.h>
@@ -106,6 +110,69 @@ static inline uint32_t sys_atomic_dec(sys_atomic_t *a) {
   return __atomic_sub_fetch(&a->value, 1, __ATOMIC_RELAXED);
 }
 
+/**
+ * @brief Atomic operations on the value are lock-free.
+ * @ingroup SystemSync
+ *
+ * This is defined as 1 when the compiler implements atomic operations on the
+ * value with native instructions, and 0 when they are implemented with locks
+ * (for example on ARMv6-M / RP2040). Callers which already hold a lock may
+ * prefer plain operations when this is 0.
+ */
+#if defined(__GCC_ATOMIC_INT_LOCK_FREE) && __GCC_ATOMIC_INT_LOCK_FREE == 2
+#define SYS_ATOMIC_LOCK_FREE 1
+#else
+#define SYS_ATOMIC_LOCK_FREE 0
+#endif
+
+/**
+ * @brief Load the current value atomically, with acquire ordering.
+ * @ingroup SystemSync
+ *
+ * @param a Pointer to the atomic value (must be non-NULL).
+ * @return The current 32-bit value.
+ *
+ * Memory operations after the load cannot be reordered before it, so writes
+ * published by a release store of the same value are visible.
+ */
+static inline uint32_t sys_atomic_get_acquire(const sys_atomic_t *a) {
+  return __atomic_load_n(&a->value, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Store a new value atomically, with release ordering.
+ * @ingroup SystemSync
+ *
+ * @param a Pointer to the atomic value (must be non-NULL).
+ * @param v The value to store.
+ *
+ * Memory operations before the store cannot be reordered after it, so they
+ * are visible to a thread which loads the value with acquire ordering.
+ */
+static inline void sys_atomic_set_release(sys_atomic_t *a, uint32_t v) {
+  __atomic_store_n(&a->value, v, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Atomically replace the value if it is equal to an expected value.
+ * @ingroup SystemSync
+ *
+ * @param a Pointer to the atomic value (must be non-NULL).
+ * @param expected Pointer to the expected value (must be non-NULL). On
+ * failure, it is updated with the current value.
+ * @param desired The value to store if the current value is equal to the
+ * expected value.
+ * @return true if the value was replaced, false otherwise.
+ *
+ * On success the operation has acquire and release ordering; on failure it is
+ * a relaxed load. The operation may fail spuriously, so call it in a loop.
+ */
+static inline bool sys_atomic_cas(sys_atomic_t *a, uint32_t *expected,
+                                  uint32_t desired) {
+  return __atomic_compare_exchange_n(&a->value, expected, desired, true,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
 /**
  * @brief Atomically set bits (OR with mask).
  * @ingroup SystemSync
@@ -33,9 +33,14 @@
  * Consumers will be woken up and any further attempts to push events will fail,
  * but existing events can still be popped, until the queue is empty.
  *
+ * Event payloads can be allocated from a sys_event_pool_t, a fixed number of
+ * slots which are claimed and released without a mutex, so that producers in
+ * timer callbacks and interrupt handlers do not block or allocate memory.
+ *
  * @example examples/runtime/gpio/main.c
  */
 #pragma once
+#include "atomic.h"
 #include "sync.h"
 #include <stdbool.h>
 #include <stddef.h>
@@ -250,6 +255,88 @@ static inline bool sys_event_queue_valid(sys_event_queue_t *queue) {
   return true;
 }
 
+/**
+ * @brief Pool of fixed-size slots for event payloads.
+ * @ingroup SystemEvents
+ * @headerfile event.h runtime-sys/sys.h
+ *
+ * The slots are allocated when the pool is initialized, and the pool never
+ * grows. A slot is claimed and released with atomic operations on a bitmap,
+ * without a mutex, so payloads can be allocated in timer callbacks and
+ * interrupt handlers, and freed by the consumer of the queue.
+ */
+typedef struct {
+  uint8_t *slots;     ///< Memory for the slots
+  sys_atomic_t *used; ///< Bitmap of the slots in use, 32 slots per word
+  size_t size;        ///< Size of each slot in bytes
+  size_t count;       ///< Number of slots
+} sys_event_pool_t;
+
+/**
+ * @brief Initialize a new event pool
+ * @ingroup SystemEvents
+ * @param size Size of each slot in bytes
+ * @param count Number of slots in the pool
+ * @return Initialized event pool structure
+ *
+ * Allocates all the slots of the pool. The returned pool must be finalized
+ * with sys_event_pool_finalize(). If the memory cannot be allocated, the
+ * pool is not valid.
+ */
+sys_event_pool_t sys_event_pool_init(size_t size, size_t count);
+
+/**
+ * @brief Finalize and cleanup an event pool
+ * @ingroup SystemEvents
+ * @param pool Pointer to the pool to finalize
+ *
+ * Releases the memory of the slots. No slots should be in use.
+ */
+void sys_event_pool_finalize(sys_event_pool_t *pool);
+
+/**
+ * @brief Allocate a slot from the pool
+ * @ingroup SystemEvents
+ * @param pool Pointer to the event pool
+ * @return Pointer to the slot, or NULL if every slot is in use
+ *
+ * This does not block or allocate memory, and can be called from timer
+ * callbacks and interrupt handlers.
+ */
+void *sys_event_pool_alloc(sys_event_pool_t *pool);
+
+/**
+ * @brief Return a slot to the pool
+ * @ingroup SystemEvents
+ * @param pool Pointer to the event pool
+ * @param ptr Pointer to the slot, or NULL
+ *
+ * This does not block, and can be called from timer callbacks and interrupt
+ * handlers.
+ */
+void sys_event_pool_free(sys_event_pool_t *pool, void *ptr);
+
+/**
+ * @brief Get the number of slots in use
+ * @ingroup SystemEvents
+ * @param pool Pointer to the event pool
+ * @return Number of slots in use, or 0 on error
+ *
+ * This is a snapshot value that may change immediately after the call
+ * returns in a multi-threaded environment.
+ */
+size_t sys_event_pool_used(sys_event_pool_t *pool);
+
+/**
+ * @brief Check if the pool is valid and usable for operations
+ * @ingroup SystemEvents
+ * @param pool Pointer to the event pool
+ * @return true if the pool is valid, false otherwise
+ */
+static inline bool sys_event_pool_valid(sys_event_pool_t *pool) {
+  return pool != NULL && pool->slots != NULL && pool->count > 0;
+}
+
 #ifdef __cplusplus
 }
 #endif
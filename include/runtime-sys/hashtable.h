@@ -9,6 +9,14 @@
  * This file declares types and functions for creating and managing hash tables.
  * Hash tables are a data structure that implements an associative array
  * abstract data type, a structure that can map keys to values.
+ *
+ * The table uses open addressing, probing groups of entries in turn. Each
+ * entry has a control byte holding seven bits of its mixed hash, so that a
+ * group is searched by comparing its control bytes at once: sixteen with SSE2
+ * or NEON, and four in a word on other targets. The number of entries
+ * is a power of two. When three quarters of the entries hold a key or a
+ * tombstone left by a deletion, the entries are rebuilt without the
+ * tombstones, at double the size unless most of them were tombstones.
  */
 #pragma once
 
@@ -72,7 +80,8 @@ typedef bool (*sys_hashtable_keyequals_t)(void *keyptr, void *other_keyptr);
 /**
  * @brief Initialize a new hash table
  * @ingroup SystemHashTable
- * @param size Number of entries in the hash table (must be > 0)
+ * @param size Number of entries in the hash table (must be > 0), which is
+ * rounded up to a power of two
  * @param keyequals Function to compare a key pointer to an entry for equality
  * @return Pointer to new hash table, or NULL if allocation failed
  */
@@ -80,9 +89,9 @@ sys_hashtable_t *sys_hashtable_init(size_t size,
                                     sys_hashtable_keyequals_t keyequals);
 
 /**
- * @brief Free all the hash tables in the chain
+ * @brief Free the hash table
  * @ingroup SystemHashTable
- * @param table First hash table in the chain to free
+ * @param table The hash table to free
  */
 void sys_hashtable_finalize(sys_hashtable_t *table);
 
@@ -123,7 +132,9 @@ sys_hashtable_entry_t *sys_hashtable_get_value(sys_hashtable_t *table,
  *
  * The entry returned by this function can be used to insert or update
  * a value in the hash table. If an entry with the same hash and key already
- * exists, the value should be replaced.
+ * exists, the value should be replaced. Inserting a new key may resize the
+ * table, which moves the entries, so entries returned earlier must not be
+ * used after this function is called.
  */
 sys_hashtable_entry_t *sys_hashtable_put(sys_hashtable_t *table, uintptr_t hash,
                                          void *keyptr, bool *samekey);
@@ -158,17 +169,16 @@ sys_hashtable_entry_t *
 sys_hashtable_iterator_next(sys_hashtable_t *table,
                             sys_hashtable_iterator_t **iterator);
 
-/** @brief Get the number of active entries in the hash table chain.
+/** @brief Get the number of active entries in the hash table.
  * @ingroup SystemHashTable
  * @param table The hash table to count entries in
- * @return The total number of active (non-deleted) entries across all tables in
- * the chain
+ * @return The number of active (non-deleted) entries
  */
 size_t sys_hashtable_count(sys_hashtable_t *table);
 
-/** @brief Get the total capacity of all tables in the chain.
+/** @brief Get the capacity of the hash table.
  * @ingroup SystemHashTable
  * @param table The hash table to get capacity for
- * @return The total capacity (size) of all tables in the chain
+ * @return The number of entries in the table
  */
 size_t sys_hashtable_capacity(sys_hashtable_t *table);
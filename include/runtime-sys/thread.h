@@ -107,6 +107,33 @@ bool sys_thread_create_on_core(sys_thread_func_t func, void *arg, uint8_t core);
  */
 extern uint8_t sys_thread_core(void);
 
+/**
+ * @brief Get an identifier for the current thread
+ * @ingroup SystemThread
+ * @return A value which identifies the calling thread, and which is never
+ * zero.
+ *
+ * The identifier is unique among running threads, but may be reused once a
+ * thread has terminated. On the Pico platform, where each core runs a single
+ * thread, the identifier is derived from the core number.
+ */
+extern uintptr_t sys_thread_id(void);
+
+/**
+ * @brief Register a function to call when the current thread exits
+ * @ingroup SystemThread
+ * @param func Function to call when the thread exits
+ * @param arg Argument to pass to the function
+ * @return true if the function was registered, false on error
+ *
+ * The functions registered by a thread are called in reverse order of
+ * registration when the thread terminates, so that resources kept for the
+ * thread can be released. They are not called for the main thread when the
+ * process exits. On the Pico platform, they are called when the function
+ * started with sys_thread_create_on_core() returns.
+ */
+extern bool sys_thread_atexit(sys_thread_func_t func, void *arg);
+
 /**
  * @brief Pauses the execution of the current thread for a specified time.
  * @ingroup SystemThread
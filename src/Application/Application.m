@@ -31,6 +31,11 @@ static id sharedApplication = nil;
 // Define the shared queue for events
 static sys_event_queue_t _app_queue = {0};
 
+// Define the pool for event payloads, which is kept for the process. The
+// callbacks run in timer and interrupt context, so the payloads come from
+// fixed slots which are claimed without a mutex.
+static sys_event_pool_t _app_event_pool = {0};
+
 // Optional hook implemented by Network/runtime-net (weak; NULL if absent)
 extern void net_poll(void) __attribute__((weak));
 
@@ -38,6 +43,17 @@ extern void net_poll(void) __attribute__((weak));
 #define NSAPPLICATION_HW_POLL_INTERVAL_MS 50
 #define NSAPPLICATION_NET_POLL_INTERVAL_MS 1000
 
+// Number of event payloads in addition to the capacity of the queue, for the
+// event being processed and events which are being pushed
+#define NSAPPLICATION_EVENT_SPARE 4
+
+// Initial size of the scratch zone which is reset on each run loop iteration
+#ifdef SYSTEM_NAME_PICO
+#define NSAPPLICATION_SCRATCH_SIZE 1024
+#else
+#define NSAPPLICATION_SCRATCH_SIZE 4096
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 // CALLBACKS
 
@@ -53,7 +69,7 @@ static void _app_gpio_callback(uint8_t pin, hw_gpio_event_t event,
   }
 
   // Create a app_event_t for the GPIO event
-  app_event_t *evt = sys_malloc(sizeof(app_event_t));
+  app_event_t *evt = sys_event_pool_alloc(&_app_event_pool);
   if (evt == NULL) {
     return;
   } else {
@@ -65,7 +81,8 @@ static void _app_gpio_callback(uint8_t pin, hw_gpio_event_t event,
 
   // Try and push it into the queue
   if (sys_event_queue_try_push(queue, (void *)evt) == false) {
-    sys_free((void *)evt); // Free the payload if it cannot be pushed
+    // Free the payload if it cannot be pushed
+    sys_event_pool_free(&_app_event_pool, evt);
   }
 }
 
@@ -83,7 +100,7 @@ void _app_timer_callback(sys_timer_t *timer) {
   }
 
   // Create a app_event_t for the GPIO event
-  app_event_t *evt = sys_malloc(sizeof(app_event_t));
+  app_event_t *evt = sys_event_pool_alloc(&_app_event_pool);
   if (evt == NULL) {
     return;
   } else {
@@ -93,7 +110,8 @@ void _app_timer_callback(sys_timer_t *timer) {
 
   // Try and push it into the queue
   if (sys_event_queue_try_push(queue, (void *)evt) == false) {
-    sys_free((void *)evt); // Free the payload if it cannot be pushed
+    // Free the payload if it cannot be pushed
+    sys_event_pool_free(&_app_event_pool, evt);
   }
 }
 
@@ -112,7 +130,7 @@ void _app_hw_poll_callback(sys_timer_t *timer) {
   }
 
   // Create a app_event_t for the GPIO event
-  app_event_t *evt = sys_malloc(sizeof(app_event_t));
+  app_event_t *evt = sys_event_pool_alloc(&_app_event_pool);
   if (evt == NULL) {
     return;
   } else {
@@ -122,7 +140,8 @@ void _app_hw_poll_callback(sys_timer_t *timer) {
 
   // Try and push it into the queue
   if (sys_event_queue_try_push(queue, (void *)evt) == false) {
-    sys_free((void *)evt); // Free the payload if it cannot be pushed
+    // Free the payload if it cannot be pushed
+    sys_event_pool_free(&_app_event_pool, evt);
   }
 }
 
@@ -141,7 +160,7 @@ void _app_net_poll_callback(sys_timer_t *timer) {
   }
 
   // Create a app_event_t for the GPIO event
-  app_event_t *evt = sys_malloc(sizeof(app_event_t));
+  app_event_t *evt = sys_event_pool_alloc(&_app_event_pool);
   if (evt == NULL) {
     return;
   } else {
@@ -151,7 +170,8 @@ void _app_net_poll_callback(sys_timer_t *timer) {
 
   // Try and push it into the queue
   if (sys_event_queue_try_push(queue, (void *)evt) == false) {
-    sys_free((void *)evt); // Free the payload if it cannot be pushed
+    // Free the payload if it cannot be pushed
+    sys_event_pool_free(&_app_event_pool, evt);
   }
 }
 
@@ -193,10 +213,18 @@ void _app_power_callback(hw_power_t *power, hw_power_flag_t flags,
   objc_assert(sys_event_queue_valid(&_app_queue) == false);
   _app_queue = sys_event_queue_init(capacity);
 
+  // Create a pool for the event payloads, with a slot for each event in the
+  // queue
+  if (sys_event_pool_valid(&_app_event_pool) == false) {
+    _app_event_pool = sys_event_pool_init(sizeof(app_event_t),
+                                          capacity + NSAPPLICATION_EVENT_SPARE);
+  }
+
   // Initialize properties
   _delegate = nil;
   _run = NO;
   _exitstatus = 0;
+  _scratch = [NXZone scratchZoneWithSize:NSAPPLICATION_SCRATCH_SIZE];
 
   // Set the GPIO callback for the application, with the application instance
   // as userdata
@@ -231,6 +259,7 @@ void _app_power_callback(hw_power_t *power, hw_power_flag_t flags,
 
   // Release retained resources (delegates are not retained)
   [_args release];
+  [_scratch release];
 
   // Finalize the event queue
   sys_event_queue_finalize(&_app_queue);
@@ -238,6 +267,7 @@ void _app_power_callback(hw_power_t *power, hw_power_flag_t flags,
   // Clear the properties
   _delegate = nil;
   _args = nil;
+  _scratch = nil;
 
   // Call superclass release
   [super release];
@@ -260,6 +290,13 @@ void _app_power_callback(hw_power_t *power, hw_power_flag_t flags,
   _delegate = delegate;
 }
 
+/**
+ * @brief Returns the scratch zone for the run loop.
+ */
+- (NXZone *)scratchZone {
+  return _scratch;
+}
+
 /**
  * @brief Sets command-line arguments passed to the application.
  */
@@ -314,9 +351,6 @@ void _app_power_callback(hw_power_t *power, hw_power_flag_t flags,
       _run = YES; // Set the run flag to true
     }
 
-    // TODO: Drain the autorelease pool occasionally
-    // In our semantics, we likely have one pool which is used across threads
-
     // Get an event from the queue
     // The queue might be invalid, as it's been shutdown
     app_event_t *app_event = sys_event_queue_pop(&_app_queue);
@@ -363,13 +397,16 @@ void _app_power_callback(hw_power_t *power, hw_power_flag_t flags,
       break;
     }
 
-    // Free the allocated event - release it
-    sys_free(app_event);
+    // Return the event to the pool
+    sys_event_pool_free(&_app_event_pool, app_event);
 
-    // Drain the autorelease pool
-    // TODO: Only do this on the main thread, and maybe less often than once
-    // per loop iteration
+    // Drain the autorelease pool for the run loop thread
+    // TODO: Maybe do this less often than once per loop iteration
     [[NXAutoreleasePool currentPool] drain];
+
+    // Recycle the objects allocated in the scratch zone, which were released
+    // by the drain
+    [_scratch reset];
   }
 
   // Reset the flags
@@ -35,7 +35,8 @@
   }
 
   // Allocate memory for the array data
-  _data = sys_malloc(capacity * sizeof(void *));
+  objc_assert(_zone);
+  _data = [_zone allocWithSize:capacity * sizeof(void *)];
   if (_data == 0) {
     [self release];
     self = nil;
@@ -84,7 +85,8 @@
   }
 
   // Allocate memory for the objects
-  _data = sys_malloc(objectCount * sizeof(void *));
+  objc_assert(_zone);
+  _data = [_zone allocWithSize:objectCount * sizeof(void *)];
   if (_data == NULL) {
     [self release];
     return nil;
@@ -133,7 +135,7 @@
       }
     }
     // Free the array data
-    sys_free(_data);
+    [_zone free:_data];
   }
 
   [super dealloc];
@@ -186,19 +188,15 @@
     return NO;
   }
 
-  // Allocate new memory for the larger or smaller capacity
-  void **data = sys_malloc(cap * sizeof(void *));
-  if (data == NULL) {
+  // Resize the memory for the larger or smaller capacity, which grows in
+  // place when there is free space after it
+  objc_assert(_zone);
+  void **data = [_zone reallocWithPtr:_data size:cap * sizeof(void *)];
+  if (data == NULL && cap > 0) {
     // Allocation failed
     return NO;
   }
 
-  // Copy existing data to the new array, release old data
-  if (_data != NULL) {
-    sys_memcpy(data, _data, _length * sizeof(void *));
-    sys_free(_data);
-  }
-
   // Set the new data pointer and capacity
   _data = data;
   _cap = cap;
@@ -256,9 +254,16 @@
  * @brief Return the JSON string representation of the array.
  */
 - (NXString *)JSONString {
-  NXString *json = [NXString stringWithCapacity:[self JSONBytes] + 1];
+  return [NXJSONWriter stringWithObject:self];
+}
 
-  [json appendCString:"["];
+/**
+ * @brief Write the elements of the array as JSON, separated by commas.
+ */
+- (BOOL)writeJSON:(NXJSONWriter *)writer {
+  if ([writer writeBytes:"[" length:1] == NO) {
+    return NO;
+  }
 
   BOOL firstElement = YES;
   size_t i = 0;
@@ -271,22 +276,19 @@
     }
 
     // Add comma if not the first element
-    if (!firstElement) {
-      [json appendCString:", "];
+    if (!firstElement && [writer writeBytes:", " length:2] == NO) {
+      return NO;
     }
     firstElement = NO;
 
-    // If object does not conform to JSONProtocol, use the description
-    if (![object conformsTo:@protocol(JSONProtocol)]) {
-      object = [object description];
+    // Write the element, which uses the description for objects which do not
+    // conform to JSONProtocol
+    if ([writer writeObject:object] == NO) {
+      return NO;
     }
-
-    // Perform the append
-    [json append:[object JSONString]];
   }
 
-  [json appendCString:"]"];
-  return json;
+  return [writer writeBytes:"]" length:1];
 }
 
 /**
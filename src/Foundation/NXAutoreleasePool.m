@@ -1,8 +1,58 @@
 #include <Foundation/Foundation.h>
 #include <runtime-sys/sys.h>
 
-// Define the current autorelease pool class
-static id defaultPool = nil;
+// Number of objects in each page of an autorelease pool
+#ifdef SYSTEM_NAME_PICO
+#define AUTORELEASE_PAGE_OBJECTS 30
+#else
+#define AUTORELEASE_PAGE_OBJECTS 254
+#endif
+
+/*
+ * A page of objects in an autorelease pool. Objects are added to the
+ * newest page, and when it is full a new page is linked in front of it.
+ */
+struct objc_autorelease_page {
+  struct objc_autorelease_page *prev; // Previous page, or NULL if first
+  size_t count;                       // Number of objects in the page
+  id objects[AUTORELEASE_PAGE_OBJECTS];
+};
+
+#ifdef SYSTEM_NAME_PICO
+// Thread-local variables are not separate for each core on the Pico, since
+// the thread pointer is not set up for each core. Each core runs a single
+// thread, so the current pool is kept for each core.
+#define AUTORELEASE_MAX_CORES 2
+static id currentPools[AUTORELEASE_MAX_CORES] = {nil};
+#else
+// The current autorelease pool for the calling thread
+static __thread id currentPool = nil;
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE METHODS
+
+/*
+ * Return the current autorelease pool for the calling thread.
+ */
+static inline id _pool_get_current(void) {
+#ifdef SYSTEM_NAME_PICO
+  return currentPools[sys_thread_core() % AUTORELEASE_MAX_CORES];
+#else
+  return currentPool;
+#endif
+}
+
+/*
+ * Set the current autorelease pool for the calling thread.
+ */
+static inline void _pool_set_current(id pool) {
+#ifdef SYSTEM_NAME_PICO
+  currentPools[sys_thread_core() % AUTORELEASE_MAX_CORES] = pool;
+#else
+  currentPool = pool;
+#endif
+}
 
 @implementation NXAutoreleasePool
 
@@ -15,28 +65,28 @@ static id defaultPool = nil;
     return nil;
   }
 
-  @synchronized([self class]) {
-    // Set the previous pool to the current default pool
-    _prev = defaultPool;
-
-    // Initialize the tail to nil
-    _tail = nil;
-
-    // Set the current pool as the new default pool
-    defaultPool = self;
-  }
+  // Push the pool onto the stack of pools for the calling thread. The first
+  // page is allocated when the first object is added.
+  _prev = _pool_get_current();
+  _page = NULL;
+  _pool_set_current(self);
 
   // Return success
   return self;
 }
 
 - (void)dealloc {
-  // Drain the pool before deallocating
+  // Drain the pool before deallocating, and free the first page which is
+  // kept by the drain
   [self drain];
+  if (_page != NULL) {
+    [_zone free:_page];
+    _page = NULL;
+  }
 
-  @synchronized([self class]) {
-    // Reset the default pool to the previous one
-    defaultPool = _prev;
+  // Pop the pool from the stack of pools for the calling thread
+  if (_pool_get_current() == self) {
+    _pool_set_current(_prev);
   }
 
   // Call superclass dealloc
@@ -47,10 +97,7 @@ static id defaultPool = nil;
 // CLASS METHODS
 
 + (id)currentPool {
-  @synchronized(self) {
-    // Return the current autorelease pool
-    return defaultPool;
-  }
+  return _pool_get_current();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -67,41 +114,49 @@ static id defaultPool = nil;
     return;
   }
 
-  @synchronized(self) {
-    // If object already added to a pool, panic
-    if (((NXObject *)object)->_next != nil) {
-      sys_panicf("Object already added to an autorelease pool: %s",
-                 object_getClassName(object));
-      return;
-    }
 #ifdef DEBUG
-    NXLog(@"  autorelease retain: [%s] @%p", object_getClassName(object),
-          object);
+  NXLog(@"  autorelease retain: [%s] @%p", object_getClassName(object),
+        object);
 #endif
-    ((NXObject *)object)->_next =
-        _tail;      // Link the new object to the current tail
-    _tail = object; // Update the tail to the new object
+  // Add a new page when there is no page, or the current page is full
+  struct objc_autorelease_page *page = _page;
+  if (page == NULL || page->count == AUTORELEASE_PAGE_OBJECTS) {
+    struct objc_autorelease_page *next =
+        [_zone allocWithSize:sizeof(struct objc_autorelease_page)];
+    if (next == NULL) {
+      sys_panicf("[NXAutoreleasePool addObject] failed to allocate page");
+      return;
+    }
+    next->prev = page;
+    next->count = 0;
+    _page = page = next;
   }
+
+  // Store the object in the next slot of the page
+  page->objects[page->count++] = object;
 }
 
 - (void)drain {
-  @synchronized(self) {
-    // Release all objects in the current pool, from tail to head
-    id cur = _tail;
-    while (cur != nil) {
-      id next = ((NXObject *)cur)->_next; // Save next pointer before release
+  // Release objects from the newest to the oldest. Each object is removed
+  // from the pool before it is released, so objects which are autoreleased
+  // while draining are also released.
+  while (YES) {
+    struct objc_autorelease_page *page = _page;
+    while (page != NULL && page->count == 0 && page->prev != NULL) {
+      // Free empty pages, except the first page which is kept for reuse
+      _page = page->prev;
+      [_zone free:page];
+      page = _page;
+    }
+    if (page == NULL || page->count == 0) {
+      break;
+    }
+    id object = page->objects[--page->count];
 #ifdef DEBUG
-      NXLog(@"  autorelease release: [%s] @%p", object_getClassName(cur), cur);
+    NXLog(@"  autorelease release: [%s] @%p", object_getClassName(object),
+          object);
 #endif
-      // Clear the _next pointer before releasing
-      ((NXObject *)cur)->_next = nil;
-      [((NXObject *)cur) release]; // Release the current object
-
-      cur = next; // Move to the next object
-    }
-
-    // Clear the tail pointer
-    _tail = nil;
+    [((NXObject *)object) release];
   }
 }
 
@@ -29,7 +29,8 @@
   }
 
   // Allocate memory for the data
-  _data = sys_malloc(capacity);
+  objc_assert(_zone);
+  _data = [_zone allocWithSize:capacity];
   if (_data == NULL) {
     [self release];
     return nil;
@@ -102,7 +103,9 @@
  * @brief Deallocates the NXData instance and frees allocated memory.
  */
 - (void)dealloc {
-  sys_free(_data);
+  if (_data != NULL) {
+    [_zone free:_data];
+  }
   [super dealloc];
 }
 
@@ -149,25 +152,20 @@
 
   // If capacity is zero, we don't need to allocate anything
   if (capacity == 0) {
-    sys_free(_data); // Free existing data if any
+    [_zone free:_data]; // Free existing data if any
     _data = NULL;
     _cap = 0;
     _size = 0;  // Reset size to zero
     return YES; // Successfully set capacity to zero
   }
 
-  // Allocate new memory for the data
-  void *data = sys_malloc(capacity);
+  // Resize the data, which grows in place when there is free space after it
+  objc_assert(_zone);
+  void *data = [_zone reallocWithPtr:_data size:capacity];
   if (data == NULL) {
     return NO; // Memory allocation failed
   }
 
-  // Copy existing data to the new buffer, if any
-  if (_data != NULL) {
-    sys_memcpy(data, _data, _size);
-    sys_free(_data); // Free old data buffer
-  }
-
   // Update the instance variables
   _data = data;
   _cap = capacity;
@@ -176,6 +174,13 @@
   return YES;
 }
 
+- (BOOL)_growCapacity:(size_t)size {
+  // Grow the capacity by at least 1.5x, so that repeated appends are
+  // amortized
+  size_t capacity = _cap + (_cap >> 1);
+  return [self _setCapacity:size > capacity ? size : capacity];
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // PUBLIC METHODS
 
@@ -397,7 +402,7 @@
 
   // Increase the capacity if needed
   if (_size + length > _cap) {
-    if ([self _setCapacity:_cap + length] == NO) {
+    if ([self _growCapacity:_size + length] == NO) {
       return NO; // Failed to set new capacity
     }
   }
@@ -424,7 +429,7 @@
 
   // Increase the capacity if needed
   if (_size + size > _cap) {
-    if ([self _setCapacity:_cap + size] == NO) {
+    if ([self _growCapacity:_size + size] == NO) {
       return NO; // Failed to set new capacity
     }
   }
@@ -451,7 +456,7 @@
 
   // Increase the capacity if needed
   if (_size + size > _cap) {
-    if ([self _setCapacity:_cap + size] == NO) {
+    if ([self _growCapacity:_size + size] == NO) {
       return NO; // Failed to set new capacity
     }
   }
@@ -504,4 +509,15 @@
   return [self base64String];
 }
 
+/**
+ * @brief Write the base64 encoded data as JSON.
+ */
+- (BOOL)writeJSON:(NXJSONWriter *)writer {
+  NXString *base64 = [self base64String];
+  if (base64 == nil) {
+    return NO;
+  }
+  return [writer writeCString:[base64 cStr]];
+}
+
 @end
@@ -126,6 +126,22 @@
                                  _month, _day, _hours, _minutes, _seconds];
 }
 
+/**
+ * @brief Write the date as a quoted JSON string, formatted on the stack.
+ */
+- (BOOL)writeJSON:(NXJSONWriter *)writer {
+  BOOL cacheSuccess = [self _cacheComponents];
+  objc_assert(cacheSuccess); // Ensure components are cached
+  char buf[24];
+  size_t length =
+      sys_sprintf(buf, sizeof(buf), "\"%04d-%02d-%02dT%02d:%02d:%02dZ\"",
+                  _year, _month, _day, _hours, _minutes, _seconds);
+  if (length >= sizeof(buf)) {
+    return NO;
+  }
+  return [writer writeBytes:buf length:length];
+}
+
 /**
  * @brief Returns the appropriate JSON length for the instance.
  */
@@ -0,0 +1,690 @@
+#include "NXJSON+parser.h"
+#include <objc/objc.h>
+#include <runtime-sys/sys.h>
+#include <stdint.h>
+
+///////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS
+
+/**
+ * @brief Initial size of the buffer for tokens, in bytes.
+ */
+#define OBJC_JSON_BUFFER_SIZE 64
+
+///////////////////////////////////////////////////////////////////////////////
+// TYPES
+
+/**
+ * @brief What the parser expects next.
+ */
+enum objc_json_state {
+  objc_json_state_value,        // A value
+  objc_json_state_array_first,  // A value or the end of an empty array
+  objc_json_state_object_first, // A key or the end of an empty object
+  objc_json_state_key,          // A key
+  objc_json_state_colon,        // The colon after a key
+  objc_json_state_next,         // A comma or the end of the array or object
+  objc_json_state_done,         // Nothing except whitespace
+};
+
+/**
+ * @brief The token which is being read.
+ */
+enum objc_json_token {
+  objc_json_token_none,    // Between tokens
+  objc_json_token_string,  // A string or key
+  objc_json_token_number,  // A number
+  objc_json_token_literal, // true, false or null
+};
+
+/**
+ * @brief The escape sequence which is being read in a string.
+ */
+enum objc_json_escape {
+  objc_json_escape_none,      // Not in an escape sequence
+  objc_json_escape_backslash, // After a backslash
+  objc_json_escape_unicode,   // Reading the hex digits of a \u sequence
+};
+
+/**
+ * @brief Represents the state of an incremental JSON parser.
+ */
+struct objc_json_parser {
+  objc_json_callback_t callback;   // Receives the events
+  void *context;                   // Passed to the callback
+  BOOL inplace;                    // Strings are unescaped in the input
+  uint8_t state;                   // What the parser expects next
+  uint8_t token;                   // The token which is being read
+  uint8_t escape;                  // The escape sequence in a string
+  BOOL key;                        // The string is an object key
+  uint8_t digits;                  // Number of hex digits read
+  uint16_t code;                   // Code unit of a \u sequence
+  uint16_t high;                   // High surrogate, waiting for the low one
+  size_t depth;                    // Number of open arrays and objects
+  char stack[OBJC_JSON_MAX_DEPTH]; // '[' or '{' for each open container
+  char *buf;                       // Tokens which are not parsed in place
+  size_t len;                      // Number of bytes in the buffer
+  size_t cap;                      // Capacity of the buffer
+  char *start;                     // Start of a string parsed in place
+  char *out;                       // End of a string unescaped in place
+  char *base;                      // Start of the current chunk
+  size_t offset;                   // Offset of the current chunk in the input
+  const char *error;               // Reason for the failure, or NULL
+  size_t error_offset;             // Offset of the failure in the input
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE METHODS
+
+/**
+ * @brief Record the reason the parser failed, and return NULL.
+ */
+static char *objc_json_fail(objc_json_parser_t *parser, const char *reason,
+                            const char *ptr) {
+  if (parser->error == NULL) {
+    parser->error = reason;
+    parser->error_offset = parser->offset + (size_t)(ptr - parser->base);
+  }
+  return NULL;
+}
+
+/**
+ * @brief Pass an event to the callback.
+ */
+static BOOL objc_json_emit(objc_json_parser_t *parser, objc_json_event_t event,
+                           char *bytes, size_t length, const char *ptr) {
+  if (parser->callback(parser->context, event, bytes, length) == NO) {
+    objc_json_fail(parser, "stopped by callback", ptr);
+    return NO;
+  }
+  return YES;
+}
+
+/**
+ * @brief Append bytes to the token buffer, keeping space for a null
+ * terminator.
+ */
+static BOOL objc_json_buffer(objc_json_parser_t *parser, const char *bytes,
+                             size_t length) {
+  if (parser->len + length + 1 > parser->cap) {
+    size_t cap = parser->cap ? parser->cap * 2 : OBJC_JSON_BUFFER_SIZE;
+    while (cap < parser->len + length + 1) {
+      cap *= 2;
+    }
+    char *buf = sys_malloc(cap);
+    if (buf == NULL) {
+      return NO;
+    }
+    if (parser->len > 0) {
+      sys_memcpy(buf, parser->buf, parser->len);
+    }
+    sys_free(parser->buf);
+    parser->buf = buf;
+    parser->cap = cap;
+  }
+  sys_memcpy(parser->buf + parser->len, bytes, length);
+  parser->len += length;
+  return YES;
+}
+
+/**
+ * @brief Append unescaped bytes to a string, either in place or in the token
+ * buffer.
+ */
+static BOOL objc_json_put(objc_json_parser_t *parser, const char *bytes,
+                          size_t length) {
+  if (parser->inplace) {
+    // The unescaped string is never longer than the input, so it is moved
+    // backwards over bytes which have already been read
+    if (parser->out != bytes) {
+      sys_memmove(parser->out, bytes, length);
+    }
+    parser->out += length;
+    return YES;
+  }
+  return objc_json_buffer(parser, bytes, length);
+}
+
+/**
+ * @brief Append a code point as UTF-8.
+ */
+static BOOL objc_json_put_utf8(objc_json_parser_t *parser, uint32_t code) {
+  char utf8[4];
+  size_t length;
+  if (code < 0x80) {
+    utf8[0] = (char)code;
+    length = 1;
+  } else if (code < 0x800) {
+    utf8[0] = (char)(0xC0 | (code >> 6));
+    utf8[1] = (char)(0x80 | (code & 0x3F));
+    length = 2;
+  } else if (code < 0x10000) {
+    utf8[0] = (char)(0xE0 | (code >> 12));
+    utf8[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+    utf8[2] = (char)(0x80 | (code & 0x3F));
+    length = 3;
+  } else {
+    utf8[0] = (char)(0xF0 | (code >> 18));
+    utf8[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+    utf8[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+    utf8[3] = (char)(0x80 | (code & 0x3F));
+    length = 4;
+  }
+  return objc_json_put(parser, utf8, length);
+}
+
+/**
+ * @brief Update the state after a value.
+ */
+static inline void objc_json_after_value(objc_json_parser_t *parser) {
+  parser->state =
+      parser->depth == 0 ? objc_json_state_done : objc_json_state_next;
+}
+
+/**
+ * @brief Return YES if a value can start in the current state.
+ */
+static inline BOOL objc_json_value_allowed(objc_json_parser_t *parser) {
+  return parser->state == objc_json_state_value ||
+         parser->state == objc_json_state_array_first;
+}
+
+/**
+ * @brief Return YES if a byte is whitespace between tokens.
+ */
+static inline BOOL objc_json_is_space(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/**
+ * @brief Return YES if a byte can be part of a number.
+ */
+static inline BOOL objc_json_is_number(char c) {
+  return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' ||
+         c == 'e' || c == 'E';
+}
+
+/**
+ * @brief Return YES if text is a number in JSON syntax.
+ */
+static BOOL objc_json_valid_number(const char *ptr, const char *end) {
+  if (ptr < end && *ptr == '-') {
+    ptr++;
+  }
+  // Integer part, without leading zeros
+  if (ptr == end || *ptr < '0' || *ptr > '9') {
+    return NO;
+  }
+  if (*ptr++ != '0') {
+    while (ptr < end && *ptr >= '0' && *ptr <= '9') {
+      ptr++;
+    }
+  }
+  // Fraction
+  if (ptr < end && *ptr == '.') {
+    ptr++;
+    if (ptr == end || *ptr < '0' || *ptr > '9') {
+      return NO;
+    }
+    while (ptr < end && *ptr >= '0' && *ptr <= '9') {
+      ptr++;
+    }
+  }
+  // Exponent
+  if (ptr < end && (*ptr == 'e' || *ptr == 'E')) {
+    ptr++;
+    if (ptr < end && (*ptr == '+' || *ptr == '-')) {
+      ptr++;
+    }
+    if (ptr == end || *ptr < '0' || *ptr > '9') {
+      return NO;
+    }
+    while (ptr < end && *ptr >= '0' && *ptr <= '9') {
+      ptr++;
+    }
+  }
+  return ptr == end ? YES : NO;
+}
+
+/**
+ * @brief Complete a number or literal in the token buffer.
+ */
+static BOOL objc_json_end_token(objc_json_parser_t *parser, const char *ptr) {
+  const char *text = parser->buf;
+  size_t len = parser->len;
+  objc_json_event_t event;
+  if (parser->token == objc_json_token_number) {
+    if (objc_json_valid_number(text, text + len) == NO) {
+      objc_json_fail(parser, "invalid number", ptr);
+      return NO;
+    }
+    event = objc_json_number;
+  } else if (len == 4 && sys_memcmp(text, "true", 4) == 0) {
+    event = objc_json_true;
+  } else if (len == 5 && sys_memcmp(text, "false", 5) == 0) {
+    event = objc_json_false;
+  } else if (len == 4 && sys_memcmp(text, "null", 4) == 0) {
+    event = objc_json_null;
+  } else {
+    objc_json_fail(parser, "invalid literal", ptr);
+    return NO;
+  }
+  parser->token = objc_json_token_none;
+  parser->buf[len] = '\0';
+  if (objc_json_emit(parser, event,
+                     event == objc_json_number ? parser->buf : NULL,
+                     event == objc_json_number ? len : 0, ptr) == NO) {
+    return NO;
+  }
+  objc_json_after_value(parser);
+  return YES;
+}
+
+/**
+ * @brief Complete a string or key.
+ */
+static BOOL objc_json_end_string(objc_json_parser_t *parser, const char *ptr) {
+  char *bytes;
+  size_t length;
+  if (parser->inplace) {
+    bytes = parser->start;
+    length = (size_t)(parser->out - parser->start);
+  } else {
+    // Make sure there is a buffer for the null terminator of an empty string
+    if (objc_json_buffer(parser, "", 0) == NO) {
+      objc_json_fail(parser, "out of memory", ptr);
+      return NO;
+    }
+    bytes = parser->buf;
+    length = parser->len;
+  }
+  bytes[length] = '\0';
+  parser->token = objc_json_token_none;
+  if (parser->key) {
+    parser->state = objc_json_state_colon;
+    return objc_json_emit(parser, objc_json_key, bytes, length, ptr);
+  }
+  if (objc_json_emit(parser, objc_json_string, bytes, length, ptr) == NO) {
+    return NO;
+  }
+  objc_json_after_value(parser);
+  return YES;
+}
+
+/**
+ * @brief Read the characters of a string, and return the pointer after the
+ * bytes which were read, or NULL on error.
+ */
+static char *objc_json_read_string(objc_json_parser_t *parser, char *ptr,
+                                   char *end) {
+  while (ptr < end) {
+    unsigned char c;
+    switch (parser->escape) {
+    case objc_json_escape_none: {
+      // A high surrogate must be followed by an escaped low surrogate
+      if (parser->high != 0 && *ptr != '\\') {
+        return objc_json_fail(parser, "unpaired surrogate", ptr);
+      }
+
+      // Copy each run of bytes which are not escaped at once
+      char *run = ptr;
+      while (ptr < end) {
+        c = (unsigned char)*ptr;
+        if (c == '"' || c == '\\' || c < 0x20) {
+          break;
+        }
+        ptr++;
+      }
+      if (ptr > run && objc_json_put(parser, run, ptr - run) == NO) {
+        return objc_json_fail(parser, "out of memory", ptr);
+      }
+      if (ptr == end) {
+        return ptr;
+      }
+      c = (unsigned char)*ptr;
+      if (c == '"') {
+        return objc_json_end_string(parser, ptr) ? ptr + 1 : NULL;
+      }
+      if (c < 0x20) {
+        return objc_json_fail(parser, "control character in string", ptr);
+      }
+      parser->escape = objc_json_escape_backslash;
+      ptr++;
+      break;
+    }
+    case objc_json_escape_backslash: {
+      char ch;
+      c = (unsigned char)*ptr;
+      switch (c) {
+      case '"':
+      case '\\':
+      case '/':
+        ch = (char)c;
+        break;
+      case 'b':
+        ch = '\b';
+        break;
+      case 'f':
+        ch = '\f';
+        break;
+      case 'n':
+        ch = '\n';
+        break;
+      case 'r':
+        ch = '\r';
+        break;
+      case 't':
+        ch = '\t';
+        break;
+      case 'u':
+        parser->escape = objc_json_escape_unicode;
+        parser->code = 0;
+        parser->digits = 0;
+        ptr++;
+        continue;
+      default:
+        return objc_json_fail(parser, "invalid escape", ptr);
+      }
+      if (parser->high != 0) {
+        return objc_json_fail(parser, "unpaired surrogate", ptr);
+      }
+      if (objc_json_put(parser, &ch, 1) == NO) {
+        return objc_json_fail(parser, "out of memory", ptr);
+      }
+      parser->escape = objc_json_escape_none;
+      ptr++;
+      break;
+    }
+    case objc_json_escape_unicode: {
+      c = (unsigned char)*ptr;
+      uint16_t digit;
+      if (c >= '0' && c <= '9') {
+        digit = c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        digit = c - 'a' + 10;
+      } else if (c >= 'A' && c <= 'F') {
+        digit = c - 'A' + 10;
+      } else {
+        return objc_json_fail(parser, "invalid unicode escape", ptr);
+      }
+      ptr++;
+      parser->code = (uint16_t)(parser->code << 4) | digit;
+      if (++parser->digits < 4) {
+        break;
+      }
+
+      // Combine surrogate pairs into one code point
+      uint32_t code = parser->code;
+      parser->escape = objc_json_escape_none;
+      if (parser->high != 0) {
+        if (code < 0xDC00 || code > 0xDFFF) {
+          return objc_json_fail(parser, "unpaired surrogate", ptr);
+        }
+        code = 0x10000 + (((uint32_t)parser->high - 0xD800) << 10) +
+               (code - 0xDC00);
+        parser->high = 0;
+      } else if (code >= 0xD800 && code <= 0xDBFF) {
+        parser->high = (uint16_t)code;
+        break;
+      } else if (code >= 0xDC00 && code <= 0xDFFF) {
+        return objc_json_fail(parser, "unpaired surrogate", ptr);
+      }
+      if (objc_json_put_utf8(parser, code) == NO) {
+        return objc_json_fail(parser, "out of memory", ptr);
+      }
+      break;
+    }
+    }
+  }
+  return ptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// LIFECYCLE
+
+/**
+ * @brief Create a parser.
+ */
+objc_json_parser_t *objc_json_parser_new(objc_json_callback_t callback,
+                                         void *context, BOOL inplace) {
+  objc_assert(callback);
+  objc_json_parser_t *parser = sys_malloc(sizeof(objc_json_parser_t));
+  if (parser == NULL) {
+    return NULL;
+  }
+  sys_memset(parser, 0, sizeof(objc_json_parser_t));
+  parser->callback = callback;
+  parser->context = context;
+  parser->inplace = inplace;
+  objc_json_parser_reset(parser);
+  return parser;
+}
+
+/**
+ * @brief Free a parser.
+ */
+void objc_json_parser_delete(objc_json_parser_t *parser) {
+  objc_assert(parser);
+  sys_free(parser->buf);
+  sys_free(parser);
+}
+
+/**
+ * @brief Reset a parser, so that it can parse another value.
+ */
+void objc_json_parser_reset(objc_json_parser_t *parser) {
+  objc_assert(parser);
+  parser->state = objc_json_state_value;
+  parser->token = objc_json_token_none;
+  parser->escape = objc_json_escape_none;
+  parser->high = 0;
+  parser->depth = 0;
+  parser->len = 0;
+  parser->offset = 0;
+  parser->error = NULL;
+  parser->error_offset = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PUBLIC METHODS
+
+/**
+ * @brief Parse a chunk of input.
+ */
+BOOL objc_json_parser_parse(objc_json_parser_t *parser, char *bytes,
+                            size_t length) {
+  objc_assert(parser);
+  objc_assert(bytes || length == 0);
+  if (parser->error != NULL) {
+    return NO;
+  }
+
+  char *ptr = bytes;
+  char *end = bytes + length;
+  parser->base = bytes;
+  while (ptr < end) {
+    // Continue the current token
+    switch (parser->token) {
+    case objc_json_token_string:
+      ptr = objc_json_read_string(parser, ptr, end);
+      if (ptr == NULL) {
+        return NO;
+      }
+      continue;
+    case objc_json_token_number:
+    case objc_json_token_literal: {
+      char *run = ptr;
+      if (parser->token == objc_json_token_number) {
+        while (ptr < end && objc_json_is_number(*ptr)) {
+          ptr++;
+        }
+      } else {
+        while (ptr < end && *ptr >= 'a' && *ptr <= 'z') {
+          ptr++;
+        }
+      }
+      if (ptr > run && objc_json_buffer(parser, run, ptr - run) == NO) {
+        objc_json_fail(parser, "out of memory", ptr);
+        return NO;
+      }
+      if (ptr < end && objc_json_end_token(parser, ptr) == NO) {
+        return NO;
+      }
+      continue;
+    }
+    default:
+      break;
+    }
+
+    // Skip whitespace, and start the next token
+    char c = *ptr;
+    if (objc_json_is_space(c)) {
+      ptr++;
+      continue;
+    }
+    if (parser->state == objc_json_state_done) {
+      objc_json_fail(parser, "unexpected data after value", ptr);
+      return NO;
+    }
+    switch (c) {
+    case '"':
+      if (parser->state == objc_json_state_object_first ||
+          parser->state == objc_json_state_key) {
+        parser->key = YES;
+      } else if (objc_json_value_allowed(parser)) {
+        parser->key = NO;
+      } else {
+        objc_json_fail(parser, "unexpected string", ptr);
+        return NO;
+      }
+      parser->token = objc_json_token_string;
+      parser->escape = objc_json_escape_none;
+      parser->len = 0;
+      parser->start = parser->out = ++ptr;
+      continue;
+    case '{':
+    case '[':
+      if (objc_json_value_allowed(parser) == NO) {
+        objc_json_fail(parser, "unexpected container", ptr);
+        return NO;
+      }
+      if (parser->depth == OBJC_JSON_MAX_DEPTH) {
+        objc_json_fail(parser, "nested too deeply", ptr);
+        return NO;
+      }
+      parser->stack[parser->depth++] = c;
+      parser->state = c == '{' ? objc_json_state_object_first
+                               : objc_json_state_array_first;
+      if (objc_json_emit(parser,
+                         c == '{' ? objc_json_object_start
+                                  : objc_json_array_start,
+                         NULL, 0, ptr) == NO) {
+        return NO;
+      }
+      ptr++;
+      continue;
+    case '}':
+    case ']': {
+      char open = c == '}' ? '{' : '[';
+      uint8_t first = c == '}' ? objc_json_state_object_first
+                               : objc_json_state_array_first;
+      if (parser->state != first &&
+          (parser->state != objc_json_state_next || parser->depth == 0 ||
+           parser->stack[parser->depth - 1] != open)) {
+        objc_json_fail(parser, "unexpected end of container", ptr);
+        return NO;
+      }
+      parser->depth--;
+      if (objc_json_emit(parser,
+                         c == '}' ? objc_json_object_end
+                                  : objc_json_array_end,
+                         NULL, 0, ptr) == NO) {
+        return NO;
+      }
+      objc_json_after_value(parser);
+      ptr++;
+      continue;
+    }
+    case ':':
+      if (parser->state != objc_json_state_colon) {
+        objc_json_fail(parser, "unexpected colon", ptr);
+        return NO;
+      }
+      parser->state = objc_json_state_value;
+      ptr++;
+      continue;
+    case ',':
+      if (parser->state != objc_json_state_next) {
+        objc_json_fail(parser, "unexpected comma", ptr);
+        return NO;
+      }
+      parser->state = parser->stack[parser->depth - 1] == '{'
+                          ? objc_json_state_key
+                          : objc_json_state_value;
+      ptr++;
+      continue;
+    default:
+      if (objc_json_value_allowed(parser) == NO) {
+        objc_json_fail(parser, "unexpected character", ptr);
+        return NO;
+      }
+      if (c == '-' || (c >= '0' && c <= '9')) {
+        parser->token = objc_json_token_number;
+      } else if (c >= 'a' && c <= 'z') {
+        parser->token = objc_json_token_literal;
+      } else {
+        objc_json_fail(parser, "unexpected character", ptr);
+        return NO;
+      }
+      parser->len = 0;
+      continue;
+    }
+  }
+
+  parser->offset += length;
+  return YES;
+}
+
+/**
+ * @brief Complete parsing at the end of the input.
+ */
+BOOL objc_json_parser_finish(objc_json_parser_t *parser) {
+  objc_assert(parser);
+  if (parser->error != NULL) {
+    return NO;
+  }
+
+  // The offset of the chunk has been advanced, so errors are reported at
+  // the end of the input
+  char *end = parser->base;
+  switch (parser->token) {
+  case objc_json_token_string:
+    objc_json_fail(parser, "unterminated string", end);
+    return NO;
+  case objc_json_token_number:
+  case objc_json_token_literal:
+    if (objc_json_end_token(parser, end) == NO) {
+      return NO;
+    }
+    break;
+  default:
+    break;
+  }
+  if (parser->state != objc_json_state_done) {
+    objc_json_fail(parser, "unexpected end of input", end);
+    return NO;
+  }
+  return YES;
+}
+
+/**
+ * @brief Return the reason the parser failed.
+ */
+const char *objc_json_parser_error(objc_json_parser_t *parser,
+                                   size_t *offset) {
+  objc_assert(parser);
+  if (offset != NULL) {
+    *offset = parser->error_offset;
+  }
+  return parser->error;
+}
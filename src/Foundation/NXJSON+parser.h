@@ -0,0 +1,97 @@
+#pragma once
+#include <objc/objc.h>
+#include <stddef.h>
+
+/**
+ * @brief Maximum depth of nested arrays and objects.
+ */
+#define OBJC_JSON_MAX_DEPTH 64
+
+/**
+ * @brief Events which are passed to the callback of a parser.
+ */
+typedef enum {
+  objc_json_null,         // null
+  objc_json_true,         // true
+  objc_json_false,        // false
+  objc_json_number,       // A number, as text which is not null-terminated
+  objc_json_string,       // A string value, unescaped and null-terminated
+  objc_json_key,          // An object key, unescaped and null-terminated
+  objc_json_object_start, // Start of an object
+  objc_json_object_end,   // End of an object
+  objc_json_array_start,  // Start of an array
+  objc_json_array_end,    // End of an array
+} objc_json_event_t;
+
+/**
+ * @brief Callback which receives the events of a parser.
+ * @param context The context pointer passed to objc_json_parser_new().
+ * @param event The event.
+ * @param bytes For numbers, strings and keys, the bytes of the value, which
+ * are only valid during the callback unless the parser is in place.
+ * Otherwise NULL.
+ * @param length The number of bytes, not including a null terminator.
+ * @return YES to continue parsing, or NO to stop the parser with an error.
+ */
+typedef BOOL (*objc_json_callback_t)(void *context, objc_json_event_t event,
+                                     char *bytes, size_t length);
+
+/**
+ * @brief Represents the state of an incremental JSON parser.
+ */
+typedef struct objc_json_parser objc_json_parser_t;
+
+/**
+ * @brief Create a parser.
+ * @param callback The function which receives the events.
+ * @param context A pointer passed to the callback.
+ * @param inplace If YES, the input is parsed in one call and strings are
+ * unescaped and null-terminated in the input buffer, which is modified, so
+ * that the bytes passed to the callback for strings and keys point into the
+ * input. If NO, the input can be parsed in chunks of any size.
+ * @return Pointer to the parser, or NULL if it could not be allocated.
+ */
+objc_json_parser_t *objc_json_parser_new(objc_json_callback_t callback,
+                                         void *context, BOOL inplace);
+
+/**
+ * @brief Free a parser.
+ * @param parser Pointer to the parser.
+ */
+void objc_json_parser_delete(objc_json_parser_t *parser);
+
+/**
+ * @brief Reset a parser, so that it can parse another value.
+ * @param parser Pointer to the parser.
+ */
+void objc_json_parser_reset(objc_json_parser_t *parser);
+
+/**
+ * @brief Parse a chunk of input.
+ * @param parser Pointer to the parser.
+ * @param bytes The input, which is only modified if the parser is in place.
+ * @param length The number of bytes of input.
+ * @return YES on success, or NO if the input is not valid JSON or the
+ * callback stopped the parser.
+ *
+ * Tokens may be split across chunks. A parser which is in place must be
+ * passed the whole input in one call.
+ */
+BOOL objc_json_parser_parse(objc_json_parser_t *parser, char *bytes,
+                            size_t length);
+
+/**
+ * @brief Complete parsing at the end of the input.
+ * @param parser Pointer to the parser.
+ * @return YES if the input was one complete JSON value, or NO otherwise.
+ */
+BOOL objc_json_parser_finish(objc_json_parser_t *parser);
+
+/**
+ * @brief Return the reason the parser failed.
+ * @param parser Pointer to the parser.
+ * @param offset Pointer to a value updated with the offset of the error in
+ * the input, in bytes, or NULL.
+ * @return A description of the error, or NULL if the parser has not failed.
+ */
+const char *objc_json_parser_error(objc_json_parser_t *parser, size_t *offset);
@@ -0,0 +1,352 @@
+#include "NXJSON+parser.h"
+#include "NXString+Private.h"
+#include <Foundation/Foundation.h>
+#include <runtime-sys/sys.h>
+
+///////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS
+
+/*
+ * Initial capacity of a parsed map. Most objects have a few keys, and the
+ * map grows when it is full.
+ */
+#define NXJSON_MAP_CAPACITY 8
+
+@implementation NXJSON
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE METHODS
+
+/*
+ * Return a new string for a string value or key. The string references the
+ * input when parsing in place, or else is a copy.
+ */
+static id __objc_json_string(NXJSON *json, const char *bytes, size_t length) {
+  NXString *string = [NXString allocWithZone:json->_objectZone];
+  if (json->_nocopy) {
+    return [string initWithBytesNoCopy:bytes length:length];
+  } else {
+    return [string initWithBytes:bytes length:length];
+  }
+}
+
+/*
+ * Return a new number for an integer. A number with a fraction or exponent,
+ * or which does not fit in 64 bits, is returned as a string of its text.
+ */
+static id __objc_json_number(NXJSON *json, const char *bytes, size_t length) {
+  const char *ptr = bytes;
+  const char *end = bytes + length;
+  BOOL negative = NO;
+  if (ptr < end && *ptr == '-') {
+    negative = YES;
+    ptr++;
+  }
+  uint64_t value = 0;
+  for (; ptr < end; ptr++) {
+    if (*ptr < '0' || *ptr > '9') {
+      break;
+    }
+    unsigned int digit = (unsigned int)(*ptr - '0');
+    if (value > (UINT64_MAX - digit) / 10) {
+      break;
+    }
+    value = value * 10 + digit;
+  }
+  if (ptr == end) {
+    if (negative == NO && value > (uint64_t)INT64_MAX) {
+      return [[NXNumber numberWithUnsignedInt64:value] retain];
+    }
+    if (negative == NO) {
+      return [[NXNumber numberWithInt64:(int64_t)value] retain];
+    }
+    if (value <= (uint64_t)INT64_MAX) {
+      return [[NXNumber numberWithInt64:-(int64_t)value] retain];
+    }
+    if (value == (uint64_t)INT64_MAX + 1) {
+      return [[NXNumber numberWithInt64:INT64_MIN] retain];
+    }
+  }
+  return [[NXString allocWithZone:json->_objectZone] initWithBytes:bytes
+                                                             length:length];
+}
+
+/*
+ * Add a value to the open array or map, or make it the parsed object when
+ * there is none.
+ */
+static BOOL __objc_json_add(NXJSON *json, id value) {
+  if (json->_depth == 0) {
+    objc_assert(json->_object == nil);
+    json->_object = [value retain];
+    return YES;
+  }
+  id parent = json->_stack[json->_depth - 1];
+  if (json->_key == nil) {
+    return [(NXArray *)parent append:value];
+  }
+  BOOL success = [(NXMap *)parent setObject:value forKey:json->_key];
+  [json->_key release];
+  json->_key = nil;
+  return success;
+}
+
+/*
+ * Create the objects for a parser event. An array or map is added to its
+ * parent when it starts, so that values can be added to it as they are
+ * parsed.
+ */
+static BOOL __objc_json_build(NXJSON *json, objc_json_event_t event,
+                              char *bytes, size_t length) {
+  id value = nil;
+  switch (event) {
+  case objc_json_key:
+    objc_assert(json->_key == nil);
+    json->_key = __objc_json_string(json, bytes, length);
+    return json->_key != nil;
+  case objc_json_object_end:
+  case objc_json_array_end:
+    objc_assert(json->_depth > 0);
+    json->_depth--;
+    return YES;
+  case objc_json_object_start:
+    value = [[NXMap allocWithZone:json->_objectZone]
+        initWithCapacity:NXJSON_MAP_CAPACITY];
+    break;
+  case objc_json_array_start:
+    value = [[NXArray allocWithZone:json->_objectZone] init];
+    break;
+  case objc_json_null:
+    value = [[NXNull nullValue] retain];
+    break;
+  case objc_json_true:
+    value = [[NXNumber trueValue] retain];
+    break;
+  case objc_json_false:
+    value = [[NXNumber falseValue] retain];
+    break;
+  case objc_json_number:
+    value = __objc_json_number(json, bytes, length);
+    break;
+  case objc_json_string:
+    value = __objc_json_string(json, bytes, length);
+    break;
+  }
+  if (value == nil) {
+    return NO;
+  }
+
+  // Add the value, and open an array or map
+  BOOL success = __objc_json_add(json, value);
+  if (success &&
+      (event == objc_json_object_start || event == objc_json_array_start)) {
+    objc_assert(json->_depth < NXJSON_MAX_DEPTH);
+    json->_stack[json->_depth++] = value;
+  }
+  [value release];
+  return success;
+}
+
+/*
+ * Receive an event from the parser, and pass it to the delegate or create
+ * the objects for it.
+ */
+static BOOL __objc_json_callback(void *context, objc_json_event_t event,
+                                 char *bytes, size_t length) {
+  NXJSON *json = (NXJSON *)context;
+  if (json->_delegate != nil) {
+    // The events are in the same order as NXJSONEvent
+    return [json->_delegate parser:json
+                          didParse:(NXJSONEvent)event
+                             bytes:bytes
+                            length:length];
+  }
+  return __objc_json_build(json, event, bytes, length);
+}
+
+/*
+ * Release the objects which have been parsed.
+ */
+- (void)_releaseObjects {
+  [_object release];
+  [_key release];
+  _object = nil;
+  _key = nil;
+  _depth = 0;
+  _finished = NO;
+}
+
+/*
+ * Initializes a parser. When inplace is YES, the input must be passed to
+ * objc_json_parser_parse in one call, and strings reference it.
+ */
+- (id)_initWithDelegate:(id<JSONDelegate>)delegate
+                   zone:(NXZone *)zone
+                inplace:(BOOL)inplace {
+  objc_assert(OBJC_JSON_MAX_DEPTH <= NXJSON_MAX_DEPTH);
+  self = [super init];
+  if (self == nil) {
+    return nil;
+  }
+  _object = nil;
+  _key = nil;
+  _parser = objc_json_parser_new(__objc_json_callback, self, inplace);
+  if (_parser == NULL) {
+    [self release];
+    return nil;
+  }
+  _delegate = delegate;
+  _objectZone = zone;
+  _depth = 0;
+  _nocopy = inplace;
+  _finished = NO;
+  return self;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// LIFECYCLE
+
+/**
+ * @brief Initializes a parser which creates objects in the default zone.
+ */
+- (id)init {
+  return [self _initWithDelegate:nil zone:nil inplace:NO];
+}
+
+/**
+ * @brief Initializes a parser which creates objects in a zone.
+ */
+- (id)initWithZone:(NXZone *)zone {
+  return [self _initWithDelegate:nil zone:zone inplace:NO];
+}
+
+/**
+ * @brief Initializes a parser which passes events to a delegate.
+ */
+- (id)initWithDelegate:(id<JSONDelegate>)delegate {
+  objc_assert(delegate);
+  return [self _initWithDelegate:delegate zone:nil inplace:NO];
+}
+
+/**
+ * @brief Returns the object parsed from JSON data.
+ */
++ (id)objectWithData:(NXData *)data {
+  return [self objectWithData:data zone:nil options:NXJSONOptionNone];
+}
+
+/**
+ * @brief Returns the object parsed from a JSON string.
+ */
++ (id)objectWithString:(id<NXConstantStringProtocol>)string {
+  objc_assert(string);
+  NXJSON *json = [[self alloc] init];
+  if (json == nil) {
+    return nil;
+  }
+  id object = nil;
+  if ([json parseBytes:[string cStr] length:[string length]] &&
+      [json finish]) {
+    object = [[json->_object retain] autorelease];
+  }
+  [json release];
+  return object;
+}
+
+/**
+ * @brief Returns the object parsed from JSON data, allocated from a zone.
+ */
++ (id)objectWithData:(NXData *)data
+                zone:(NXZone *)zone
+             options:(NXJSONOptions)options {
+  objc_assert(data);
+  BOOL inplace = (options & NXJSONOptionNoCopy) ? YES : NO;
+  NXJSON *json = [[self alloc] _initWithDelegate:nil
+                                            zone:zone
+                                         inplace:inplace];
+  if (json == nil) {
+    return nil;
+  }
+
+  // The buffer of the data is owned by the data, so it can be unescaped in
+  // place
+  id object = nil;
+  BOOL success =
+      objc_json_parser_parse(json->_parser, (char *)[data bytes], [data size]);
+  if (success && [json finish]) {
+    object = [[json->_object retain] autorelease];
+  }
+  [json release];
+  return object;
+}
+
+/**
+ * @brief Frees the parser and the parsed objects.
+ */
+- (void)dealloc {
+  [self _releaseObjects];
+  if (_parser != NULL) {
+    objc_json_parser_delete(_parser);
+  }
+  [super dealloc];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PUBLIC METHODS
+
+/**
+ * @brief Parses a chunk of JSON.
+ */
+- (BOOL)parseBytes:(const void *)bytes length:(size_t)length {
+  objc_assert(bytes || length == 0);
+  objc_assert(_nocopy == NO);
+
+  // The parser does not modify the input unless it is in place
+  if (objc_json_parser_parse(_parser, (char *)bytes, length) == NO) {
+    [self _releaseObjects];
+    return NO;
+  }
+  return YES;
+}
+
+/**
+ * @brief Completes parsing at the end of the input.
+ */
+- (BOOL)finish {
+  if (objc_json_parser_finish(_parser) == NO) {
+    [self _releaseObjects];
+    return NO;
+  }
+  objc_assert(_depth == 0);
+  _finished = YES;
+  return YES;
+}
+
+/**
+ * @brief Returns the parsed object.
+ */
+- (id)object {
+  return _finished ? _object : nil;
+}
+
+/**
+ * @brief Returns the reason parsing failed.
+ */
+- (NXString *)error {
+  size_t offset = 0;
+  const char *error = objc_json_parser_error(_parser, &offset);
+  if (error == NULL) {
+    return nil;
+  }
+  return [NXString stringWithFormat:@"%s at offset %zu", error, offset];
+}
+
+/**
+ * @brief Resets the parser, so that it can parse another value.
+ */
+- (void)reset {
+  [self _releaseObjects];
+  objc_json_parser_reset(_parser);
+}
+
+@end
@@ -0,0 +1,384 @@
+#include "NXString+Private.h"
+#include <Foundation/Foundation.h>
+#include <runtime-sys/sys.h>
+#include <string.h>
+
+///////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS
+
+/*
+ * Initial capacity of the buffer for stringWithObject:
+ */
+#define NXJSONWRITER_CAPACITY 64
+
+/*
+ * Size of the buffer for a writer with a sink. Larger writes are passed to
+ * the sink directly.
+ */
+#define NXJSONWRITER_SINK_SIZE 128
+
+///////////////////////////////////////////////////////////////////////////////
+// GLOBALS
+
+/*
+ * The character after the backslash for each control character, or 'u' for
+ * control characters which are written as a unicode escape.
+ */
+static const char __objc_json_escapes[0x20] = {
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u',
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    'u', 'u'};
+
+static const char __objc_json_hex[] = "0123456789ABCDEF";
+
+@implementation NXJSONWriter
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE METHODS
+
+/*
+ * Grow the buffer so that it has space for size more bytes and a null
+ * terminator. The buffer grows by at least 1.5x so that repeated writes are
+ * amortized.
+ */
+static BOOL __objc_json_grow(NXJSONWriter *writer, size_t size) {
+  size_t cap = writer->_length + size + 1;
+  if (cap <= writer->_cap) {
+    return YES;
+  }
+  size_t grow = writer->_cap + (writer->_cap >> 1);
+  if (cap < grow) {
+    cap = grow;
+  }
+  char *data = [writer->_zone reallocWithPtr:writer->_data size:cap];
+  if (data == NULL) {
+    writer->_failed = YES;
+    return NO;
+  }
+  writer->_data = data;
+  writer->_cap = cap;
+  return YES;
+}
+
+/*
+ * Pass the buffered output to the sink, and empty the buffer.
+ */
+static BOOL __objc_json_drain(NXJSONWriter *writer) {
+  if (writer->_length > 0) {
+    if (writer->_sink(writer->_context, writer->_data, writer->_length) ==
+        NO) {
+      writer->_failed = YES;
+      return NO;
+    }
+    writer->_written += writer->_length;
+    writer->_length = 0;
+  }
+  return YES;
+}
+
+/*
+ * Append bytes to the output. The buffer is grown, or passed to the sink
+ * when it is full.
+ */
+static BOOL __objc_json_write(NXJSONWriter *writer, const char *bytes,
+                              size_t length) {
+  if (writer->_failed) {
+    return NO;
+  }
+  if (writer->_length + length >= writer->_cap) {
+    if (writer->_sink == NULL) {
+      if (__objc_json_grow(writer, length) == NO) {
+        return NO;
+      }
+    } else {
+      if (__objc_json_drain(writer) == NO) {
+        return NO;
+      }
+      if (length >= writer->_cap) {
+        // Pass a large write to the sink without copying it
+        if (writer->_sink(writer->_context, bytes, length) == NO) {
+          writer->_failed = YES;
+          return NO;
+        }
+        writer->_written += length;
+        return YES;
+      }
+    }
+  }
+  sys_memcpy(writer->_data + writer->_length, bytes, length);
+  writer->_length += length;
+  return YES;
+}
+
+/*
+ * Append the escape sequence for a byte which cannot appear in a JSON
+ * string.
+ */
+static BOOL __objc_json_write_escape(NXJSONWriter *writer, unsigned char c) {
+  char escape[6] = {'\\', (char)c, '0', '0', '0', '0'};
+  if (c == '"' || c == '\\') {
+    return __objc_json_write(writer, escape, 2);
+  }
+  escape[1] = __objc_json_escapes[c];
+  if (escape[1] != 'u') {
+    return __objc_json_write(writer, escape, 2);
+  }
+  escape[4] = __objc_json_hex[c >> 4];
+  escape[5] = __objc_json_hex[c & 0xF];
+  return __objc_json_write(writer, escape, 6);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// LIFECYCLE
+
+/**
+ * @brief Initializes a writer which writes to a buffer.
+ */
+- (id)initWithCapacity:(size_t)capacity {
+  self = [super init];
+  if (self == nil) {
+    return nil;
+  }
+  _data = NULL;
+  _length = 0;
+  _cap = 0;
+  _written = 0;
+  _sink = NULL;
+  _context = NULL;
+  _failed = NO;
+  if (capacity > 0) {
+    _data = [_zone allocWithSize:capacity];
+    if (_data == NULL) {
+      [self release];
+      return nil;
+    }
+    _cap = capacity;
+  }
+  return self;
+}
+
+/**
+ * @brief Initializes a writer which passes its output to a sink function.
+ */
+- (id)initWithSink:(NXJSONSink)sink context:(void *)context {
+  objc_assert(sink);
+  self = [self initWithCapacity:NXJSONWRITER_SINK_SIZE];
+  if (self) {
+    _sink = sink;
+    _context = context;
+  }
+  return self;
+}
+
+/**
+ * @brief Returns a new writer which writes to a buffer.
+ */
++ (NXJSONWriter *)writerWithCapacity:(size_t)capacity {
+  return [[[self alloc] initWithCapacity:capacity] autorelease];
+}
+
+/**
+ * @brief Returns a new writer which passes its output to a sink function.
+ */
++ (NXJSONWriter *)writerWithSink:(NXJSONSink)sink context:(void *)context {
+  return [[[self alloc] initWithSink:sink context:context] autorelease];
+}
+
+/**
+ * @brief Returns the JSON representation of an object.
+ */
++ (NXString *)stringWithObject:(id)object {
+  NXJSONWriter *writer =
+      [[self alloc] initWithCapacity:NXJSONWRITER_CAPACITY];
+  if (writer == nil) {
+    return nil;
+  }
+  NXString *json = nil;
+  if ([writer writeObject:object]) {
+    json = [writer string];
+  }
+  [writer release];
+  return json;
+}
+
+/**
+ * @brief Frees the buffer. Output which has not been flushed to a sink is
+ * discarded.
+ */
+- (void)dealloc {
+  if (_data != NULL) {
+    [_zone free:_data];
+  }
+  [super dealloc];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PUBLIC METHODS
+
+/**
+ * @brief Writes the JSON representation of an object.
+ */
+- (BOOL)writeObject:(id)object {
+  if (_failed) {
+    return NO;
+  }
+  if (object == nil) {
+    return __objc_json_write(self, "null", 4);
+  }
+
+  // Objects which can write themselves do not need a string
+  if (object_respondsToSelector(object, @selector(writeJSON:))) {
+    if ([object writeJSON:self] == NO) {
+      _failed = YES;
+    }
+    return _failed ? NO : YES;
+  }
+
+  // Use JSONProtocol if available, or else quote the description
+  if ([object conformsTo:@protocol(JSONProtocol)]) {
+    NXString *json = [object JSONString];
+    if (json == nil) {
+      _failed = YES;
+      return NO;
+    }
+    return __objc_json_write(self, [json cStr], [json length]);
+  } else {
+    NXString *description = [object description];
+    return [self writeQuotedBytes:[description cStr]
+                           length:[description length]];
+  }
+}
+
+/**
+ * @brief Writes bytes to the output without escaping them.
+ */
+- (BOOL)writeBytes:(const char *)bytes length:(size_t)length {
+  objc_assert(bytes || length == 0);
+  return __objc_json_write(self, bytes, length);
+}
+
+/**
+ * @brief Writes a null-terminated string to the output without escaping it.
+ */
+- (BOOL)writeCString:(const char *)cStr {
+  objc_assert(cStr);
+  return __objc_json_write(self, cStr, strlen(cStr));
+}
+
+/**
+ * @brief Writes bytes as a quoted JSON string.
+ */
+- (BOOL)writeQuotedBytes:(const char *)bytes length:(size_t)length {
+  objc_assert(bytes || length == 0);
+
+  // Make space for the string and the quotes at once, if it does not need
+  // escaping
+  if (_sink == NULL && _failed == NO &&
+      __objc_json_grow(self, length + 2) == NO) {
+    return NO;
+  }
+  if (__objc_json_write(self, "\"", 1) == NO) {
+    return NO;
+  }
+
+  // Copy each run of bytes which do not need escaping at once
+  const unsigned char *run = (const unsigned char *)bytes;
+  const unsigned char *end = run + length;
+  const unsigned char *ptr = run;
+  while (ptr < end) {
+    unsigned char c = *ptr;
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      ptr++;
+      continue;
+    }
+    if (ptr > run &&
+        __objc_json_write(self, (const char *)run, ptr - run) == NO) {
+      return NO;
+    }
+    if (__objc_json_write_escape(self, c) == NO) {
+      return NO;
+    }
+    run = ++ptr;
+  }
+  if (ptr > run &&
+      __objc_json_write(self, (const char *)run, ptr - run) == NO) {
+    return NO;
+  }
+  return __objc_json_write(self, "\"", 1);
+}
+
+/**
+ * @brief Writes a signed integer in decimal.
+ */
+- (BOOL)writeInt64:(int64_t)value {
+  if (value >= 0) {
+    return [self writeUnsignedInt64:(uint64_t)value];
+  }
+  char buf[21];
+  char *ptr = buf + sizeof(buf);
+  uint64_t magnitude = (uint64_t)0 - (uint64_t)value;
+  do {
+    *--ptr = (char)('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude > 0);
+  *--ptr = '-';
+  return __objc_json_write(self, ptr, buf + sizeof(buf) - ptr);
+}
+
+/**
+ * @brief Writes an unsigned integer in decimal.
+ */
+- (BOOL)writeUnsignedInt64:(uint64_t)value {
+  char buf[20];
+  char *ptr = buf + sizeof(buf);
+  do {
+    *--ptr = (char)('0' + value % 10);
+    value /= 10;
+  } while (value > 0);
+  return __objc_json_write(self, ptr, buf + sizeof(buf) - ptr);
+}
+
+/**
+ * @brief Passes any buffered output to the sink.
+ */
+- (BOOL)flush {
+  if (_failed) {
+    return NO;
+  }
+  if (_sink == NULL) {
+    return YES;
+  }
+  return __objc_json_drain(self);
+}
+
+/**
+ * @brief Returns the output of a writer without a sink as a string.
+ */
+- (NXString *)string {
+  if (_sink != NULL || _failed) {
+    return nil;
+  }
+  if (_data == NULL) {
+    return [[[NXString alloc] init] autorelease];
+  }
+
+  // Pass the buffer to the string, and empty the writer
+  char *data = _data;
+  size_t length = _length;
+  size_t cap = _cap;
+  _data = NULL;
+  _length = 0;
+  _cap = 0;
+  return [[[NXString allocWithZone:_zone] initWithBuffer:data
+                                                  length:length
+                                                capacity:cap] autorelease];
+}
+
+/**
+ * @brief Returns the number of bytes written.
+ */
+- (size_t)length {
+  return _written + _length;
+}
+
+@end
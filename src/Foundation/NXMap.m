@@ -1,6 +1,6 @@
+#include "NXString+Private.h"
 #include <Foundation/Foundation.h>
 #include <runtime-sys/sys.h>
-#include <string.h>
 
 #define DEFAULT_MAP_CAPACITY 32
 
@@ -12,40 +12,19 @@
 
 /**
  * @brief Key comparison function for NXMap - compares Objective-C string
- * objects
+ * objects. The hashes of the keys are already equal, and strings are compared
+ * by length before their bytes.
  */
 static bool _nxmap_keyequals(void *keyptr, void *other_keyptr) {
-  id<NXConstantStringProtocol> key1 = (id)keyptr;
-  id<NXConstantStringProtocol> key2 = (id)other_keyptr;
-
-  if (key1 == key2) {
-    return true; // Same object
-  }
-
-  const char *str1 = [key1 cStr];
-  const char *str2 = [key2 cStr];
-
-  // Handle NULL string cases
-  if (str1 == NULL && str2 == NULL) {
-    return true;
-  }
-  if (str1 == NULL || str2 == NULL) {
-    return false;
-  }
-
-  return strcmp(str1, str2) == 0;
+  return _nxstring_equals((id)keyptr, (id)other_keyptr);
 }
 
 /**
- * @brief Hash function for NXMap - uses the C string content
+ * @brief Hash function for NXMap - uses the hash of the string content,
+ * which NXString caches so that it is not recomputed on every lookup
  */
 static uintptr_t _nxmap_hash(id<NXConstantStringProtocol> key) {
-  const char *str = [key cStr];
-  // Handle NULL string case
-  if (str == NULL) {
-    return 0; // Default hash for NULL strings
-  }
-  return sys_hash_djb2(str);
+  return [key hash];
 }
 
 @implementation NXMap
@@ -257,7 +236,8 @@ static uintptr_t _nxmap_hash(id<NXConstantStringProtocol> key) {
 /**
  * @brief Returns the capacity of the map.
  *
- * This is the maximum number of elements the map can hold before resizing.
+ * This is the number of slots in the hash table, which is resized when three
+ * quarters of the slots hold a key or a removed key.
  */
 - (size_t)capacity {
   if (_data == nil) {
@@ -516,21 +496,6 @@ static uintptr_t _nxmap_hash(id<NXConstantStringProtocol> key) {
   return [[NXString stringWithString:[anObject description]] JSONBytes];
 }
 
-/**
- * @brief Convert an object to the number of bytes required for its JSON
- */
-+ (NXString *)_json_for_object:(id)anObject {
-  objc_assert(anObject);
-
-  // Use JSONProtocol if available
-  if ([anObject conformsTo:@protocol(JSONProtocol)]) {
-    return [anObject JSONString];
-  }
-
-  // Else we use the description method
-  return [[NXString stringWithString:[anObject description]] JSONString];
-}
-
 /**
  * @brief Returns the appropriate capacity for the JSON
  * representation of the instance.
@@ -558,18 +523,21 @@ static uintptr_t _nxmap_hash(id<NXConstantStringProtocol> key) {
  * @brief Returns a JSON representation of the instance.
  */
 - (NXString *)JSONString {
-  // Handle empty map or invalid state
-  if (_data == nil || _count == 0) {
-    return [NXString stringWithString:@"{}"];
-  }
+  return [NXJSONWriter stringWithObject:self];
+}
 
-  // Create string with calculated capacity
-  NXString *json = [NXString stringWithCapacity:[self JSONBytes] + 1];
-  if (json == nil) {
-    return nil; // Allocation failed
+/**
+ * @brief Write the key-value pairs of the map as JSON, separated by commas.
+ */
+- (BOOL)writeJSON:(NXJSONWriter *)writer {
+  if ([writer writeBytes:"{" length:1] == NO) {
+    return NO;
   }
 
-  [json appendCString:"{"];
+  // Handle empty map or invalid state
+  if (_data == nil || _count == 0) {
+    return [writer writeBytes:"}" length:1];
+  }
 
   sys_hashtable_iterator_t iter = {0};
   sys_hashtable_iterator_t *iterptr = &iter;
@@ -583,29 +551,21 @@ static uintptr_t _nxmap_hash(id<NXConstantStringProtocol> key) {
     objc_assert(value);
 
     // Add comma separator if not the first element
-    if (!firstElement) {
-      [json appendCString:", "];
+    if (!firstElement && [writer writeBytes:", " length:2] == NO) {
+      return NO;
     }
     firstElement = NO;
 
     // Add key-value pair: "key": value
-    NXString *keyJSON = [NXMap _json_for_object:key];
-    NXString *valueJSON = [NXMap _json_for_object:value];
-    if (keyJSON == nil || valueJSON == nil) {
-      return nil; // JSON conversion failed
+    if ([writer writeObject:key] == NO ||
+        [writer writeBytes:": " length:2] == NO ||
+        [writer writeObject:value] == NO) {
+      return NO;
     }
-
-    // Append key and value to JSON string
-    [json append:keyJSON];
-    [json appendCString:": "];
-    [json append:valueJSON];
   }
 
   // Append closing brace
-  [json appendCString:"}"];
-
-  // Return success
-  return json;
+  return [writer writeBytes:"}" length:1];
 }
 
 @end
@@ -35,6 +35,13 @@ static NXNull *nullValue;
   return [self description];
 }
 
+/**
+ * @brief Write the JSON representation of a null value.
+ */
+- (BOOL)writeJSON:(NXJSONWriter *)writer {
+  return [writer writeBytes:"null" length:4];
+}
+
 /**
  * @brief Returns the appropriate capacity for the JSON representation.
  */
@@ -160,6 +160,13 @@ uint32_t NXRandUnsignedInt32() { return sys_random_uint32(); }
   return [self description];
 }
 
+/**
+ * @brief Write the JSON representation of a number value.
+ */
+- (BOOL)writeJSON:(NXJSONWriter *)writer {
+  return [writer writeCString:[[self description] cStr]];
+}
+
 /**
  * @brief Returns the appropriate capacity for the JSON representation.
  * @note Default implementation returns 0 as it's always subclassed.
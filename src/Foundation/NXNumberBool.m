@@ -113,6 +113,13 @@ static NXNumberBool *falseNumber;
   return _value ? 4 : 5;
 }
 
+/**
+ * @brief Write the boolean value as a JSON true or false.
+ */
+- (BOOL)writeJSON:(NXJSONWriter *)writer {
+  return [writer writeCString:(_value ? "true" : "false")];
+}
+
 /**
  * @brief Check for equality with another NXNumber instance.
  */
@@ -7,6 +7,16 @@
 
 #include <Foundation/Foundation.h>
 
+/**
+ * @brief Smallest integer which is kept in the cache of small numbers.
+ */
+#define NXNUMBER_CACHE_MIN (-16)
+
+/**
+ * @brief Largest integer which is kept in the cache of small numbers.
+ */
+#define NXNUMBER_CACHE_MAX 255
+
 /**
  * @brief NXNumber subclass for storing 16-bit signed integer values.
  */
@@ -24,4 +34,13 @@
  */
 + (NXNumber *)numberWithInt16:(int16_t)value;
 
+/**
+ * @brief Return the shared instance for a small integer value.
+ * @param value A value between NXNUMBER_CACHE_MIN and NXNUMBER_CACHE_MAX.
+ *
+ * The instance for each value is created on first use and is never freed,
+ * so small integers of any type do not allocate a number each time.
+ */
++ (NXNumber *)cachedNumberWithInt16:(int16_t)value;
+
 @end
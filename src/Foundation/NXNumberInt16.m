@@ -1,11 +1,21 @@
 #include "NXNumberInt16.h"
 #include <Foundation/Foundation.h>
 
+///////////////////////////////////////////////////////////////////////////////
+// TYPES
+
+// Re-usable static instances of NXNumberInt16 for small integers
+static NXNumberInt16
+    *cachedNumbers[NXNUMBER_CACHE_MAX - NXNUMBER_CACHE_MIN + 1];
+
 ///////////////////////////////////////////////////////////////////////////////
 // LIFECYCLE
 
 @implementation NXNumberInt16
 
+// Numbers are created and released often, so they are kept in a pool
+NXOBJECT_POOL(16)
+
 /**
  * @brief Initialize an instance with a int16_t value.
  */
@@ -24,9 +34,34 @@
   if (value == 0) {
     return [NXNumber zeroValue];
   }
+  if (value >= NXNUMBER_CACHE_MIN && value <= NXNUMBER_CACHE_MAX) {
+    return [NXNumberInt16 cachedNumberWithInt16:value];
+  }
   return [[[NXNumberInt16 alloc] initWithInt16:value] autorelease];
 }
 
+/**
+ * @brief Return the shared instance for a small integer value.
+ */
++ (NXNumber *)cachedNumberWithInt16:(int16_t)value {
+  objc_assert(value >= NXNUMBER_CACHE_MIN && value <= NXNUMBER_CACHE_MAX);
+  NXNumberInt16 **slot = &cachedNumbers[value - NXNUMBER_CACHE_MIN];
+  NXNumberInt16 *number = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+  if (number == nil) {
+    // The instance is allocated from the pool for the class, which is never
+    // freed. If another thread stores an instance first, it is used instead.
+    NXNumberInt16 *expected = nil;
+    number = [[NXNumberInt16 alloc] initWithInt16:value];
+    if (number != nil &&
+        !__atomic_compare_exchange_n(slot, &expected, number, NO,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+      [number release];
+      number = expected;
+    }
+  }
+  return number;
+}
+
 /**
  * @brief Get the stored value as a boolean.
  */
@@ -93,6 +128,13 @@
   return 6; // "-32768"
 }
 
+/**
+ * @brief Write the 16-bit signed value as a JSON number.
+ */
+- (BOOL)writeJSON:(NXJSONWriter *)writer {
+  return [writer writeInt64:_value];
+}
+
 /**
  * @brief Check for equality with another NXNumber instance.
  */
@@ -1,3 +1,4 @@
+#include "NXNumberInt16.h"
 #include "NXNumberInt32.h"
 #include <Foundation/Foundation.h>
 
@@ -6,6 +7,9 @@
 
 @implementation NXNumberInt32
 
+// Numbers are created and released often, so they are kept in a pool
+NXOBJECT_POOL(16)
+
 /**
  * @brief Initialize an instance with a int32_t value.
  */
@@ -24,6 +28,9 @@
   if (value == 0) {
     return [NXNumber zeroValue];
   }
+  if (value >= NXNUMBER_CACHE_MIN && value <= NXNUMBER_CACHE_MAX) {
+    return [NXNumberInt16 cachedNumberWithInt16:(int16_t)value];
+  }
   return [[[NXNumberInt32 alloc] initWithInt32:value] autorelease];
 }
 
@@ -96,6 +103,13 @@
   return 11;
 }
 
+/**
+ * @brief Write the 32-bit signed value as a JSON number.
+ */
+- (BOOL)writeJSON:(NXJSONWriter *)writer {
+  return [writer writeInt64:_value];
+}
+
 /**
  * @brief Check for equality with another NXNumber instance.
  */
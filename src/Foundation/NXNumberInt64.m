@@ -1,3 +1,4 @@
+#include "NXNumberInt16.h"
 #include "NXNumberInt64.h"
 #include <Foundation/Foundation.h>
 
@@ -6,6 +7,9 @@
 
 @implementation NXNumberInt64
 
+// Numbers are created and released often, so they are kept in a pool
+NXOBJECT_POOL(16)
+
 /**
  * @brief Initialize an instance with a int64_t value.
  */
@@ -24,6 +28,9 @@
   if (value == 0) {
     return [NXNumber zeroValue];
   }
+  if (value >= NXNUMBER_CACHE_MIN && value <= NXNUMBER_CACHE_MAX) {
+    return [NXNumberInt16 cachedNumberWithInt16:(int16_t)value];
+  }
   return [[[NXNumberInt64 alloc] initWithInt64:value] autorelease];
 }
 
@@ -97,6 +104,13 @@
   return 20;
 }
 
+/**
+ * @brief Write the 64-bit signed value as a JSON number.
+ */
+- (BOOL)writeJSON:(NXJSONWriter *)writer {
+  return [writer writeInt64:_value];
+}
+
 /**
  * @brief Check for equality with another NXNumber instance.
  */
@@ -1,3 +1,4 @@
+#include "NXNumberInt16.h"
 #include "NXNumberUnsignedInt16.h"
 #include <Foundation/Foundation.h>
 
@@ -6,6 +7,9 @@
 
 @implementation NXNumberUnsignedInt16
 
+// Numbers are created and released often, so they are kept in a pool
+NXOBJECT_POOL(16)
+
 /**
  * @brief Initialize an instance with a uint16_t value.
  */
@@ -24,6 +28,9 @@
   if (value == 0) {
     return [NXNumber zeroValue];
   }
+  if (value <= NXNUMBER_CACHE_MAX) {
+    return [NXNumberInt16 cachedNumberWithInt16:(int16_t)value];
+  }
   return
       [[[NXNumberUnsignedInt16 alloc] initWithUnsignedInt16:value] autorelease];
 }
@@ -93,6 +100,13 @@
   return 5;
 }
 
+/**
+ * @brief Write the 16-bit unsigned value as a JSON number.
+ */
+- (BOOL)writeJSON:(NXJSONWriter *)writer {
+  return [writer writeUnsignedInt64:_value];
+}
+
 /**
  * @brief Check for equality with another NXNumber instance.
  */
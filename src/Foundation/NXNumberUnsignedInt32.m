@@ -1,3 +1,4 @@
+#include "NXNumberInt16.h"
 #include "NXNumberUnsignedInt32.h"
 #include <Foundation/Foundation.h>
 
@@ -6,6 +7,9 @@
 
 @implementation NXNumberUnsignedInt32
 
+// Numbers are created and released often, so they are kept in a pool
+NXOBJECT_POOL(16)
+
 /**
  * @brief Initialize an instance with a uint32_t value.
  */
@@ -24,6 +28,9 @@
   if (value == 0) {
     return [NXNumber zeroValue];
   }
+  if (value <= NXNUMBER_CACHE_MAX) {
+    return [NXNumberInt16 cachedNumberWithInt16:(int16_t)value];
+  }
   return
       [[[NXNumberUnsignedInt32 alloc] initWithUnsignedInt32:value] autorelease];
 }
@@ -95,6 +102,13 @@
   return 10;
 }
 
+/**
+ * @brief Write the 32-bit unsigned value as a JSON number.
+ */
+- (BOOL)writeJSON:(NXJSONWriter *)writer {
+  return [writer writeUnsignedInt64:_value];
+}
+
 /**
  * @brief Check for equality with another NXNumber instance.
  */
@@ -1,3 +1,4 @@
+#include "NXNumberInt16.h"
 #include "NXNumberUnsignedInt64.h"
 #include <Foundation/Foundation.h>
 
@@ -6,6 +7,9 @@
 
 @implementation NXNumberUnsignedInt64
 
+// Numbers are created and released often, so they are kept in a pool
+NXOBJECT_POOL(16)
+
 /**
  * @brief Initialize an instance with a uint64_t value.
  */
@@ -24,6 +28,9 @@
   if (value == 0) {
     return [NXNumber zeroValue];
   }
+  if (value <= NXNUMBER_CACHE_MAX) {
+    return [NXNumberInt16 cachedNumberWithInt16:(int16_t)value];
+  }
   return
       [[[NXNumberUnsignedInt64 alloc] initWithUnsignedInt64:value] autorelease];
 }
@@ -96,6 +103,13 @@
   return 20; // 20 characters for the maximum value of uint64_t
 }
 
+/**
+ * @brief Write the 64-bit unsigned value as a JSON number.
+ */
+- (BOOL)writeJSON:(NXJSONWriter *)writer {
+  return [writer writeUnsignedInt64:_value];
+}
+
 /**
  * @brief Check for equality with another NXNumber instance.
  */
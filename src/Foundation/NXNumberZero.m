@@ -88,6 +88,13 @@ static NXNumberZero *zeroNumber;
   return 1;
 }
 
+/**
+ * @brief Write the zero value as a JSON number.
+ */
+- (BOOL)writeJSON:(NXJSONWriter *)writer {
+  return [writer writeBytes:"0" length:1];
+}
+
 /**
  * @brief Check if this number is equal to another object.
  */
@@ -1,3 +1,4 @@
+#include "NXZone+Private.h"
 #include <Foundation/Foundation.h>
 #include <runtime-sys/sys.h>
 
@@ -17,21 +18,42 @@
  * @brief Allocates a new instance of object in a specific zone.
  */
 + (id)allocWithZone:(NXZone *)zone {
+  size_t size = class_getInstanceSize(self);
+  id instance = nil;
   if (zone == nil) {
-    zone = [NXZone defaultZone]; // Use the default zone if none is provided
-    objc_assert(zone);           // Abort if no default zone is available
+    // Use the object pool for the class if it has one, and fall back to the
+    // default zone if the instance does not fit in the pool
+    zone = [self objectPool];
+    if (zone != nil) {
+      instance = [zone allocWithSize:size];
+    }
+    if (instance == nil) {
+      zone = [NXZone defaultZone]; // Use the default zone
+      objc_assert(zone);           // Abort if no default zone is available
+    }
+  }
+  if (instance == nil) {
+    instance = [zone allocWithSize:size];
   }
-  id instance = [zone allocWithSize:class_getInstanceSize(self)];
   if (instance) {
     object_setClass(instance, self);
     ((NXObject *)instance)->_zone = zone; // Set the zone for the instance
-    ((NXObject *)instance)->_retain = 1;  // Retain the instance
-    ((NXObject *)instance)->_next =
-        Nil; // Initialize the autorelease linked list pointer
+    sys_atomic_init(&((NXObject *)instance)->_retain,
+                    1); // Retain the instance
+#ifdef NXZONEPROFILE
+    [zone profileObject:instance]; // Count the allocation for the class
+#endif
   }
   return instance;
 }
 
+/**
+ * @brief Returns the pool zone for instances of the class.
+ */
++ (NXZone *)objectPool {
+  return nil; // No pool unless the class uses NXOBJECT_POOL()
+}
+
 /**
  * @brief Deallocate the object, freeing its memory.
  * @warning This method intentionally does NOT call [super dealloc] to prevent
@@ -50,8 +72,9 @@
   if (!_zone) {
     sys_panicf("Object dealloc called without a zone");
   }
-  if (_retain != 0) {
-    sys_panicf("[NXObject dealloc] called with retain count %d", _retain);
+  if (sys_atomic_get(&_retain) != 0) {
+    sys_panicf("[NXObject dealloc] called with retain count %u",
+               sys_atomic_get(&_retain));
   }
   if (self != _zone) {
     [_zone free:self]; // Free the memory in the zone
@@ -68,9 +91,26 @@
  * @brief Increases the retain count of the receiver.
  */
 - (id)retain {
+#if SYS_ATOMIC_LOCK_FREE
+  uint32_t count = sys_atomic_get(&_retain);
+  do {
+    if (count == 0 || count == UINT32_MAX) {
+      sys_panicf("[%s retain] called with retain count of %u",
+                 object_getClassName(self), count);
+    }
+  } while (!sys_atomic_cas(&_retain, &count, count + 1));
+#else
+  // Atomic operations are implemented with locks on this target, so take the
+  // object lock once rather than for every attempt
   @synchronized(self) {
-    _retain++;
+    uint32_t count = sys_atomic_get(&_retain);
+    if (count == 0 || count == UINT32_MAX) {
+      sys_panicf("[%s retain] called with retain count of %u",
+                 object_getClassName(self), count);
+    }
+    sys_atomic_set(&_retain, count + 1);
   }
+#endif
   return self;
 }
 
@@ -78,15 +118,30 @@
  * @brief Decreases the retain count of the receiver.
  */
 - (void)release {
-  @synchronized(self) {
-    if (_retain == 0) {
+#if SYS_ATOMIC_LOCK_FREE
+  // The swap has acquire and release ordering, so the thread which releases
+  // the last reference sees all writes made by other threads before they
+  // released theirs
+  uint32_t count = sys_atomic_get(&_retain);
+  do {
+    if (count == 0) {
       sys_panicf("[%s release] called with retain count of zero",
                  object_getClassName(self));
     }
-    _retain--;
-    if (_retain == 0) {
-      [self dealloc];
+  } while (!sys_atomic_cas(&_retain, &count, count - 1));
+#else
+  uint32_t count;
+  @synchronized(self) {
+    count = sys_atomic_get(&_retain);
+    if (count == 0) {
+      sys_panicf("[%s release] called with retain count of zero",
+                 object_getClassName(self));
     }
+    sys_atomic_set(&_retain, count - 1);
+  }
+#endif
+  if (count == 1) {
+    [self dealloc];
   }
 }
 
@@ -0,0 +1,28 @@
+/**
+ * @file NXPoolZone.h
+ * @brief Defines the NXPoolZone class, a zone of fixed-size slots.
+ */
+#pragma once
+#include <Foundation/Foundation.h>
+#include <runtime-sys/sys.h>
+
+/**
+ * @brief A memory zone which allocates fixed-size slots from a free list.
+ *
+ * Slots are allocated from chunks, and a freed slot is pushed onto the free
+ * list so the next allocation reuses it. Instances are created with
+ * +[NXZone poolZoneWithSize:count:].
+ */
+@interface NXPoolZone : NXZone {
+@private
+  void *_chunks;     ///< Chunks of slots, most recent first
+  void *_free;       ///< First free slot
+  size_t _slot;      ///< Size of each slot in bytes
+  size_t _grow;      ///< Number of slots added to the pool at once
+  size_t _slots;     ///< Number of slots in all chunks
+  size_t _peak;      ///< Highest number of slots in use
+  size_t _allocs;    ///< Number of allocations
+  sys_mutex_t _lock; ///< Protects the free list
+}
+
+@end
@@ -0,0 +1,234 @@
+#include "NXPoolZone.h"
+#include "NXZone+malloc.h"
+#include <Foundation/Foundation.h>
+#include <runtime-sys/sys.h>
+
+/*
+ * A chunk of slots, which is followed by the slots. The first word of a
+ * free slot points to the next free slot.
+ */
+struct objc_pool_chunk {
+  struct objc_pool_chunk *next; // Next chunk
+  size_t count;                 // Number of slots in the chunk
+};
+
+@implementation NXPoolZone
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE METHODS
+
+/*
+ * Add a chunk of slots to the free list. Must be called with the lock held.
+ * Returns NO if the chunk could not be allocated.
+ */
+- (BOOL)_grow {
+  struct objc_pool_chunk *chunk =
+      __zone_malloc(sizeof(struct objc_pool_chunk) + _slot * _grow);
+  if (chunk == NULL) {
+    return NO;
+  }
+  chunk->next = (struct objc_pool_chunk *)_chunks;
+  chunk->count = _grow;
+  _chunks = chunk;
+
+  // Thread the slots onto the free list, in address order
+  uint8_t *base = (uint8_t *)(chunk + 1);
+  for (size_t i = _grow; i > 0; i--) {
+    void **slot = (void **)(base + (i - 1) * _slot);
+    *slot = _free;
+    _free = slot;
+  }
+  _slots += _grow;
+  return YES;
+}
+
+/*
+ * Check if memory is a slot in one of the chunks.
+ */
+- (BOOL)_owns:(void *)ptr {
+  struct objc_pool_chunk *chunk = (struct objc_pool_chunk *)_chunks;
+  while (chunk != NULL) {
+    uint8_t *base = (uint8_t *)(chunk + 1);
+    size_t offset = (size_t)((uint8_t *)ptr - base);
+    if ((uint8_t *)ptr >= base && offset < chunk->count * _slot) {
+      return offset % _slot == 0 ? YES : NO;
+    }
+    chunk = chunk->next;
+  }
+  return NO;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// LIFECYCLE
+
+/**
+ * Create a new pool zone of slots of a specific size in bytes, with an
+ * initial number of slots. A pool zone is never set as the default zone.
+ */
++ (id)poolZoneWithSize:(size_t)size count:(size_t)count {
+  objc_assert(size > 0);
+  objc_assert(count > 0);
+
+  NXPoolZone *zone = __zone_malloc(class_getInstanceSize(self));
+  if (zone == NULL) {
+    return nil;
+  }
+
+  // Initialize the object properly, with the instance variables of a
+  // general zone cleared
+  sys_memset(zone, 0, class_getInstanceSize(self));
+  object_setClass(zone, self);
+
+  // Set up instance variables. Each slot is aligned, and can hold the free
+  // list pointer.
+  size = (size + 7) & ~(size_t)7;
+  zone->_slot = size < sizeof(void *) ? sizeof(void *) : size;
+  zone->_grow = count;
+  zone->_size = zone->_slot * count;
+  zone->_count = 0;
+  zone->_lock = sys_mutex_init();
+  sys_atomic_init(&zone->_retain, 1); // Initial retain count
+
+  // Allocate the first chunk
+  if ([zone _grow] == NO) {
+    sys_mutex_finalize(&zone->_lock);
+    __zone_free(zone);
+    return nil;
+  }
+  return zone;
+}
+
++ (id)zoneWithSize:(size_t)size {
+  return [self poolZoneWithSize:size count:16];
+}
+
+/**
+ * Deallocate the zone, freeing all the chunks.
+ */
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wobjc-missing-super-calls"
+#endif
+- (void)dealloc {
+  // Sanity check: ensure no active allocations
+  if (_count != 0) {
+    sys_panicf("[NXPoolZone dealloc] called with %zu active allocations",
+               _count);
+  }
+  struct objc_pool_chunk *chunk = (struct objc_pool_chunk *)_chunks;
+  while (chunk != NULL) {
+    struct objc_pool_chunk *next = chunk->next;
+    __zone_free(chunk);
+    chunk = next;
+  }
+  sys_mutex_finalize(&_lock);
+  __zone_free(self);
+}
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// INSTANCE METHODS
+
+- (void *)allocWithSize:(size_t)size {
+  if (size > _slot) {
+    return NULL; // Too large for a slot
+  }
+  sys_mutex_lock(&_lock);
+  void **slot = (void **)_free;
+  if (slot == NULL && [self _grow]) {
+    slot = (void **)_free;
+  }
+  if (slot != NULL) {
+    // Pop the first free slot
+    _free = *slot;
+    _allocs++;
+    if (++_count > _peak) {
+      _peak = _count;
+    }
+  }
+  sys_mutex_unlock(&_lock);
+#ifdef DEBUG
+  NXLog(@"  allocWithSize: size=%zu => @%p", size, slot);
+#endif
+  return slot;
+}
+
+- (void)free:(void *)ptr {
+  if (ptr == NULL) {
+    return;
+  }
+#ifdef DEBUG
+  NXLog(@"  free: @%p", ptr);
+#endif
+  sys_mutex_lock(&_lock);
+#ifdef DEBUG
+  if ([self _owns:ptr] == NO) {
+    sys_panicf("[NXPoolZone free] failed to free memory @%p", ptr);
+  }
+#endif
+  // Push the slot onto the free list
+  *(void **)ptr = _free;
+  _free = ptr;
+  _count--;
+  sys_mutex_unlock(&_lock);
+}
+
+- (void *)reallocWithPtr:(void *)ptr size:(size_t)size {
+  if (ptr == NULL) {
+    return [self allocWithSize:size];
+  }
+  if (size == 0) {
+    [self free:ptr];
+    return NULL;
+  }
+  // Every slot is the same size, so memory stays in its slot or cannot grow
+  return size <= _slot ? ptr : NULL;
+}
+
+- (void)flushCache {
+  // There are no thread caches for a pool zone
+}
+
+- (void)dump {
+  sys_mutex_lock(&_lock);
+  NXLog(@"Zone dump for -[NXPoolZone] @%p:", self);
+  struct objc_pool_chunk *chunk = (struct objc_pool_chunk *)_chunks;
+  while (chunk != NULL) {
+    NXLog(@"  chunk @%p slots=%zu", chunk, chunk->count);
+    chunk = chunk->next;
+  }
+  NXLog(@"Slot size: %zu bytes, slots: %zu, used: %zu, free: %zu", _slot,
+        _slots, _count, _slots - _count);
+  NXLog(@"Peak used: %zu, allocations: %zu", _peak, _allocs);
+  sys_mutex_unlock(&_lock);
+}
+
+- (size_t)bytesTotal {
+  size_t size = 0;
+  sys_mutex_lock(&_lock);
+  struct objc_pool_chunk *chunk = (struct objc_pool_chunk *)_chunks;
+  while (chunk != NULL) {
+    size += sizeof(struct objc_pool_chunk) + chunk->count * _slot;
+    chunk = chunk->next;
+  }
+  sys_mutex_unlock(&_lock);
+  return size;
+}
+
+- (size_t)bytesUsed {
+  sys_mutex_lock(&_lock);
+  size_t used = _count * _slot;
+  sys_mutex_unlock(&_lock);
+  return used;
+}
+
+- (size_t)bytesFree {
+  sys_mutex_lock(&_lock);
+  size_t free = (_slots - _count) * _slot;
+  sys_mutex_unlock(&_lock);
+  return free;
+}
+
+@end
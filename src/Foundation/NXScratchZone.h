@@ -0,0 +1,23 @@
+/**
+ * @file NXScratchZone.h
+ * @brief Defines the NXScratchZone class, a zone which is recycled at once.
+ */
+#pragma once
+#include <Foundation/Foundation.h>
+
+/**
+ * @brief A memory zone which allocates by moving a pointer forward.
+ *
+ * Memory is allocated from chunks in order, freeing memory does nothing,
+ * and all the memory is recycled when the zone is reset. Instances are
+ * created with +[NXZone scratchZoneWithSize:].
+ */
+@interface NXScratchZone : NXZone {
+@private
+  void *_first;   ///< First chunk, which also holds the zone object
+  void *_current; ///< Chunk which allocations are made from
+  size_t _base;   ///< Bytes of the first chunk used by the zone object
+  void *_last;    ///< Last allocation, which can be resized in place
+}
+
+@end
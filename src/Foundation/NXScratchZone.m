@@ -0,0 +1,204 @@
+#include "NXScratchZone.h"
+#include "NXZone+scratch.h"
+#include <Foundation/Foundation.h>
+#include <runtime-sys/sys.h>
+
+@implementation NXScratchZone
+
+///////////////////////////////////////////////////////////////////////////////
+// LIFECYCLE
+
+/**
+ * Create a new scratch zone with a specific size in bytes. A scratch zone
+ * is never set as the default zone.
+ */
++ (id)scratchZoneWithSize:(size_t)size {
+  objc_assert(size > 0);
+
+  // The zone object is allocated at the start of the first chunk
+  size_t objectSize = objc_scratch_size_for(class_getInstanceSize(self));
+  objc_scratch_t *first = objc_scratch_new(NULL, objectSize + size);
+  if (!first) {
+    return nil;
+  }
+  NXScratchZone *zone = objc_scratch_alloc(first, objectSize);
+  if (zone == NULL) {
+    objc_scratch_delete(first);
+    return nil;
+  }
+
+  // Initialize the object properly, with the instance variables of a
+  // general zone cleared
+  sys_memset(zone, 0, objectSize);
+  object_setClass(zone, self);
+
+  // Set up instance variables
+  zone->_first = zone->_current = first;
+  zone->_base = objc_scratch_stats_used(first);
+  zone->_size = size;
+  zone->_count = 0;
+  sys_atomic_init(&zone->_retain, 1); // Initial retain count
+
+  return zone;
+}
+
++ (id)zoneWithSize:(size_t)size {
+  return [self scratchZoneWithSize:size];
+}
+
+/**
+ * Deallocate the zone, freeing all the chunks. Memory which has not been
+ * freed is not an error for a scratch zone.
+ */
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wobjc-missing-super-calls"
+#endif
+- (void)dealloc {
+  objc_scratch_delete((objc_scratch_t *)_first);
+}
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// INSTANCE METHODS
+
+- (void *)allocWithSize:(size_t)size {
+  void *ptr = NULL;
+  @synchronized(self) {
+    // Allocate from the current chunk, then from the chunks after it which
+    // were kept when the zone was reset, and finally from a new chunk
+    objc_scratch_t *cur = (objc_scratch_t *)_current;
+    while ((ptr = objc_scratch_alloc(cur, size)) == NULL) {
+      objc_scratch_t *next = objc_scratch_next(cur);
+      if (next == NULL) {
+        size_t chunkSize = objc_scratch_size_for(size);
+        next = objc_scratch_new(cur, chunkSize > _size ? chunkSize : _size);
+        if (next == NULL) {
+          break;
+        }
+      }
+      cur = next;
+    }
+    _current = cur;
+    if (ptr != NULL) {
+      _last = ptr;
+      _count++;
+    }
+  }
+#ifdef DEBUG
+  NXLog(@"  allocWithSize: size=%zu => @%p", size, ptr);
+#endif
+  return ptr;
+}
+
+- (void)free:(void *)ptr {
+  // Memory is recycled when the zone is reset
+  (void)ptr;
+}
+
+- (void *)reallocWithPtr:(void *)ptr size:(size_t)size {
+  if (ptr == NULL) {
+    return [self allocWithSize:size];
+  }
+  if (size == 0) {
+    return NULL; // Memory is recycled when the zone is reset
+  }
+  BOOL resized = NO;
+  size_t extent = 0;
+  @synchronized(self) {
+    // The last allocation is resized by moving the free pointer of its
+    // chunk. Other allocations end before the end of the allocated memory
+    // of their chunk, which bounds the bytes to copy.
+    if (ptr == _last) {
+      resized = objc_scratch_resize((objc_scratch_t *)_current, ptr, size);
+    }
+    objc_scratch_t *cur = (objc_scratch_t *)_first;
+    while (resized == NO && extent == 0 && cur != NULL) {
+      extent = objc_scratch_extent(cur, ptr);
+      cur = objc_scratch_next(cur);
+    }
+  }
+#ifdef DEBUG
+  NXLog(@"  reallocWithPtr: @%p size=%zu resized=%s", ptr, size,
+        resized ? "YES" : "NO");
+#endif
+  if (resized) {
+    return ptr;
+  }
+  if (extent == 0) {
+    sys_panicf("[NXScratchZone reallocWithPtr] memory @%p not in zone", ptr);
+  }
+
+  // Otherwise copy the memory to a new allocation
+  void *newPtr = [self allocWithSize:size];
+  if (newPtr != NULL) {
+    sys_memcpy(newPtr, ptr, size < extent ? size : extent);
+  }
+  return newPtr;
+}
+
+- (void)flushCache {
+  // There are no thread caches for a scratch zone
+}
+
+- (void)reset {
+  @synchronized(self) {
+    // Recycle all chunks, keeping the zone object in the first chunk. The
+    // chunks are kept so the next cycle does not need to allocate them.
+    objc_scratch_t *cur = (objc_scratch_t *)_first;
+    objc_scratch_reset(cur, _base);
+    while ((cur = objc_scratch_next(cur)) != NULL) {
+      objc_scratch_reset(cur, 0);
+    }
+    _current = _first;
+    _last = NULL;
+    _count = 0;
+  }
+}
+
+- (void)dump {
+  NXLog(@"Zone dump for -[NXScratchZone] @%p:", self);
+  objc_scratch_t *cur = (objc_scratch_t *)_first;
+  while (cur != NULL) {
+    NXLog(@"  chunk @%p size=%zu used=%zu free=%zu", cur,
+          objc_scratch_stats_size(cur), objc_scratch_stats_used(cur),
+          objc_scratch_stats_free(cur));
+    cur = objc_scratch_next(cur);
+  }
+  NXLog(@"Total size: %zu bytes, used: %zu bytes, free: %zu bytes",
+        [self bytesTotal], [self bytesUsed], [self bytesFree]);
+}
+
+- (size_t)bytesTotal {
+  size_t size = 0;
+  objc_scratch_t *cur = (objc_scratch_t *)_first;
+  while (cur != NULL) {
+    size += objc_scratch_stats_size(cur);
+    cur = objc_scratch_next(cur);
+  }
+  return size;
+}
+
+- (size_t)bytesUsed {
+  size_t used = 0;
+  objc_scratch_t *cur = (objc_scratch_t *)_first;
+  while (cur != NULL) {
+    used += objc_scratch_stats_used(cur);
+    cur = objc_scratch_next(cur);
+  }
+  return used;
+}
+
+- (size_t)bytesFree {
+  size_t free = 0;
+  objc_scratch_t *cur = (objc_scratch_t *)_first;
+  while (cur != NULL) {
+    free += objc_scratch_stats_free(cur);
+    cur = objc_scratch_next(cur);
+  }
+  return free;
+}
+
+@end
@@ -0,0 +1,57 @@
+/**
+ * @file NXString+Private.h
+ * @brief String class private header.
+ */
+#pragma once
+#include <Foundation/Foundation.h>
+
+/**
+ * @brief Category for private methods of the NXString class.
+ */
+@interface NXString (Private)
+
+/**
+ * @brief Initializes a string which takes ownership of a buffer.
+ * @param bytes A buffer allocated from the zone of the string, which is
+ * freed when the string is deallocated. The buffer must have space for a
+ * null terminator after the string.
+ * @param length The length of the string in bytes.
+ * @param capacity The size of the buffer in bytes.
+ *
+ * This is used by NXJSONWriter to return its output without copying it. A
+ * short string is copied into the string object and the buffer is freed.
+ */
+- (id)initWithBuffer:(char *)bytes
+              length:(size_t)length
+            capacity:(size_t)capacity;
+
+/**
+ * @brief Initializes a string with a copy of bytes.
+ * @param bytes The bytes of the string, which need not be null-terminated.
+ * @param length The length of the string in bytes.
+ *
+ * A short string is copied into the string object, and a longer string is
+ * copied into a buffer allocated from the zone of the string.
+ */
+- (id)initWithBytes:(const char *)bytes length:(size_t)length;
+
+/**
+ * @brief Initializes a string which references bytes without copying them.
+ * @param bytes The bytes of the string, which must be followed by a null
+ * terminator and must not be changed or freed while the string is in use.
+ * @param length The length of the string in bytes.
+ *
+ * This is used by NXJSON to return strings which reference the input.
+ */
+- (id)initWithBytesNoCopy:(const char *)bytes length:(size_t)length;
+
+@end
+
+/**
+ * @brief Returns YES if two strings have the same contents.
+ *
+ * This is used by NXMap to compare keys. Two NXString objects are compared
+ * by length and cached hash before their bytes, without sending messages.
+ */
+BOOL _nxstring_equals(id<NXConstantStringProtocol> string,
+                      id<NXConstantStringProtocol> other);
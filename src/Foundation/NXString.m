@@ -1,11 +1,140 @@
+#include "NXString+Private.h"
 #include "NXString+format.h"
 #include "NXString+unicode.h"
 #include <Foundation/Foundation.h>
 #include <runtime-sys/sys.h>
+#include <limits.h>
 #include <string.h>
 
 @implementation NXString
 
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE METHODS
+
+/*
+ * Return YES if two strings have the same contents. Two NXString objects are
+ * compared by length and cached hash before their bytes, without sending
+ * messages. Other strings are compared by their length and bytes.
+ */
+BOOL _nxstring_equals(id<NXConstantStringProtocol> string,
+                      id<NXConstantStringProtocol> other) {
+  static Class stringClass = Nil;
+  if (stringClass == Nil) {
+    stringClass = [NXString class];
+  }
+  if (string == other) {
+    return YES;
+  }
+  if (object_getClass((id)string) == stringClass &&
+      object_getClass((id)other) == stringClass) {
+    NXString *a = (NXString *)string;
+    NXString *b = (NXString *)other;
+    if (a->_length != b->_length) {
+      return NO;
+    }
+    if (a->_hash != 0 && b->_hash != 0 && a->_hash != b->_hash) {
+      return NO;
+    }
+    if (a->_length == 0 || a->_value == b->_value) {
+      return YES;
+    }
+    return sys_memcmp(a->_value, b->_value, a->_length) == 0;
+  }
+  if ([string length] != [other length]) {
+    return NO;
+  }
+  const char *str1 = [string cStr];
+  const char *str2 = [other cStr];
+  if (str1 == str2) {
+    return YES;
+  }
+  return strcmp(str1 ? str1 : "", str2 ? str2 : "") == 0;
+}
+
+/*
+ * Return a buffer for the string data with at least the capacity, which is
+ * updated with the size of the buffer. Short strings use the buffer in the
+ * string object, and longer strings are allocated from the zone.
+ */
+- (char *)_bufferWithCapacity:(size_t *)cap {
+  if (*cap <= NXSTRING_INLINE_SIZE) {
+    *cap = NXSTRING_INLINE_SIZE;
+    return _inline;
+  }
+  objc_assert(_zone);
+  objc_assert(*cap <= UINT_MAX);
+  return [_zone allocWithSize:*cap];
+}
+
+- (BOOL)_makeMutableWithCapacity:(size_t)cap {
+  // Every change to the string makes it mutable first, so the cached hash is
+  // discarded here
+  _hash = 0;
+
+  // Validate input - ensure capacity is at least current capacity or minimum
+  // required
+  size_t minRequired =
+      _length + 1; // Minimum for current string + null terminator
+  if (cap < minRequired) {
+    cap = minRequired;
+  }
+  if (cap < _cap) {
+    cap = _cap; // Don't reduce existing capacity
+  }
+
+  // Fast path: if allocated data is already present and capacity is sufficient
+  if (_data != NULL && _cap >= cap) {
+    return YES; // Already mutable with sufficient capacity
+  }
+
+  // If _data is NULL, let's make it mutable directly
+  if (_data == NULL) {
+    _data = [self _bufferWithCapacity:&cap];
+    if (_data == NULL) {
+      return NO; // Allocation failed, cannot make mutable
+    }
+
+    // Copy existing string content if any
+    if (_value != NULL && _length > 0) {
+      sys_memcpy(_data, _value, _length + 1);
+    } else {
+      sys_memset(_data, 0, cap); // Initialize allocated memory to zero
+    }
+    _value = _data; // Update _value to point to mutable data
+    _cap = (unsigned int)cap;
+    return YES; // Now _data is mutable
+  }
+
+  // If _data is not NULL but capacity is insufficient, grow the capacity by
+  // at least 1.5x so that repeated appends are amortized, and resize the data
+  // in place when there is free space after it
+  size_t grow = _cap + (_cap >> 1);
+  if (cap < grow) {
+    cap = grow;
+  }
+  char *data = NULL;
+  if (_data == _inline) {
+    // Move the data out of the string object
+    data = [_zone allocWithSize:cap];
+    if (data != NULL) {
+      sys_memcpy(data, _data, _length + 1);
+    }
+  } else {
+    data = [_zone reallocWithPtr:_data size:cap];
+  }
+  if (data == NULL) {
+    return NO; // Allocation failed, cannot make mutable
+  }
+
+  // Update pointers
+  _data = data;
+  _value = _data; // Ensure _value points to the mutable data
+  _cap = (unsigned int)cap;
+
+  // Return success
+  return YES;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // LIFECYCLE
 
@@ -19,6 +148,7 @@
     _data = NULL;
     _length = 0;
     _cap = 0;
+    _hash = 0;
   }
   return self;
 }
@@ -39,8 +169,7 @@
   }
 
   // Allocate memory for the string data
-  objc_assert(_zone);
-  _data = [_zone allocWithSize:capacity];
+  _data = [self _bufferWithCapacity:&capacity];
   if (_data == NULL) {
     [self release];
     return nil; // Allocation failed, return nil
@@ -50,12 +179,82 @@
   sys_memset(_data, 0, capacity); // Initialize allocated memory to zero
   _value = _data;                 // Set value to point to the allocated data
   _length = 0;                    // Initialize length to 0
-  _cap = capacity;
+  _cap = (unsigned int)capacity;
 
   // Return success
   return self;
 }
 
+/**
+ * @brief Initializes a string which takes ownership of a buffer from the
+ * zone of the string.
+ */
+- (id)initWithBuffer:(char *)bytes
+              length:(size_t)length
+            capacity:(size_t)capacity {
+  objc_assert(bytes);
+  objc_assert(length < capacity);
+  objc_assert(capacity <= UINT_MAX);
+  self = [self init];
+  if (self == nil) {
+    return nil;
+  }
+  if (length < NXSTRING_INLINE_SIZE) {
+    // Copy a short string into the string object
+    sys_memcpy(_inline, bytes, length);
+    [_zone free:bytes];
+    _data = _inline;
+    _cap = NXSTRING_INLINE_SIZE;
+  } else {
+    _data = bytes;
+    _cap = (unsigned int)capacity;
+  }
+  _data[length] = '\0';
+  _value = _data;
+  _length = (unsigned int)length;
+  return self;
+}
+
+/**
+ * @brief Initializes a string with a copy of bytes.
+ */
+- (id)initWithBytes:(const char *)bytes length:(size_t)length {
+  objc_assert(bytes || length == 0);
+  objc_assert(length < UINT_MAX);
+  self = [self init];
+  if (self == nil) {
+    return nil;
+  }
+  size_t cap = length + 1;
+  _data = [self _bufferWithCapacity:&cap];
+  if (_data == NULL) {
+    [self release];
+    return nil;
+  }
+  sys_memcpy(_data, bytes, length);
+  _data[length] = '\0';
+  _value = _data;
+  _length = (unsigned int)length;
+  _cap = (unsigned int)cap;
+  return self;
+}
+
+/**
+ * @brief Initializes a string which references null-terminated bytes
+ * without copying them.
+ */
+- (id)initWithBytesNoCopy:(const char *)bytes length:(size_t)length {
+  objc_assert(bytes);
+  objc_assert(bytes[length] == '\0');
+  objc_assert(length < UINT_MAX);
+  self = [self init];
+  if (self) {
+    _value = bytes;
+    _length = (unsigned int)length;
+  }
+  return self;
+}
+
 /**
  * @brief Initializes a new string by referencing another string.
  */
@@ -115,14 +314,14 @@
   _length = sys_vsprintf_ex(NULL, 0, cFormat, args, _nxstring_format_handler);
   if (_length > 0) {
     // Allocate memory for the string
-    objc_assert(_zone);
-    _data = [_zone allocWithSize:_length + 1];
+    size_t cap = _length + 1;
+    _data = [self _bufferWithCapacity:&cap];
     if (_data) {
       sys_vsprintf_ex(_data, _length + 1, cFormat, argsCopy,
                       _nxstring_format_handler); // Format the string into
                                                  // the allocated memory
-      _value = _data;     // Set the value to the allocated data
-      _cap = _length + 1; // Set capacity to length + null terminator
+      _value = _data;           // Set the value to the allocated data
+      _cap = (unsigned int)cap; // Set capacity to the size of the buffer
     } else {
       [self release];
       self = nil; // Allocation failed, set self to nil
@@ -181,73 +380,12 @@
  * @brief Releases the string's internal value.
  */
 - (void)dealloc {
-  if (_data) {
+  if (_data && _data != _inline) {
     [_zone free:_data]; // Free the allocated data
   }
   [super dealloc];
 }
 
-///////////////////////////////////////////////////////////////////////////////
-// PRIVATE METHODS
-
-- (BOOL)_makeMutableWithCapacity:(size_t)cap {
-  // Validate input - ensure capacity is at least current capacity or minimum
-  // required
-  size_t minRequired =
-      _length + 1; // Minimum for current string + null terminator
-  if (cap < minRequired) {
-    cap = minRequired;
-  }
-  if (cap < _cap) {
-    cap = _cap; // Don't reduce existing capacity
-  }
-
-  // Fast path: if allocated data is already present and capacity is sufficient
-  if (_data != NULL && _cap >= cap) {
-    return YES; // Already mutable with sufficient capacity
-  }
-
-  // If _data is NULL, let's make it mutable directly
-  if (_data == NULL) {
-    _data = [_zone allocWithSize:cap];
-    if (_data == NULL) {
-      return NO; // Allocation failed, cannot make mutable
-    }
-
-    // Copy existing string content if any
-    if (_value != NULL && _length > 0) {
-      sys_memcpy(_data, _value, _length + 1);
-    } else {
-      sys_memset(_data, 0, cap); // Initialize allocated memory to zero
-    }
-    _value = _data; // Update _value to point to mutable data
-    _cap = cap;
-    return YES; // Now _data is mutable
-  }
-
-  // If _data is not NULL but capacity is insufficient, reallocate
-  char *data = [_zone allocWithSize:cap];
-  if (data == NULL) {
-    return NO; // Allocation failed, cannot make mutable
-  }
-
-  // Copy existing data
-  if (_length > 0) {
-    sys_memcpy(data, _data, _length + 1);
-  } else {
-    sys_memset(data, 0, cap); // Initialize allocated memory to zero
-  }
-
-  // Free old data and update pointers
-  [_zone free:_data];
-  _data = data;
-  _value = _data; // Ensure _value points to the mutable data
-  _cap = cap;
-
-  // Return success
-  return YES;
-}
-
 ///////////////////////////////////////////////////////////////////////////////
 // PUBLIC METHODS
 
@@ -292,6 +430,18 @@
   return self;
 }
 
+/**
+ * @brief Returns a hash of the string content, which is cached until the
+ * string is changed.
+ */
+- (uintptr_t)hash {
+  if (_hash == 0) {
+    // The hash is truncated to 32 bits, the same as NXConstantString
+    _hash = (uint32_t)sys_hash_djb2(_value ? _value : "");
+  }
+  return _hash;
+}
+
 /**
  * @brief Checks if the string is equal to another object.
  */
@@ -299,11 +449,23 @@
   if (self == other) {
     return YES;
   }
-  if (other == nil ||
-      [other conformsTo:@protocol(NXConstantStringProtocol)] == NO) {
+  if (other == nil) {
     return NO;
   }
-  if ([other length] != _length) {
+
+  // Another NXString is compared without checking its protocols, and
+  // strings with different cached hashes are not equal
+  if ([other isKindOfClass:[NXString class]]) {
+    NXString *string = (NXString *)other;
+    if (_length != string->_length) {
+      return NO;
+    }
+    if (_hash != 0 && string->_hash != 0 && _hash != string->_hash) {
+      return NO;
+    }
+  } else if ([other conformsTo:@protocol(NXConstantStringProtocol)] == NO) {
+    return NO;
+  } else if ([other length] != _length) {
     return NO;
   }
   const char *otherCStr = [other cStr];
@@ -675,62 +837,15 @@
  * according to JSON string escaping rules.
  */
 - (NXString *)JSONString {
-  // Handle NULL/empty string case
-  if (_value == NULL || _length == 0) {
-    return [NXString stringWithCString:"\"\""];
-  }
-
-  // Create a new mutable string with enough capacity for the quoted string
-  // Estimate: original length + quotes + potential escaping (conservative
-  // estimate)
-  size_t capacity = _length * 2 + 8; // More conservative capacity estimation
-  NXString *quotedString = [[NXString alloc] initWithCapacity:capacity];
-  if (quotedString == nil) {
-    return nil; // Allocation failed, return nil
-  }
-
-  // Start with opening quote
-  [quotedString appendCString:"\""];
-
-  // Append the original string, escaping special characters as needed
-  size_t i;
-  for (i = 0; i < _length; i++) {
-    char c = _value[i];
-    switch (c) {
-    case '"':
-      [quotedString appendCString:"\\\""];
-      break;
-    case '\\':
-      [quotedString appendCString:"\\\\"]; // Escape backslash
-      break;
-    case '\b':
-      [quotedString appendCString:"\\b"];
-      break;
-    case '\f':
-      [quotedString appendCString:"\\f"];
-      break;
-    case '\n':
-      [quotedString appendCString:"\\n"];
-      break;
-    case '\r':
-      [quotedString appendCString:"\\r"];
-      break;
-    case '\t':
-      [quotedString appendCString:"\\t"];
-      break;
-    default:
-      if (c < ' ') { // Control characters
-        [quotedString appendStringWithFormat:@"\\u%04X", (unsigned char)c];
-      } else {
-        [quotedString appendStringWithFormat:@"%c", c];
-      }
-    }
-  }
-
-  // End with closing quote
-  [quotedString appendCString:"\""];
+  return [NXJSONWriter stringWithObject:self];
+}
 
-  return [quotedString autorelease]; // Return the quoted string
+/**
+ * @brief Writes the string enclosed in double quotes, with special
+ * characters escaped according to JSON string escaping rules.
+ */
+- (BOOL)writeJSON:(NXJSONWriter *)writer {
+  return [writer writeQuotedBytes:[self cStr] length:[self length]];
 }
 
 /**
@@ -0,0 +1,34 @@
+/**
+ * @file NXZone+Private.h
+ * @brief Zone class private header.
+ */
+#pragma once
+#include <Foundation/Foundation.h>
+
+/**
+ * @brief Category for private methods of the NXZone class.
+ */
+@interface NXZone (Private)
+
+/**
+ * @brief Records the class of an object allocated from the zone.
+ *
+ * This is called by +[NXObject allocWithZone:] once the class of a new
+ * object is set, so that the allocation statistics are kept by class. It
+ * does nothing unless Foundation is built with NXZONE_PROFILE.
+ */
+- (void)profileObject:(id)object;
+
+/**
+ * @brief Gets the live allocations in the zone for a class.
+ * @param cls The class, or Nil for memory which is not an object.
+ * @param count Set to the number of live allocations, if not NULL.
+ * @param bytes Set to the bytes in live allocations, if not NULL.
+ * @return YES if the zone keeps allocation statistics, NO otherwise.
+ *
+ * The bytes are the sizes which were requested, without the header kept
+ * for each allocation. This is used by the tests of the statistics.
+ */
+- (BOOL)profileClass:(Class)cls count:(size_t *)count bytes:(size_t *)bytes;
+
+@end
@@ -5,34 +5,160 @@
 #include <stdint.h>
 
 ///////////////////////////////////////////////////////////////////////////////
-// DECLARATIONS
+// DEFINITIONS
 
-static void *objc_arena_find_free_space(struct objc_arena *arena, size_t size);
-static BOOL objc_arena_check_collision(struct objc_arena *arena, void *start,
-                                       size_t total_size);
+/**
+ * @brief Alignment of allocations, and of the size of each block.
+ */
+#define OBJC_ARENA_ALIGN sizeof(void *)
+
+/**
+ * @brief Flag set in the size of a block which is allocated.
+ */
+#define OBJC_ARENA_USED ((size_t)1)
 
 ///////////////////////////////////////////////////////////////////////////////
 // TYPES
 
 /**
  * @brief Represents an arena for memory allocation.
+ *
+ * The arena is followed by its blocks, which are laid out end to end. Free
+ * blocks are also linked into a list, so allocations do not need to walk
+ * the blocks which are in use.
  */
 struct objc_arena {
-  struct objc_arena *next;
-  size_t size;
-  struct objc_arena_alloc *head; // First allocation
-  struct objc_arena_alloc *tail; // Last allocation
+  struct objc_arena *next;            // Next arena in the chain
+  size_t size;                        // Size of the blocks, in bytes
+  size_t used;                        // Size of the allocated blocks
+  struct objc_arena_free_block *free; // First free block
 };
 
 /**
  * @brief Represents an allocation in an arena
+ *
+ * Each block starts with this header, which records the size of the block
+ * and of the block before it, so that neighbouring free blocks can be merged.
+ * The owning arena comes last, immediately before the user data, so an
+ * allocation can be freed without searching for it.
  */
 struct objc_arena_alloc {
-  struct objc_arena_alloc *next;
-  size_t size;
-  void *ptr;
+  size_t size;              // Size of the block including the header
+  size_t prev_size;         // Size of the previous block, or zero if first
+  struct objc_arena *arena; // Arena which owns the block
+};
+
+/**
+ * @brief Represents a free block in an arena
+ */
+struct objc_arena_free_block {
+  struct objc_arena_alloc header;
+  struct objc_arena_free_block *prev; // Previous free block
+  struct objc_arena_free_block *next; // Next free block
 };
 
+/**
+ * @brief Smallest block, which needs to have space for the free list links.
+ */
+#define OBJC_ARENA_MIN_BLOCK sizeof(struct objc_arena_free_block)
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE METHODS
+
+/**
+ * @brief Round a size up to the allocation alignment.
+ */
+static inline size_t objc_arena_align(size_t size) {
+  return (size + OBJC_ARENA_ALIGN - 1) & ~(OBJC_ARENA_ALIGN - 1);
+}
+
+/**
+ * @brief Return the size of a block, without the allocated flag.
+ */
+static inline size_t objc_arena_block_size(struct objc_arena_alloc *block) {
+  return block->size & ~OBJC_ARENA_USED;
+}
+
+/**
+ * @brief Return the first block in an arena.
+ */
+static inline struct objc_arena_alloc *
+objc_arena_first(struct objc_arena *arena) {
+  return (struct objc_arena_alloc *)(arena + 1);
+}
+
+/**
+ * @brief Return the block after a block, or NULL if it is the last block.
+ */
+static inline struct objc_arena_alloc *
+objc_arena_block_next(struct objc_arena *arena, struct objc_arena_alloc *block) {
+  uintptr_t next = (uintptr_t)block + objc_arena_block_size(block);
+  uintptr_t end = (uintptr_t)objc_arena_first(arena) + arena->size;
+  return next < end ? (struct objc_arena_alloc *)next : NULL;
+}
+
+/**
+ * @brief Add a free block to the head of the free list.
+ */
+static inline void objc_arena_link(struct objc_arena *arena,
+                                   struct objc_arena_free_block *block) {
+  block->prev = NULL;
+  block->next = arena->free;
+  if (arena->free != NULL) {
+    arena->free->prev = block;
+  }
+  arena->free = block;
+}
+
+/**
+ * @brief Remove a free block from the free list.
+ */
+static inline void objc_arena_unlink(struct objc_arena *arena,
+                                     struct objc_arena_free_block *block) {
+  if (block->prev != NULL) {
+    block->prev->next = block->next;
+  } else {
+    arena->free = block->next;
+  }
+  if (block->next != NULL) {
+    block->next->prev = block->prev;
+  }
+}
+
+/**
+ * @brief Make a block free, merge it with free neighbours and add it to the
+ * free list.
+ */
+static void objc_arena_release(struct objc_arena *arena,
+                               struct objc_arena_alloc *block, size_t size) {
+  // Merge with the following block
+  struct objc_arena_alloc *next = objc_arena_block_next(arena, block);
+  if (next != NULL && (next->size & OBJC_ARENA_USED) == 0) {
+    objc_arena_unlink(arena, (struct objc_arena_free_block *)next);
+    size += next->size;
+  }
+
+  // Merge with the preceding block
+  if (block->prev_size != 0) {
+    struct objc_arena_alloc *prev =
+        (struct objc_arena_alloc *)((uintptr_t)block - block->prev_size);
+    if ((prev->size & OBJC_ARENA_USED) == 0) {
+      objc_arena_unlink(arena, (struct objc_arena_free_block *)prev);
+      size += prev->size;
+      block = prev;
+    }
+  }
+
+  // Add the merged block to the free list
+  block->size = size;
+  block->arena = arena;
+  next = objc_arena_block_next(arena, block);
+  if (next != NULL) {
+    next->prev_size = size;
+  }
+  objc_arena_link(arena, (struct objc_arena_free_block *)block);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // LIFECYCLE
 
@@ -48,6 +174,13 @@ objc_arena_t *objc_arena_new(objc_arena_t *root, size_t size) {
     prev = prev->next;
   }
 
+  // The arena holds at least one block, and the size of the blocks is a
+  // multiple of the alignment
+  size = objc_arena_align(size);
+  if (size < OBJC_ARENA_MIN_BLOCK) {
+    size = OBJC_ARENA_MIN_BLOCK;
+  }
+
   size_t total_size = sizeof(struct objc_arena) + size;
   objc_arena_t *arena = __zone_malloc(total_size);
   if (arena) {
@@ -56,12 +189,26 @@ objc_arena_t *objc_arena_new(objc_arena_t *root, size_t size) {
     }
     arena->next = NULL;
     arena->size = size;
-    arena->head = NULL;
-    arena->tail = NULL;
+    arena->used = 0;
+    arena->free = NULL;
+
+    // The arena starts as one free block
+    struct objc_arena_alloc *block = objc_arena_first(arena);
+    block->size = size;
+    block->prev_size = 0;
+    block->arena = arena;
+    objc_arena_link(arena, (struct objc_arena_free_block *)block);
   }
   return arena;
 }
 
+/**
+ * @brief Return the arena size needed to hold an allocation.
+ */
+size_t objc_arena_size_for(size_t size) {
+  return sizeof(struct objc_arena_alloc) + objc_arena_align(size);
+}
+
 /**
  * @brief Free all arenas
  */
@@ -84,35 +231,63 @@ void *objc_arena_alloc_inner(objc_arena_t *arena, size_t size) {
   objc_assert(arena);
   objc_assert(size > 0);
 
-  // Find available space for this allocation
-  void *free_location = objc_arena_find_free_space(arena, size);
-  if (free_location == NULL) {
-    return NULL; // No space available
+  size_t needed = objc_arena_size_for(size);
+  if (needed < OBJC_ARENA_MIN_BLOCK) {
+    needed = OBJC_ARENA_MIN_BLOCK;
   }
 
-  // Create the allocation header at the found location
-  struct objc_arena_alloc *new_alloc = (struct objc_arena_alloc *)free_location;
-  new_alloc->size = size;
-  new_alloc->ptr = (void *)(new_alloc + 1);
-  new_alloc->next = NULL;
-
-  // Add to the linked list
-  if (!arena->head) {
-    // First allocation
-    arena->head = new_alloc;
-    arena->tail = new_alloc;
-  } else {
-    // Append to the end
-    arena->tail->next = new_alloc;
-    arena->tail = new_alloc;
+  // Find the first free block which is large enough
+  struct objc_arena_free_block *free = arena->free;
+  while (free != NULL && free->header.size < needed) {
+    free = free->next;
+  }
+  if (free == NULL) {
+    return NULL; // No space available
+  }
+  objc_arena_unlink(arena, free);
+
+  // Split the block if the remainder is large enough to be a block
+  struct objc_arena_alloc *block = &free->header;
+  size_t remainder = block->size - needed;
+  if (remainder >= OBJC_ARENA_MIN_BLOCK) {
+    struct objc_arena_alloc *rest =
+        (struct objc_arena_alloc *)((uintptr_t)block + needed);
+    rest->size = remainder;
+    rest->prev_size = needed;
+    rest->arena = arena;
+    struct objc_arena_alloc *next = objc_arena_block_next(arena, rest);
+    if (next != NULL) {
+      next->prev_size = remainder;
+    }
+    objc_arena_link(arena, (struct objc_arena_free_block *)rest);
+    block->size = needed;
   }
 
+  // Mark the block as allocated
+  arena->used += block->size;
+  block->size |= OBJC_ARENA_USED;
+
   // Return the pointer to the allocated memory
-  return new_alloc->ptr;
+  return block + 1;
 }
 
 /**
- * @brief Deallocate memory from an arena by removing it from the linked list.
+ * @brief Allocate memory from the first arena in a chain with free space.
+ */
+void *objc_arena_alloc(objc_arena_t *arena, size_t size) {
+  objc_assert(arena);
+  while (arena != NULL) {
+    void *ptr = objc_arena_alloc_inner(arena, size);
+    if (ptr != NULL) {
+      return ptr;
+    }
+    arena = arena->next; // Move to the next arena
+  }
+  return NULL; // No space in any arena
+}
+
+/**
+ * @brief Deallocate memory from an arena.
  */
 BOOL objc_arena_free_inner(objc_arena_t *arena, void *ptr) {
   objc_assert(arena);
@@ -122,35 +297,22 @@ BOOL objc_arena_free_inner(objc_arena_t *arena, void *ptr) {
     return NO;
   }
 
-  // Find the allocation to free by traversing the chain
-  struct objc_arena_alloc *current = arena->head;
-  struct objc_arena_alloc *prev = NULL;
-
-  while (current) {
-    if (current->ptr == ptr) {
-      // Remove from linked list
-      if (prev) {
-        prev->next = current->next;
-      } else {
-        // This was the head
-        arena->head = current->next;
-      }
-
-      // Update tail if this was the last allocation
-      if (current == arena->tail) {
-        arena->tail = prev;
-      }
-
-      // The allocation block becomes free space (gap in the list)
-      return YES;
-    }
-
-    prev = current;
-    current = current->next;
+  // The header is immediately before the pointer, and must be an allocated
+  // block in this arena
+  struct objc_arena_alloc *block = (struct objc_arena_alloc *)ptr - 1;
+  if (block->arena != arena || (block->size & OBJC_ARENA_USED) == 0) {
+    return NO;
+  }
+  uintptr_t start = (uintptr_t)objc_arena_first(arena);
+  if ((uintptr_t)block < start || (uintptr_t)block >= start + arena->size) {
+    return NO;
   }
 
-  // Allocation not found
-  return NO;
+  // The allocation block becomes free space, merged with its neighbours
+  size_t size = objc_arena_block_size(block);
+  arena->used -= size;
+  objc_arena_release(arena, block, size);
+  return YES;
 }
 
 /**
@@ -161,14 +323,72 @@ BOOL objc_arena_free(objc_arena_t *arena, void *ptr) {
   if (ptr == NULL) {
     return NO; // Nothing to free
   }
-  while (arena != NULL) {
-    // Try to free in the current arena
-    if (objc_arena_free_inner(arena, ptr)) {
-      return YES; // Successfully freed
+
+  // The owning arena is recorded in the header
+  struct objc_arena_alloc *block = (struct objc_arena_alloc *)ptr - 1;
+  if (block->arena == NULL) {
+    return NO; // Not allocated from an arena
+  }
+  return objc_arena_free_inner(block->arena, ptr);
+}
+
+/**
+ * @brief Resize an allocation in place.
+ */
+BOOL objc_arena_resize(void *ptr, size_t size) {
+  objc_assert(ptr);
+  objc_assert(size > 0);
+
+  struct objc_arena_alloc *block = (struct objc_arena_alloc *)ptr - 1;
+  struct objc_arena *arena = block->arena;
+  objc_assert(arena);
+  objc_assert(block->size & OBJC_ARENA_USED);
+
+  size_t needed = objc_arena_size_for(size);
+  if (needed < OBJC_ARENA_MIN_BLOCK) {
+    needed = OBJC_ARENA_MIN_BLOCK;
+  }
+  size_t current = objc_arena_block_size(block);
+
+  // Grow the block by merging the following block, if it is free and large
+  // enough
+  if (needed > current) {
+    struct objc_arena_alloc *next = objc_arena_block_next(arena, block);
+    if (next == NULL || (next->size & OBJC_ARENA_USED) != 0 ||
+        current + next->size < needed) {
+      return NO;
+    }
+    objc_arena_unlink(arena, (struct objc_arena_free_block *)next);
+    arena->used += next->size;
+    current += next->size;
+    block->size = current | OBJC_ARENA_USED;
+    next = objc_arena_block_next(arena, block);
+    if (next != NULL) {
+      next->prev_size = current;
     }
-    arena = arena->next; // Move to the next arena
   }
-  return NO; // Pointer not found in any arena
+
+  // Release the end of the block if it is large enough to be a block
+  size_t remainder = current - needed;
+  if (remainder >= OBJC_ARENA_MIN_BLOCK) {
+    struct objc_arena_alloc *rest =
+        (struct objc_arena_alloc *)((uintptr_t)block + needed);
+    block->size = needed | OBJC_ARENA_USED;
+    rest->size = remainder;
+    rest->prev_size = needed;
+    arena->used -= remainder;
+    objc_arena_release(arena, rest, remainder);
+  }
+  return YES;
+}
+
+/**
+ * @brief Return the usable size of memory allocated from an arena.
+ */
+size_t objc_arena_ptr_size(void *ptr) {
+  objc_assert(ptr);
+  struct objc_arena_alloc *block = (struct objc_arena_alloc *)ptr - 1;
+  return objc_arena_block_size(block) - sizeof(struct objc_arena_alloc);
 }
 
 /**
@@ -178,18 +398,17 @@ void objc_arena_walk_inner(objc_arena_t *arena, objc_arena_alloc_t **alloc) {
   objc_assert(arena);
   objc_assert(alloc);
 
-  // Start from the head of the arena
-  if (arena->head == NULL) {
-    *alloc = NULL; // No allocations to walk
-    return;
-  }
+  // If alloc is NULL, start from the first block, otherwise the block after
+  // the previous allocation
+  struct objc_arena_alloc *block = *alloc == NULL
+                                       ? objc_arena_first(arena)
+                                       : objc_arena_block_next(arena, *alloc);
 
-  // If alloc is NULL, return the first allocation
-  if (*alloc == NULL) {
-    *alloc = arena->head;
-  } else {
-    *alloc = (*alloc)->next;
+  // Skip free blocks
+  while (block != NULL && (block->size & OBJC_ARENA_USED) == 0) {
+    block = objc_arena_block_next(arena, block);
   }
+  *alloc = block;
 }
 
 /**
@@ -205,9 +424,9 @@ size_t objc_arena_alloc_size(objc_arena_alloc_t *alloc, void **ptr) {
   }
   // Get the size from the allocation structure
   if (ptr != NULL) {
-    *ptr = alloc->ptr;
+    *ptr = alloc + 1;
   }
-  return alloc->size;
+  return objc_arena_block_size(alloc) - sizeof(struct objc_arena_alloc);
 }
 
 objc_arena_t *objc_arena_next(objc_arena_t *arena) {
@@ -229,16 +448,7 @@ size_t objc_arena_stats_size(objc_arena_t *arena) {
  */
 size_t objc_arena_stats_used(objc_arena_t *arena) {
   objc_assert(arena);
-
-  // Calculate used space by walking through active allocations
-  size_t used = 0;
-  struct objc_arena_alloc *current = arena->head;
-  while (current) {
-    used += sizeof(struct objc_arena_alloc) + current->size;
-    current = current->next;
-  }
-
-  return used;
+  return arena->used; // Allocated blocks, including their headers
 }
 
 /**
@@ -248,70 +458,5 @@ size_t objc_arena_stats_free(objc_arena_t *arena) {
   objc_assert(arena);
 
   // Return remaining space, accounting for potential fragmentation
-  size_t used = objc_arena_stats_used(arena);
-  return (arena->size > used) ? (arena->size - used) : 0;
-}
-
-///////////////////////////////////////////////////////////////////////////////
-// PRIVATE METHODS
-
-/**
- * @brief Find free space in the arena that can accommodate the requested size.
- */
-static void *objc_arena_find_free_space(struct objc_arena *arena, size_t size) {
-  objc_assert(arena);
-  objc_assert(size > 0);
-
-  uintptr_t arena_start = (uintptr_t)(arena + 1);
-  uintptr_t arena_end = arena_start + arena->size;
-  size_t needed = sizeof(struct objc_arena_alloc) + size;
-  size_t alignment = sizeof(void *); // Pointer alignment
-
-  // Start from the end and work backwards
-  uintptr_t search_end = arena_end - needed;
-  uintptr_t aligned_search_end = (search_end / alignment) * alignment;
-
-  for (intptr_t pos = (intptr_t)aligned_search_end;
-       pos >= (intptr_t)arena_start; pos -= (intptr_t)alignment) {
-
-    // Check if this position would collide with any existing allocation
-    if (objc_arena_check_collision(arena, (void *)pos, needed) == NO) {
-      // Return suitable space
-      return (void *)pos;
-    }
-  }
-
-  return NULL; // No suitable space found
-}
-
-/**
- * @brief Check if a memory range collides with any existing allocation.
- */
-static BOOL objc_arena_check_collision(struct objc_arena *arena, void *start,
-                                       size_t total_size) {
-  objc_assert(arena);
-
-  // No allocations, no collision
-  if (arena->head == NULL) {
-    return NO;
-  }
-
-  struct objc_arena_alloc *current = arena->head;
-  uintptr_t range_start = (uintptr_t)start;
-  uintptr_t range_end = range_start + total_size;
-
-  while (current) {
-    uintptr_t alloc_start = (uintptr_t)current;
-    uintptr_t alloc_end =
-        alloc_start + sizeof(struct objc_arena_alloc) + current->size;
-
-    // Check if ranges overlap
-    if (range_start < alloc_end && range_end > alloc_start) {
-      return YES; // Collision detected
-    }
-
-    current = current->next;
-  }
-
-  return NO; // No collision
+  return (arena->size > arena->used) ? (arena->size - arena->used) : 0;
 }
@@ -20,6 +20,14 @@ typedef struct objc_arena_alloc objc_arena_alloc_t;
  */
 objc_arena_t *objc_arena_new(objc_arena_t *prev, size_t size);
 
+/**
+ * @brief Return the arena size needed to hold an allocation.
+ * @param size Size of the allocation in bytes.
+ * @return The size of an arena, as passed to objc_arena_new(), which has
+ * space for an allocation of this size.
+ */
+size_t objc_arena_size_for(size_t size);
+
 /**
  * @brief Free all arenas
  * @param arena Pointer to the first arena to free.
@@ -69,26 +77,39 @@ size_t objc_arena_stats_free(objc_arena_t *arena);
  * @param size Size of the memory to allocate in bytes.
  * @return Pointer to the allocated memory, or NULL if allocation fails.
  *
- * This function searches the arena for a free block of memory that can
- * accommodate the requested size. If no suitable block is found, it returns
- * NULL.
+ * This function searches the free list of the arena for the first free
+ * block that can accommodate the requested size, and splits off any space
+ * which is left over. If no suitable block is found, it returns NULL.
  *
  * @note It does not search other linked arenas.
  */
 void *objc_arena_alloc_inner(objc_arena_t *arena, size_t size);
 
 /**
- * @brief Deallocate memory from an arena by removing it from the linked list.
+ * @brief Allocate memory from a chain of arenas.
+ * @param arena Pointer to the first arena in the chain to search.
+ * @param size Size of the memory to allocate in bytes.
+ * @return Pointer to the allocated memory, or NULL if no arena in the chain
+ * has space for the allocation.
+ *
+ * This function tries each arena in the chain in turn, so that space freed
+ * in earlier arenas is reused.
+ */
+void *objc_arena_alloc(objc_arena_t *arena, size_t size);
+
+/**
+ * @brief Deallocate memory from an arena.
  * @param arena Pointer to the arena from which to free memory.
  * @param ptr Pointer to the memory to free.
- * @return TRUE if the memory was successfully freed, FALSE if the pointer was
- *         not found in the arena.
+ * @return TRUE if the memory was successfully freed, FALSE if the pointer is
+ *         not an allocation in the arena.
  *
- * This function searches the linked list of allocations in the arena for the
- * specified pointer. If found, it removes the allocation from the list and
- * returns TRUE. If the pointer is not found, it returns FALSE.
+ * This function reads the allocation header immediately before the pointer,
+ * in constant time. The block is merged with any free blocks on either side
+ * of it, so that the arena does not fragment as memory is allocated and
+ * freed.
  *
- * @note It does not search other linked arenas.
+ * @note It does not free memory in other linked arenas.
  */
 BOOL objc_arena_free_inner(objc_arena_t *arena, void *ptr);
 
@@ -99,23 +120,43 @@ BOOL objc_arena_free_inner(objc_arena_t *arena, void *ptr);
  * @return YES if the memory was successfully freed, NO if the pointer was
  *         not found in any arena in the chain.
  *
- *  This function searches through a linked chain of arenas to find
- *  and deallocate the specified memory pointer. It will traverse
- *  all linked arenas until the pointer is found and freed.
+ * The allocation header records the arena which owns the memory, so the
+ * chain is not searched.
  */
 BOOL objc_arena_free(objc_arena_t *arena, void *ptr);
 
+/**
+ * @brief Resize an allocation in place.
+ * @param ptr Pointer to memory allocated from an arena.
+ * @param size The new size of the allocation in bytes.
+ * @return YES if the allocation now holds the new size, NO if there is not
+ *         enough free space after it.
+ *
+ * A smaller allocation releases the end of its block when it is large enough
+ * to be a block. A larger allocation merges the free block which follows
+ * it, and releases the part of that block which it does not need. The
+ * allocation is not moved, and is unchanged when NO is returned.
+ */
+BOOL objc_arena_resize(void *ptr, size_t size);
+
+/**
+ * @brief Return the usable size of memory allocated from an arena.
+ * @param ptr Pointer to memory allocated from an arena.
+ * @return The number of bytes which can be used, which is at least the size
+ *         which was allocated.
+ */
+size_t objc_arena_ptr_size(void *ptr);
+
 /**
  * @brief Walk through an arena and perform an action on each allocation.
  * @param arena Pointer to the arena to walk through
  * @param alloc Pointer to a pointer that will be updated with the next
  * allocation
  *
- * This function iterates through the linked list of allocations in the arena,
- * calling the provided action on each allocation. The action can modify the
- * allocation or perform any other operation. The `alloc` pointer is updated
- * to point to the next allocation in the list. If there are no more
- * allocations, `alloc` will be set to NULL.
+ * This function iterates through the blocks in the arena in address order,
+ * skipping free blocks. The `alloc` pointer is updated to point to the next
+ * allocation, starting with the first allocation when it is NULL. If there
+ * are no more allocations, `alloc` will be set to NULL.
  */
 void objc_arena_walk_inner(objc_arena_t *arena, objc_arena_alloc_t **alloc);
 
@@ -126,6 +167,7 @@ void objc_arena_walk_inner(objc_arena_t *arena, objc_arena_alloc_t **alloc);
  * pointer, if not NULL.
  * @return The size of the allocation in bytes.
  *
- * This function returns the size of the specified allocation.
+ * This function returns the size of the specified allocation, which is the
+ * requested size rounded up to the allocation alignment.
  */
 size_t objc_arena_alloc_size(objc_arena_alloc_t *alloc, void **ptr);
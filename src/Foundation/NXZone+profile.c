@@ -0,0 +1,339 @@
+#include "NXZone+profile.h"
+#include <objc/objc.h>
+#include <runtime-sys/sys.h>
+#include <stdint.h>
+
+///////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS
+
+/**
+ * @brief Number of classes counted for each zone, which should be a power
+ * of 2. Classes which do not fit in the table are counted together.
+ */
+#ifdef SYSTEM_NAME_PICO
+#define OBJC_ZONE_PROFILE_SIZE 64
+#else
+#define OBJC_ZONE_PROFILE_SIZE 512
+#endif
+
+/**
+ * @brief Width of the bars in the histogram.
+ */
+#define OBJC_ZONE_PROFILE_BAR 20
+
+///////////////////////////////////////////////////////////////////////////////
+// TYPES
+
+/**
+ * @brief Statistics for allocations of one class.
+ */
+struct objc_zone_profile_entry {
+  Class cls;         // Class, or Nil for the entries which are not a class
+  size_t count;      // Number of live allocations
+  size_t bytes;      // Bytes in live allocations
+  size_t peak_count; // Highest number of live allocations
+  size_t peak_bytes; // Highest bytes in live allocations
+  size_t allocs;     // Number of allocations since the last reset
+};
+
+/**
+ * @brief Header before each allocation.
+ */
+struct objc_zone_profile_header {
+  struct objc_zone_profile_entry *entry; // Statistics for the allocation
+  size_t size;                           // Size of the allocation
+};
+
+/**
+ * @brief Allocation statistics for a zone.
+ */
+struct objc_zone_profile {
+  sys_mutex_t lock;                     // Protects the statistics
+  uint64_t start;                       // Timestamp of the last reset
+  struct objc_zone_profile_entry total; // All allocations
+  struct objc_zone_profile_entry raw;   // Allocations which are not objects
+  struct objc_zone_profile_entry other; // Classes not in the table
+  struct objc_zone_profile_entry entries[OBJC_ZONE_PROFILE_SIZE];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE METHODS
+
+/**
+ * @brief Return the entry for a class, adding it if necessary, or NULL if it
+ * is not in the table and add is false. Must be called with the lock held.
+ */
+static struct objc_zone_profile_entry *
+objc_zone_profile_entry(objc_zone_profile_t *profile, Class cls, bool add) {
+  uintptr_t hash = (uintptr_t)cls;
+  hash ^= hash >> 11;
+  uint32_t start = (uint32_t)hash & (OBJC_ZONE_PROFILE_SIZE - 1);
+  uint32_t idx = start;
+  do {
+    struct objc_zone_profile_entry *entry = &profile->entries[idx];
+    if (entry->cls == cls) {
+      return entry;
+    }
+    if (entry->cls == Nil) {
+      if (add == false) {
+        return NULL;
+      }
+      entry->cls = cls;
+      return entry;
+    }
+    idx = (idx + 1) & (OBJC_ZONE_PROFILE_SIZE - 1);
+  } while (idx != start);
+  return add ? &profile->other : NULL;
+}
+
+/**
+ * @brief Add or remove an allocation from an entry, and update the
+ * high-water marks.
+ */
+static inline void objc_zone_profile_add(struct objc_zone_profile_entry *entry,
+                                         size_t size) {
+  entry->count++;
+  entry->bytes += size;
+  if (entry->count > entry->peak_count) {
+    entry->peak_count = entry->count;
+  }
+  if (entry->bytes > entry->peak_bytes) {
+    entry->peak_bytes = entry->bytes;
+  }
+}
+
+static inline void
+objc_zone_profile_remove(struct objc_zone_profile_entry *entry, size_t size) {
+  entry->count--;
+  entry->bytes -= size;
+}
+
+/**
+ * @brief Print an entry, with a bar scaled against the largest entry.
+ */
+static void objc_zone_profile_print(struct objc_zone_profile_entry *entry,
+                                    const char *name, size_t max) {
+  char bar[OBJC_ZONE_PROFILE_BAR + 1];
+  size_t width =
+      max == 0 ? 0 : (entry->bytes * OBJC_ZONE_PROFILE_BAR + max - 1) / max;
+  for (size_t i = 0; i < OBJC_ZONE_PROFILE_BAR; i++) {
+    bar[i] = i < width ? '#' : ' ';
+  }
+  bar[OBJC_ZONE_PROFILE_BAR] = '\0';
+  sys_printf("%10zu %8zu %10zu %8zu %8zu %s %s\n", entry->bytes, entry->count,
+             entry->peak_bytes, entry->peak_count, entry->allocs, bar, name);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// LIFECYCLE
+
+/**
+ * @brief Create the allocation statistics for a zone.
+ */
+objc_zone_profile_t *objc_zone_profile_new(void) {
+  objc_zone_profile_t *profile = sys_malloc(sizeof(objc_zone_profile_t));
+  if (profile == NULL) {
+    return NULL;
+  }
+  sys_memset(profile, 0, sizeof(objc_zone_profile_t));
+  profile->lock = sys_mutex_init();
+  profile->start = sys_date_get_timestamp();
+  return profile;
+}
+
+/**
+ * @brief Free the allocation statistics for a zone.
+ */
+void objc_zone_profile_delete(objc_zone_profile_t *profile) {
+  objc_assert(profile);
+  sys_mutex_finalize(&profile->lock);
+  sys_free(profile);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PUBLIC METHODS
+
+/**
+ * @brief Count an allocation.
+ */
+void *objc_zone_profile_alloc(objc_zone_profile_t *profile, void *block,
+                              size_t size) {
+  objc_assert(profile);
+  if (block == NULL) {
+    return NULL;
+  }
+  struct objc_zone_profile_header *header = block;
+  header->entry = &profile->raw;
+  header->size = size;
+
+  sys_mutex_lock(&profile->lock);
+  objc_zone_profile_add(&profile->total, size);
+  objc_zone_profile_add(&profile->raw, size);
+  profile->total.allocs++;
+  profile->raw.allocs++;
+  sys_mutex_unlock(&profile->lock);
+  return (uint8_t *)block + OBJC_ZONE_PROFILE_HEADER;
+}
+
+/**
+ * @brief Set the class of an allocation which is an object.
+ */
+void objc_zone_profile_set_class(objc_zone_profile_t *profile, void *ptr,
+                                 Class cls) {
+  objc_assert(profile);
+  objc_assert(ptr);
+  struct objc_zone_profile_header *header =
+      (struct objc_zone_profile_header *)((uint8_t *)ptr -
+                                          OBJC_ZONE_PROFILE_HEADER);
+  sys_mutex_lock(&profile->lock);
+  struct objc_zone_profile_entry *entry =
+      objc_zone_profile_entry(profile, cls, true);
+  objc_zone_profile_remove(header->entry, header->size);
+  if (header->entry->allocs > 0) {
+    header->entry->allocs--;
+  }
+  objc_zone_profile_add(entry, header->size);
+  entry->allocs++;
+  header->entry = entry;
+  sys_mutex_unlock(&profile->lock);
+}
+
+/**
+ * @brief Count a free.
+ */
+void *objc_zone_profile_free(objc_zone_profile_t *profile, void *ptr) {
+  objc_assert(profile);
+  objc_assert(ptr);
+  struct objc_zone_profile_header *header =
+      (struct objc_zone_profile_header *)((uint8_t *)ptr -
+                                          OBJC_ZONE_PROFILE_HEADER);
+  sys_mutex_lock(&profile->lock);
+  objc_zone_profile_remove(header->entry, header->size);
+  objc_zone_profile_remove(&profile->total, header->size);
+  sys_mutex_unlock(&profile->lock);
+  return header;
+}
+
+/**
+ * @brief Count an allocation which was resized in place.
+ */
+void objc_zone_profile_resize(objc_zone_profile_t *profile, void *ptr,
+                              size_t size) {
+  objc_assert(profile);
+  objc_assert(ptr);
+  struct objc_zone_profile_header *header =
+      (struct objc_zone_profile_header *)((uint8_t *)ptr -
+                                          OBJC_ZONE_PROFILE_HEADER);
+  sys_mutex_lock(&profile->lock);
+  objc_zone_profile_remove(header->entry, header->size);
+  objc_zone_profile_remove(&profile->total, header->size);
+  objc_zone_profile_add(header->entry, size);
+  objc_zone_profile_add(&profile->total, size);
+  header->size = size;
+  sys_mutex_unlock(&profile->lock);
+}
+
+/**
+ * @brief Get the live allocations for a class.
+ */
+void objc_zone_profile_class(objc_zone_profile_t *profile, Class cls,
+                             size_t *count, size_t *bytes) {
+  objc_assert(profile);
+  sys_mutex_lock(&profile->lock);
+  struct objc_zone_profile_entry *entry =
+      cls == Nil ? &profile->raw : objc_zone_profile_entry(profile, cls, false);
+  if (count != NULL) {
+    *count = entry ? entry->count : 0;
+  }
+  if (bytes != NULL) {
+    *bytes = entry ? entry->bytes : 0;
+  }
+  sys_mutex_unlock(&profile->lock);
+}
+
+/**
+ * @brief Print the live allocations for each class, ordered by bytes.
+ */
+void objc_zone_profile_dump(objc_zone_profile_t *profile, size_t limit) {
+  objc_assert(profile);
+  sys_mutex_lock(&profile->lock);
+
+  // Totals, and the rate of allocation since the last reset
+  uint64_t ms = sys_date_get_timestamp() - profile->start;
+  size_t classes = 0;
+  for (uint32_t i = 0; i < OBJC_ZONE_PROFILE_SIZE; i++) {
+    if (profile->entries[i].cls != Nil) {
+      classes++;
+    }
+  }
+  sys_printf("zone_profile: live=%zu bytes=%zu peak=%zu allocs=%zu "
+             "time=%ums allocs/s=%u classes=%zu\n",
+             profile->total.count, profile->total.bytes,
+             profile->total.peak_bytes, profile->total.allocs, (unsigned)ms,
+             (unsigned)(ms > 0 ? (uint64_t)profile->total.allocs * 1000 / ms
+                               : 0),
+             classes);
+  if (limit == 0 || limit > classes) {
+    limit = classes;
+  }
+
+  // Print the entries in order of live bytes. Each pass finds the largest
+  // entry which is smaller than the one printed before, so that the table
+  // does not need to be copied or sorted.
+  sys_printf("%10s %8s %10s %8s %8s %20s %s\n", "bytes", "count", "peak",
+             "peakcnt", "allocs", "", "class");
+  size_t max = profile->total.bytes;
+  struct objc_zone_profile_entry *prev = NULL;
+  for (size_t n = 0; n < limit; n++) {
+    struct objc_zone_profile_entry *best = NULL;
+    for (uint32_t i = 0; i < OBJC_ZONE_PROFILE_SIZE; i++) {
+      struct objc_zone_profile_entry *entry = &profile->entries[i];
+      if (entry->cls == Nil) {
+        continue;
+      }
+      // Order by bytes, then position in the table
+      if (prev != NULL && (entry->bytes > prev->bytes ||
+                           (entry->bytes == prev->bytes && entry <= prev))) {
+        continue; // Already printed
+      }
+      if (best == NULL || entry->bytes > best->bytes) {
+        best = entry;
+      }
+    }
+    if (best == NULL) {
+      break;
+    }
+    objc_zone_profile_print(best, class_getName(best->cls), max);
+    prev = best;
+  }
+
+  // Allocations which are not objects, and classes which did not fit
+  objc_zone_profile_print(&profile->raw, "(memory)", max);
+  if (profile->other.allocs != 0) {
+    objc_zone_profile_print(&profile->other, "(other classes)", max);
+  }
+  sys_mutex_unlock(&profile->lock);
+}
+
+/**
+ * @brief Reset the high-water marks and the allocation rate.
+ */
+void objc_zone_profile_reset(objc_zone_profile_t *profile) {
+  objc_assert(profile);
+  sys_mutex_lock(&profile->lock);
+  struct objc_zone_profile_entry *entries[] = {&profile->total, &profile->raw,
+                                               &profile->other};
+  for (size_t i = 0; i < sizeof(entries) / sizeof(entries[0]); i++) {
+    entries[i]->peak_count = entries[i]->count;
+    entries[i]->peak_bytes = entries[i]->bytes;
+    entries[i]->allocs = 0;
+  }
+  for (uint32_t i = 0; i < OBJC_ZONE_PROFILE_SIZE; i++) {
+    struct objc_zone_profile_entry *entry = &profile->entries[i];
+    entry->peak_count = entry->count;
+    entry->peak_bytes = entry->bytes;
+    entry->allocs = 0;
+  }
+  profile->start = sys_date_get_timestamp();
+  sys_mutex_unlock(&profile->lock);
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <objc/objc.h>
+#include <stddef.h>
+
+/**
+ * @brief Represents the allocation statistics for a zone.
+ *
+ * The statistics are only kept when Foundation is built with NXZONEPROFILE.
+ * Each allocation is then preceded by a header which records its size and
+ * the class it was allocated for.
+ */
+typedef struct objc_zone_profile objc_zone_profile_t;
+
+/**
+ * @brief Size of the header before each allocation, which is a multiple of
+ * eight bytes.
+ */
+#define OBJC_ZONE_PROFILE_HEADER (2 * sizeof(void *))
+
+/**
+ * @brief Create the allocation statistics for a zone.
+ * @return Pointer to the statistics, or NULL on failure.
+ */
+objc_zone_profile_t *objc_zone_profile_new(void);
+
+/**
+ * @brief Free the allocation statistics for a zone.
+ * @param profile Pointer to the statistics.
+ */
+void objc_zone_profile_delete(objc_zone_profile_t *profile);
+
+/**
+ * @brief Count an allocation.
+ * @param profile Pointer to the statistics.
+ * @param block Pointer to memory of size + OBJC_ZONE_PROFILE_HEADER bytes,
+ * or NULL if the allocation failed.
+ * @param size The size of the allocation in bytes.
+ * @return Pointer to the memory after the header, or NULL if block is NULL.
+ *
+ * The allocation is counted as memory which is not an object, until the
+ * class is set with objc_zone_profile_set_class().
+ */
+void *objc_zone_profile_alloc(objc_zone_profile_t *profile, void *block,
+                              size_t size);
+
+/**
+ * @brief Set the class of an allocation which is an object.
+ * @param profile Pointer to the statistics.
+ * @param ptr Pointer returned by objc_zone_profile_alloc().
+ * @param cls The class of the object.
+ */
+void objc_zone_profile_set_class(objc_zone_profile_t *profile, void *ptr,
+                                 Class cls);
+
+/**
+ * @brief Count a free.
+ * @param profile Pointer to the statistics.
+ * @param ptr Pointer returned by objc_zone_profile_alloc().
+ * @return Pointer to the memory which was allocated, including the header.
+ */
+void *objc_zone_profile_free(objc_zone_profile_t *profile, void *ptr);
+
+/**
+ * @brief Count an allocation which was resized in place.
+ * @param profile Pointer to the statistics.
+ * @param ptr Pointer returned by objc_zone_profile_alloc().
+ * @param size The new size of the allocation in bytes, without the header.
+ */
+void objc_zone_profile_resize(objc_zone_profile_t *profile, void *ptr,
+                              size_t size);
+
+/**
+ * @brief Get the live allocations for a class.
+ * @param profile Pointer to the statistics.
+ * @param cls The class, or Nil for memory which is not an object.
+ * @param count Set to the number of live allocations, if not NULL.
+ * @param bytes Set to the bytes in live allocations, if not NULL.
+ *
+ * A class which has not been allocated, or which is counted with the classes
+ * which do not fit in the table, has no live allocations.
+ */
+void objc_zone_profile_class(objc_zone_profile_t *profile, Class cls,
+                             size_t *count, size_t *bytes);
+
+/**
+ * @brief Print the live allocations for each class, ordered by bytes.
+ * @param profile Pointer to the statistics.
+ * @param limit The maximum number of classes to print, or zero for all.
+ */
+void objc_zone_profile_dump(objc_zone_profile_t *profile, size_t limit);
+
+/**
+ * @brief Reset the high-water marks and the allocation rate.
+ * @param profile Pointer to the statistics.
+ *
+ * The live counts and bytes are kept, since the allocations are still live.
+ */
+void objc_zone_profile_reset(objc_zone_profile_t *profile);
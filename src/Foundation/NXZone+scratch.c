@@ -0,0 +1,164 @@
+#include "NXZone+scratch.h"
+#include "NXZone+malloc.h"
+#include <objc/objc.h>
+#include <stddef.h>
+#include <stdint.h>
+
+///////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS
+
+/**
+ * @brief Alignment of allocations from a chunk.
+ */
+#define OBJC_SCRATCH_ALIGN 8
+
+///////////////////////////////////////////////////////////////////////////////
+// TYPES
+
+/**
+ * @brief Represents a chunk of memory for a scratch zone.
+ *
+ * The chunk is followed by its memory, which is allocated from the start
+ * to the end without any headers, and recycled all at once.
+ */
+struct objc_scratch {
+  struct objc_scratch *next; // Next chunk in the chain
+  size_t size;               // Size of the memory, in bytes
+  size_t used;               // Size of the allocated memory
+  size_t pad;                // Keeps the memory aligned
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE METHODS
+
+/**
+ * @brief Round a size up to the allocation alignment.
+ */
+static inline size_t objc_scratch_align(size_t size) {
+  return (size + OBJC_SCRATCH_ALIGN - 1) & ~(size_t)(OBJC_SCRATCH_ALIGN - 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// LIFECYCLE
+
+/**
+ * @brief Create a new scratch chunk with the specified size.
+ */
+objc_scratch_t *objc_scratch_new(objc_scratch_t *prev, size_t size) {
+  objc_assert(size > 0);
+  size = objc_scratch_align(size);
+  objc_scratch_t *scratch = __zone_malloc(sizeof(struct objc_scratch) + size);
+  if (scratch) {
+    if (prev) {
+      objc_assert(prev->next == NULL);
+      prev->next = scratch;
+    }
+    scratch->next = NULL;
+    scratch->size = size;
+    scratch->used = 0;
+  }
+  return scratch;
+}
+
+/**
+ * @brief Return the chunk size needed to hold an allocation.
+ */
+size_t objc_scratch_size_for(size_t size) { return objc_scratch_align(size); }
+
+/**
+ * @brief Free all chunks
+ */
+void objc_scratch_delete(objc_scratch_t *scratch) {
+  objc_assert(scratch);
+  do {
+    objc_scratch_t *next = scratch->next;
+    __zone_free(scratch);
+    scratch = next;
+  } while (scratch != NULL);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PUBLIC METHODS
+
+/**
+ * @brief Return the next chunk in the chain.
+ */
+objc_scratch_t *objc_scratch_next(objc_scratch_t *scratch) {
+  objc_assert(scratch);
+  return scratch->next;
+}
+
+/**
+ * @brief Allocate memory from a chunk by moving its free pointer.
+ */
+void *objc_scratch_alloc(objc_scratch_t *scratch, size_t size) {
+  objc_assert(scratch);
+  size = objc_scratch_align(size == 0 ? 1 : size);
+  if (size > scratch->size - scratch->used) {
+    return NULL; // No space available
+  }
+  void *ptr = (uint8_t *)(scratch + 1) + scratch->used;
+  scratch->used += size;
+  return ptr;
+}
+
+/**
+ * @brief Resize the last allocation from a chunk by moving its free pointer.
+ */
+BOOL objc_scratch_resize(objc_scratch_t *scratch, void *ptr, size_t size) {
+  objc_assert(scratch);
+  objc_assert(objc_scratch_extent(scratch, ptr) > 0);
+  size_t offset = (size_t)((uint8_t *)ptr - (uint8_t *)(scratch + 1));
+  size = objc_scratch_align(size == 0 ? 1 : size);
+  if (size > scratch->size - offset) {
+    return NO; // No space available
+  }
+  scratch->used = offset + size;
+  return YES;
+}
+
+/**
+ * @brief Return the number of allocated bytes from a pointer to the end of
+ * the allocated memory in a chunk.
+ */
+size_t objc_scratch_extent(objc_scratch_t *scratch, void *ptr) {
+  objc_assert(scratch);
+  uint8_t *base = (uint8_t *)(scratch + 1);
+  if ((uint8_t *)ptr < base || (uint8_t *)ptr >= base + scratch->used) {
+    return 0;
+  }
+  return (size_t)(base + scratch->used - (uint8_t *)ptr);
+}
+
+/**
+ * @brief Recycle the memory in a chunk.
+ */
+void objc_scratch_reset(objc_scratch_t *scratch, size_t used) {
+  objc_assert(scratch);
+  objc_assert(used <= scratch->size);
+  scratch->used = used;
+}
+
+/**
+ * @brief Get the total size of a chunk.
+ */
+size_t objc_scratch_stats_size(objc_scratch_t *scratch) {
+  objc_assert(scratch);
+  return sizeof(struct objc_scratch) + scratch->size;
+}
+
+/**
+ * @brief Get the amount of memory allocated from a chunk.
+ */
+size_t objc_scratch_stats_used(objc_scratch_t *scratch) {
+  objc_assert(scratch);
+  return scratch->used;
+}
+
+/**
+ * @brief Get the amount of memory remaining in a chunk.
+ */
+size_t objc_scratch_stats_free(objc_scratch_t *scratch) {
+  objc_assert(scratch);
+  return scratch->size - scratch->used;
+}
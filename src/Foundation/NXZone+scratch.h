@@ -0,0 +1,102 @@
+#pragma once
+#include <objc/objc.h>
+#include <stddef.h>
+
+/**
+ * @brief Represents a chunk of memory for a scratch zone.
+ */
+typedef struct objc_scratch objc_scratch_t;
+
+/**
+ * @brief Create a new scratch chunk with the specified size.
+ * @param prev Pointer to the last chunk in the chain, or NULL for the first
+ * chunk.
+ * @param size Size of the chunk in bytes.
+ * @return Pointer to the newly created chunk, or NULL on failure.
+ */
+objc_scratch_t *objc_scratch_new(objc_scratch_t *prev, size_t size);
+
+/**
+ * @brief Return the chunk size needed to hold an allocation.
+ * @param size Size of the allocation in bytes.
+ * @return The size of a chunk, as passed to objc_scratch_new(), which has
+ * space for an allocation of this size.
+ */
+size_t objc_scratch_size_for(size_t size);
+
+/**
+ * @brief Free all chunks
+ * @param scratch Pointer to the first chunk to free.
+ */
+void objc_scratch_delete(objc_scratch_t *scratch);
+
+/**
+ * @brief Return the next chunk in the chain.
+ * @param scratch Pointer to the current chunk.
+ * @return Pointer to the next chunk, or NULL if there are no more chunks.
+ */
+objc_scratch_t *objc_scratch_next(objc_scratch_t *scratch);
+
+/**
+ * @brief Allocate memory from a chunk by moving its free pointer.
+ * @param scratch Pointer to the chunk.
+ * @param size Size of the memory to allocate in bytes.
+ * @return Pointer to the allocated memory, or NULL if there is not enough
+ * space left in the chunk.
+ *
+ * The memory is aligned to eight bytes. There is no header, so the memory
+ * cannot be freed on its own: the whole chunk is recycled with
+ * objc_scratch_reset().
+ */
+void *objc_scratch_alloc(objc_scratch_t *scratch, size_t size);
+
+/**
+ * @brief Resize the last allocation from a chunk by moving its free pointer.
+ * @param scratch Pointer to the chunk.
+ * @param ptr Pointer to the last memory allocated from the chunk.
+ * @param size The new size of the allocation in bytes.
+ * @return YES if the allocation now holds the new size, NO if there is not
+ * enough space left in the chunk, in which case nothing is changed.
+ */
+BOOL objc_scratch_resize(objc_scratch_t *scratch, void *ptr, size_t size);
+
+/**
+ * @brief Return the number of allocated bytes from a pointer to the end of
+ * the allocated memory in a chunk.
+ * @param scratch Pointer to the chunk.
+ * @param ptr Pointer to memory allocated from a scratch zone.
+ * @return The number of bytes, or zero if the memory was not allocated from
+ * the chunk.
+ *
+ * As there are no headers, this is the most memory an allocation can hold.
+ */
+size_t objc_scratch_extent(objc_scratch_t *scratch, void *ptr);
+
+/**
+ * @brief Recycle the memory in a chunk.
+ * @param scratch Pointer to the chunk.
+ * @param used The number of bytes at the start of the chunk to keep, which
+ * is usually zero.
+ */
+void objc_scratch_reset(objc_scratch_t *scratch, size_t used);
+
+/**
+ * @brief Get the total size of a chunk.
+ * @param scratch Pointer to the chunk to query.
+ * @return The total size of the chunk in bytes, including the header.
+ */
+size_t objc_scratch_stats_size(objc_scratch_t *scratch);
+
+/**
+ * @brief Get the amount of memory allocated from a chunk.
+ * @param scratch Pointer to the chunk to query.
+ * @return The number of bytes allocated since the chunk was last reset.
+ */
+size_t objc_scratch_stats_used(objc_scratch_t *scratch);
+
+/**
+ * @brief Get the amount of memory remaining in a chunk.
+ * @param scratch Pointer to the chunk to query.
+ * @return The number of bytes which can still be allocated from the chunk.
+ */
+size_t objc_scratch_stats_free(objc_scratch_t *scratch);
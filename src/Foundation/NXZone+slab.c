@@ -0,0 +1,329 @@
+#include "NXZone+slab.h"
+#include "NXZone+arena.h"
+#include <objc/objc.h>
+#include <stddef.h>
+#include <stdint.h>
+
+///////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS
+
+/**
+ * @brief Target size of a slab page in bytes.
+ */
+#define OBJC_SLAB_PAGE_SIZE 1024
+
+/**
+ * @brief Minimum number of blocks in a slab page.
+ */
+#define OBJC_SLAB_PAGE_MIN_BLOCKS 4
+
+/**
+ * @brief Tag set in the header of a slab block.
+ *
+ * Memory allocated from the arena is preceded by the pointer to its arena,
+ * which is aligned, so the low bit distinguishes slab blocks.
+ */
+#define OBJC_SLAB_TAG ((uintptr_t)1)
+
+///////////////////////////////////////////////////////////////////////////////
+// TYPES
+
+/**
+ * @brief Represents a slab page, which is followed by its blocks.
+ *
+ * Each block is a header word containing the tagged slab pointer, followed by
+ * the user data. The first word of the user data of a free block points to
+ * the next free block in the slab.
+ */
+struct objc_slab {
+  struct objc_slab *prev;        // Previous slab with free blocks
+  struct objc_slab *next;        // Next slab with free blocks
+  struct objc_slab_class *class; // Size class for the slab
+  void *free;                    // First free block, or NULL if full
+  uint32_t used;                 // Number of allocated blocks
+  uint32_t count;                // Number of blocks
+};
+
+/**
+ * @brief Represents a size class, and the slabs which have free blocks.
+ */
+struct objc_slab_class {
+  struct objc_slab *partial; // First slab with free blocks
+  uint32_t size;             // Size of the user data of each block
+  uint32_t pages;            // Number of slab pages
+  uint32_t blocks;           // Number of blocks in all pages
+  uint32_t used;             // Number of allocated blocks in all pages
+};
+
+/**
+ * @brief Represents the size-class slabs for a zone.
+ */
+struct objc_slabs {
+  struct objc_slab_class classes[OBJC_SLAB_CLASSES];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// GLOBALS
+
+/**
+ * @brief The user data size of each size class.
+ */
+static const uint16_t objc_slab_sizes[OBJC_SLAB_CLASSES] = {
+    16, 32, 48, 64, 96, 128, 192, 256};
+
+/**
+ * @brief The size class for each 16 bytes of allocation size.
+ */
+static const uint8_t objc_slab_index[OBJC_SLAB_MAX_SIZE / 16] = {
+    0, 1, 2, 3, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7};
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE METHODS
+
+/**
+ * @brief Return the size class index for an allocation size, which must not
+ * be larger than OBJC_SLAB_MAX_SIZE.
+ */
+static inline size_t objc_slab_class_index(size_t size) {
+  return size == 0 ? 0 : objc_slab_index[(size - 1) >> 4];
+}
+
+/**
+ * @brief Return the size of a block, including the header.
+ */
+static inline size_t objc_slab_block_size(struct objc_slab_class *class) {
+  return sizeof(uintptr_t) + class->size;
+}
+
+/**
+ * @brief Return the number of blocks in a slab page for a size class.
+ */
+static size_t objc_slab_page_blocks(size_t size) {
+  size_t block = sizeof(uintptr_t) + size;
+  size_t count = (OBJC_SLAB_PAGE_SIZE - sizeof(struct objc_slab)) / block;
+  return count < OBJC_SLAB_PAGE_MIN_BLOCKS ? OBJC_SLAB_PAGE_MIN_BLOCKS : count;
+}
+
+/**
+ * @brief Link a slab at the head of the partial list of its size class.
+ */
+static inline void objc_slab_link(struct objc_slab *slab) {
+  struct objc_slab_class *class = slab->class;
+  slab->prev = NULL;
+  slab->next = class->partial;
+  if (class->partial != NULL) {
+    class->partial->prev = slab;
+  }
+  class->partial = slab;
+}
+
+/**
+ * @brief Unlink a slab from the partial list of its size class.
+ */
+static inline void objc_slab_unlink(struct objc_slab *slab) {
+  if (slab->prev != NULL) {
+    slab->prev->next = slab->next;
+  } else {
+    slab->class->partial = slab->next;
+  }
+  if (slab->next != NULL) {
+    slab->next->prev = slab->prev;
+  }
+  slab->prev = slab->next = NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// LIFECYCLE
+
+/**
+ * @brief Create the slab state for a zone.
+ */
+objc_slabs_t *objc_slabs_new(objc_arena_t *arena) {
+  objc_assert(arena);
+  objc_slabs_t *slabs = objc_arena_alloc_inner(arena, sizeof(objc_slabs_t));
+  if (slabs == NULL) {
+    return NULL;
+  }
+  for (size_t i = 0; i < OBJC_SLAB_CLASSES; i++) {
+    slabs->classes[i].partial = NULL;
+    slabs->classes[i].size = objc_slab_sizes[i];
+    slabs->classes[i].pages = 0;
+    slabs->classes[i].blocks = 0;
+    slabs->classes[i].used = 0;
+  }
+  return slabs;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PUBLIC METHODS
+
+/**
+ * @brief Return the size of a slab page for an allocation size.
+ */
+size_t objc_slabs_page_size(size_t size) {
+  if (size > OBJC_SLAB_MAX_SIZE) {
+    return 0;
+  }
+  size_t class_size = objc_slab_sizes[objc_slab_class_index(size)];
+  return sizeof(struct objc_slab) +
+         objc_slab_page_blocks(class_size) * (sizeof(uintptr_t) + class_size);
+}
+
+/**
+ * @brief Add a slab page to the size class for an allocation size.
+ */
+void objc_slabs_add_page(objc_slabs_t *slabs, void *page, size_t size) {
+  objc_assert(slabs);
+  objc_assert(page);
+  objc_assert(size <= OBJC_SLAB_MAX_SIZE);
+
+  struct objc_slab_class *class =
+      &slabs->classes[objc_slab_class_index(size)];
+  struct objc_slab *slab = (struct objc_slab *)page;
+  size_t block = objc_slab_block_size(class);
+  size_t count = objc_slab_page_blocks(class->size);
+
+  // Thread the blocks onto the free list, in address order
+  slab->class = class;
+  slab->free = NULL;
+  slab->used = 0;
+  slab->count = (uint32_t)count;
+  uint8_t *base = (uint8_t *)(slab + 1);
+  for (size_t i = count; i > 0; i--) {
+    uintptr_t *header = (uintptr_t *)(base + (i - 1) * block);
+    header[0] = (uintptr_t)slab | OBJC_SLAB_TAG;
+    *(void **)(header + 1) = slab->free;
+    slab->free = header + 1;
+  }
+
+  class->pages++;
+  class->blocks += (uint32_t)count;
+  objc_slab_link(slab);
+}
+
+/**
+ * @brief Allocate memory from a slab.
+ */
+void *objc_slabs_alloc(objc_slabs_t *slabs, size_t size) {
+  objc_assert(slabs);
+  if (size > OBJC_SLAB_MAX_SIZE) {
+    return NULL;
+  }
+  struct objc_slab_class *class =
+      &slabs->classes[objc_slab_class_index(size)];
+  struct objc_slab *slab = class->partial;
+  if (slab == NULL) {
+    return NULL; // No free blocks
+  }
+
+  // Pop the first free block
+  void *ptr = slab->free;
+  slab->free = *(void **)ptr;
+  slab->used++;
+  class->used++;
+
+  // A full slab is removed from the partial list
+  if (slab->free == NULL) {
+    objc_slab_unlink(slab);
+  }
+  return ptr;
+}
+
+/**
+ * @brief Return the size class for an allocation size.
+ */
+size_t objc_slabs_class_for_size(size_t size) {
+  objc_assert(size <= OBJC_SLAB_MAX_SIZE);
+  return objc_slab_class_index(size);
+}
+
+/**
+ * @brief Return the size class of memory allocated from a slab.
+ */
+size_t objc_slabs_class_for_ptr(objc_slabs_t *slabs, void *ptr) {
+  objc_assert(slabs);
+  objc_assert(ptr);
+  struct objc_slab *slab =
+      (struct objc_slab *)(((uintptr_t *)ptr)[-1] & ~OBJC_SLAB_TAG);
+  return (size_t)(slab->class - slabs->classes);
+}
+
+/**
+ * @brief Check if memory was allocated from a slab.
+ */
+BOOL objc_slabs_owns(void *ptr) {
+  objc_assert(ptr);
+  return (((uintptr_t *)ptr)[-1] & OBJC_SLAB_TAG) ? YES : NO;
+}
+
+/**
+ * @brief Return memory to its slab.
+ */
+void *objc_slabs_free(objc_slabs_t *slabs, void *ptr) {
+  objc_assert(slabs);
+  objc_assert(ptr);
+
+  struct objc_slab *slab =
+      (struct objc_slab *)(((uintptr_t *)ptr)[-1] & ~OBJC_SLAB_TAG);
+  struct objc_slab_class *class = slab->class;
+  objc_assert(class >= &slabs->classes[0] &&
+              class < &slabs->classes[OBJC_SLAB_CLASSES]);
+
+  // Push the block onto the free list, and make a full slab partial again
+  BOOL was_full = slab->free == NULL;
+  *(void **)ptr = slab->free;
+  slab->free = ptr;
+  slab->used--;
+  class->used--;
+  if (was_full) {
+    objc_slab_link(slab);
+  }
+
+  // Release the slab if it is empty, and is not the only slab with free
+  // blocks
+  if (slab->used == 0 && (slab->prev != NULL || slab->next != NULL)) {
+    objc_slab_unlink(slab);
+    class->pages--;
+    class->blocks -= slab->count;
+    return slab;
+  }
+  return NULL;
+}
+
+/**
+ * @brief Get the number of bytes of slab memory which is not allocated.
+ */
+size_t objc_slabs_stats_free(objc_slabs_t *slabs) {
+  objc_assert(slabs);
+  size_t free = 0;
+  for (size_t i = 0; i < OBJC_SLAB_CLASSES; i++) {
+    struct objc_slab_class *class = &slabs->classes[i];
+    free += (size_t)(class->blocks - class->used) * objc_slab_block_size(class);
+  }
+  return free;
+}
+
+/**
+ * @brief Get the statistics for a size class.
+ */
+BOOL objc_slabs_stats_class(objc_slabs_t *slabs, size_t index, size_t *size,
+                            size_t *pages, size_t *used, size_t *free) {
+  objc_assert(slabs);
+  if (index >= OBJC_SLAB_CLASSES) {
+    return NO;
+  }
+  struct objc_slab_class *class = &slabs->classes[index];
+  if (size != NULL) {
+    *size = class->size;
+  }
+  if (pages != NULL) {
+    *pages = class->pages;
+  }
+  if (used != NULL) {
+    *used = class->used;
+  }
+  if (free != NULL) {
+    *free = class->blocks - class->used;
+  }
+  return YES;
+}
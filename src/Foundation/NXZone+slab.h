@@ -0,0 +1,120 @@
+#pragma once
+#include "NXZone+arena.h"
+#include <objc/objc.h>
+#include <stddef.h>
+
+/**
+ * @brief Largest allocation, in bytes, which is made from a slab.
+ *
+ * Larger allocations are made directly from the arena.
+ */
+#define OBJC_SLAB_MAX_SIZE 256
+
+/**
+ * @brief Number of slab size classes.
+ */
+#define OBJC_SLAB_CLASSES 8
+
+/**
+ * @brief Represents the size-class slabs for a zone.
+ */
+typedef struct objc_slabs objc_slabs_t;
+
+/**
+ * @brief Create the slab state for a zone.
+ * @param arena The arena in which the slab state is allocated.
+ * @return Pointer to the slab state, or NULL on failure.
+ *
+ * The slab state is allocated from the arena, and is freed when the arena is
+ * deleted. The slab pages themselves are added with objc_slabs_add_page().
+ */
+objc_slabs_t *objc_slabs_new(objc_arena_t *arena);
+
+/**
+ * @brief Return the size of a slab page for an allocation size.
+ * @param size The size of the allocation in bytes.
+ * @return The number of bytes to allocate for a slab page which holds
+ * allocations of this size, or zero if the size is too large for a slab.
+ */
+size_t objc_slabs_page_size(size_t size);
+
+/**
+ * @brief Add a slab page to the size class for an allocation size.
+ * @param slabs Pointer to the slab state.
+ * @param page Pointer to memory of the size returned by
+ * objc_slabs_page_size(), which should be pointer-aligned.
+ * @param size The size of the allocation which needed the page.
+ */
+void objc_slabs_add_page(objc_slabs_t *slabs, void *page, size_t size);
+
+/**
+ * @brief Allocate memory from a slab.
+ * @param slabs Pointer to the slab state.
+ * @param size Size of the memory to allocate in bytes.
+ * @return Pointer to the allocated memory, or NULL if the size is too large
+ * for a slab or the size class has no free space.
+ *
+ * This takes the first free block of the size class, in constant time. When
+ * NULL is returned for a size which fits in a slab, a page should be added
+ * with objc_slabs_add_page() before trying again.
+ */
+void *objc_slabs_alloc(objc_slabs_t *slabs, size_t size);
+
+/**
+ * @brief Return the size class for an allocation size.
+ * @param size The size of the allocation in bytes, which must not be larger
+ * than OBJC_SLAB_MAX_SIZE.
+ * @return The index of the size class, less than OBJC_SLAB_CLASSES.
+ */
+size_t objc_slabs_class_for_size(size_t size);
+
+/**
+ * @brief Return the size class of memory allocated from a slab.
+ * @param slabs Pointer to the slab state.
+ * @param ptr Pointer to memory returned by objc_slabs_alloc().
+ * @return The index of the size class, less than OBJC_SLAB_CLASSES.
+ */
+size_t objc_slabs_class_for_ptr(objc_slabs_t *slabs, void *ptr);
+
+/**
+ * @brief Check if memory was allocated from a slab.
+ * @param ptr Pointer to memory returned by objc_slabs_alloc() or the arena.
+ * @return YES if the memory was allocated from a slab, NO if it was allocated
+ * from the arena.
+ */
+BOOL objc_slabs_owns(void *ptr);
+
+/**
+ * @brief Return memory to its slab.
+ * @param slabs Pointer to the slab state.
+ * @param ptr Pointer to memory returned by objc_slabs_alloc().
+ * @return Pointer to a slab page which is no longer used and should be
+ * returned to the arena, or NULL.
+ *
+ * This pushes the block onto the free list of its slab, in constant time.
+ * The last slab page of a size class is kept even when it is empty, so that
+ * alternating allocations and frees do not return the page to the arena.
+ */
+void *objc_slabs_free(objc_slabs_t *slabs, void *ptr);
+
+/**
+ * @brief Get the number of bytes of slab memory which is not allocated.
+ * @param slabs Pointer to the slab state.
+ * @return The number of bytes in free slab blocks, including their headers.
+ */
+size_t objc_slabs_stats_free(objc_slabs_t *slabs);
+
+/**
+ * @brief Get the statistics for a size class.
+ * @param slabs Pointer to the slab state.
+ * @param index Index of the size class, starting at zero.
+ * @param size Pointer to a value updated with the largest allocation size for
+ * the size class.
+ * @param pages Pointer to a value updated with the number of slab pages.
+ * @param used Pointer to a value updated with the number of allocated blocks.
+ * @param free Pointer to a value updated with the number of free blocks.
+ * @return YES if the size class exists, NO if the index is past the last
+ * size class.
+ */
+BOOL objc_slabs_stats_class(objc_slabs_t *slabs, size_t index, size_t *size,
+                            size_t *pages, size_t *used, size_t *free);
@@ -1,13 +1,258 @@
+#include "NXPoolZone.h"
+#include "NXScratchZone.h"
+#include "NXZone+Private.h"
 #include "NXZone+arena.h"
+#include "NXZone+profile.h"
+#include "NXZone+slab.h"
 #include <Foundation/Foundation.h>
 #include <runtime-sys/sys.h>
 #include <string.h>
 
+// Number of blocks of each size class in a thread cache
+#ifdef SYSTEM_NAME_PICO
+#define ZONE_CACHE_SIZE 8
+#else
+#define ZONE_CACHE_SIZE 32
+#endif
+
+/*
+ * A cache of free slab blocks for one zone, used by one thread, with a
+ * magazine of blocks for each size class. The blocks in the cache are
+ * counted as allocated by the zone.
+ */
+struct objc_zone_cache {
+  struct objc_zone_cache *next; // Next cache for the same zone
+  id zone;                      // Zone the cache belongs to, or nil
+  uint32_t count[OBJC_SLAB_CLASSES];
+  void *blocks[OBJC_SLAB_CLASSES][ZONE_CACHE_SIZE];
+};
+
 // Define the first zone allocated as the default zone
 static id defaultZone = nil;
 
+#ifdef SYSTEM_NAME_PICO
+// Thread-local variables are not separate for each core on the Pico, since
+// the thread pointer is not set up for each core. Each core runs a single
+// thread, so the cache is kept for each core.
+#define ZONE_MAX_CORES 2
+static struct objc_zone_cache *zoneCaches[ZONE_MAX_CORES] = {NULL};
+#else
+// The cache for the calling thread
+static __thread struct objc_zone_cache *zoneCache = NULL;
+#endif
+
+/*
+ * Return the cache for the calling thread, or NULL if it has not been created.
+ */
+static inline struct objc_zone_cache *_zone_cache_get(void) {
+#ifdef SYSTEM_NAME_PICO
+  return zoneCaches[sys_thread_core() % ZONE_MAX_CORES];
+#else
+  return zoneCache;
+#endif
+}
+
+/*
+ * Set the cache for the calling thread.
+ */
+static inline void _zone_cache_set(struct objc_zone_cache *cache) {
+#ifdef SYSTEM_NAME_PICO
+  zoneCaches[sys_thread_core() % ZONE_MAX_CORES] = cache;
+#else
+  zoneCache = cache;
+#endif
+}
+
+@interface NXZone ()
+- (void)_removeCache:(struct objc_zone_cache *)cache;
+@end
+
+/*
+ * Called when a thread exits, to return the blocks in its cache to the zone
+ * the cache belongs to, and free the cache.
+ */
+static void _zone_cache_exit(void *arg) {
+  struct objc_zone_cache *cache = (struct objc_zone_cache *)arg;
+  if (cache->zone != nil) {
+    [(NXZone *)cache->zone _removeCache:cache];
+  }
+  if (_zone_cache_get() == cache) {
+    _zone_cache_set(NULL);
+  }
+  sys_free(cache);
+}
+
 @implementation NXZone
 
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE METHODS
+
+/*
+ * Allocate memory from the arenas, adding a new arena if there is no space
+ * in any arena. Must be called while synchronized on the zone.
+ */
+- (void *)_arenaAllocWithSize:(size_t)size {
+  void *ptr = objc_arena_alloc((objc_arena_t *)_root, size);
+  if (ptr == NULL) {
+    // If allocation fails, attempt to create a new arena
+    size_t arenaSize = objc_arena_size_for(size);
+    objc_arena_t *new = objc_arena_new((objc_arena_t *)_cur,
+                                       arenaSize > _size ? arenaSize : _size);
+    if (new) {
+      _cur = new; // Update current arena to the new one
+      ptr = objc_arena_alloc_inner(new, size);
+    }
+  }
+  return ptr;
+}
+
+/*
+ * Allocate memory from a slab or the arenas, and count the allocation. Must
+ * be called while synchronized on the zone.
+ */
+- (void *)_allocWithSize:(size_t)size {
+  // Small allocations are made from a slab for their size class, and a slab
+  // page is added from the arena when the size class is full. Larger
+  // allocations are made from the arena.
+  void *ptr = NULL;
+  size_t pageSize = objc_slabs_page_size(size);
+  if (pageSize != 0) {
+    ptr = objc_slabs_alloc((objc_slabs_t *)_slabs, size);
+    if (ptr == NULL) {
+      void *page = [self _arenaAllocWithSize:pageSize];
+      if (page != NULL) {
+        objc_slabs_add_page((objc_slabs_t *)_slabs, page, size);
+        ptr = objc_slabs_alloc((objc_slabs_t *)_slabs, size);
+      }
+    }
+  } else {
+    ptr = [self _arenaAllocWithSize:size];
+  }
+
+  // Increment the allocation count
+  if (ptr != NULL) {
+    if (_count == SIZE_MAX) {
+      sys_panicf("[NXZone allocWithSize] count overflow");
+    } else {
+      // Increment the allocation count
+      _count++;
+    }
+  }
+  return ptr;
+}
+
+/*
+ * Free memory back to its slab, which may release an empty slab page back to
+ * the arena, or free the memory back to the arena. Must be called while
+ * synchronized on the zone.
+ */
+- (void)_free:(void *)ptr {
+  BOOL success = YES;
+  if (objc_slabs_owns(ptr)) {
+    void *page = objc_slabs_free((objc_slabs_t *)_slabs, ptr);
+    if (page != NULL) {
+      success = objc_arena_free((objc_arena_t *)_root, page);
+    }
+  } else {
+    success = objc_arena_free((objc_arena_t *)_root, ptr);
+  }
+  if (success) {
+    _count--;
+  } else {
+    sys_panicf("[NXZone free] failed to free memory @%p", ptr);
+  }
+}
+
+/*
+ * Return the cache for the calling thread, or NULL if the thread's cache
+ * belongs to another zone. A thread's cache is created on first use, and
+ * belongs to the first zone it is used with, until that zone is deallocated.
+ */
+- (struct objc_zone_cache *)_threadCache {
+  struct objc_zone_cache *cache = _zone_cache_get();
+  if (cache == NULL) {
+    cache = sys_malloc(sizeof(struct objc_zone_cache));
+    if (cache == NULL) {
+      return NULL;
+    }
+    sys_memset(cache, 0, sizeof(struct objc_zone_cache));
+
+    // Free the cache when the thread exits
+    if (sys_thread_atexit(_zone_cache_exit, cache) == false) {
+      sys_free(cache);
+      return NULL;
+    }
+    _zone_cache_set(cache);
+  }
+  if (cache->zone == self) {
+    return cache;
+  }
+  if (cache->zone != nil) {
+    return NULL; // The cache belongs to another zone
+  }
+
+  // Add the cache to the caches for this zone, so they can be flushed when
+  // the zone is deallocated
+  @synchronized(self) {
+    cache->zone = self;
+    cache->next = (struct objc_zone_cache *)_caches;
+    _caches = cache;
+  }
+  return cache;
+}
+
+/*
+ * Fill half of a cache magazine with blocks of the size class for a size.
+ * Returns NO if no blocks could be allocated.
+ */
+- (BOOL)_fillCache:(struct objc_zone_cache *)cache size:(size_t)size {
+  size_t index = objc_slabs_class_for_size(size);
+  @synchronized(self) {
+    while (cache->count[index] < ZONE_CACHE_SIZE / 2) {
+      void *ptr = [self _allocWithSize:size];
+      if (ptr == NULL) {
+        break;
+      }
+      cache->blocks[index][cache->count[index]++] = ptr;
+    }
+  }
+  return cache->count[index] > 0 ? YES : NO;
+}
+
+/*
+ * Return blocks from the top of a cache magazine to their slabs
+ */
+- (void)_drainCache:(struct objc_zone_cache *)cache
+              index:(size_t)index
+              count:(uint32_t)count {
+  @synchronized(self) {
+    while (count-- > 0 && cache->count[index] > 0) {
+      [self _free:cache->blocks[index][--cache->count[index]]];
+    }
+  }
+}
+
+/*
+ * Return the blocks in a thread cache to the zone, and remove the cache from
+ * the caches for the zone
+ */
+- (void)_removeCache:(struct objc_zone_cache *)cache {
+  @synchronized(self) {
+    for (size_t index = 0; index < OBJC_SLAB_CLASSES; index++) {
+      [self _drainCache:cache index:index count:ZONE_CACHE_SIZE];
+    }
+    struct objc_zone_cache **link = (struct objc_zone_cache **)&_caches;
+    while (*link != NULL && *link != cache) {
+      link = &(*link)->next;
+    }
+    if (*link == cache) {
+      *link = cache->next;
+    }
+    cache->next = NULL;
+    cache->zone = nil;
+  }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // LIFECYCLE
 
@@ -46,14 +291,35 @@ static id defaultZone = nil;
     return nil;
   }
 
+  // Allocate the size-class slabs
+  objc_slabs_t *slabs = objc_slabs_new(arena);
+  if (slabs == NULL) {
+    objc_arena_delete(arena);
+    return nil;
+  }
+
+  // Allocate the allocation statistics
+#ifdef NXZONEPROFILE
+  objc_zone_profile_t *profile = objc_zone_profile_new();
+  if (profile == NULL) {
+    objc_arena_delete(arena);
+    return nil;
+  }
+#else
+  void *profile = NULL;
+#endif
+
   // Initialize the object properly
   object_setClass(zone, self);
 
   // Set up instance variables
   zone->_root = zone->_cur = arena;
+  zone->_slabs = slabs;
+  zone->_caches = NULL;
+  zone->_profile = profile;
   zone->_size = alignedObjectSize + size; // Update _size to reflect arena size
   zone->_count = 0;
-  zone->_retain = 1; // Initial retain count
+  sys_atomic_init(&zone->_retain, 1); // Initial retain count
 
   // Set the default zone if it hasn't been set yet
   if (defaultZone == nil) {
@@ -63,14 +329,42 @@ static id defaultZone = nil;
   return zone;
 }
 
+/*
+ * Create a new scratch zone, which is never set as the default zone.
+ */
++ (id)scratchZoneWithSize:(size_t)size {
+  return [NXScratchZone scratchZoneWithSize:size];
+}
+
+/*
+ * Create a new pool zone, which is never set as the default zone.
+ */
++ (id)poolZoneWithSize:(size_t)size count:(size_t)count {
+  return [NXPoolZone poolZoneWithSize:size count:count];
+}
+
 /*
  * Deallocate the zone, freeing the allocated memory.
  */
 - (void)dealloc {
-  // Sanity check: ensure no active allocations
+  // Return the blocks in all thread caches to the zone. The caches are kept
+  // by their threads until they exit, and can be used by another zone.
+  while (_caches != NULL) {
+    [self _removeCache:(struct objc_zone_cache *)_caches];
+  }
+
+  // Sanity check: ensure no active allocations, and report which classes
+  // they belong to when the zone keeps allocation statistics
   if (_count != 0) {
+#ifdef NXZONEPROFILE
+    objc_zone_profile_dump((objc_zone_profile_t *)_profile, 0);
+#endif
     sys_panicf("[NXZone dealloc] called with %zu active allocations", _count);
   }
+#ifdef NXZONEPROFILE
+  objc_zone_profile_delete((objc_zone_profile_t *)_profile);
+  _profile = NULL;
+#endif
 
   // Clear the default zone if this is it
   if (defaultZone == self) {
@@ -98,51 +392,186 @@ static id defaultZone = nil;
 // INSTANCE METHODS
 
 - (void *)allocWithSize:(size_t)size {
+#ifdef NXZONEPROFILE
+  // The allocation is preceded by a header for the allocation statistics
+  size_t blockSize = size + OBJC_ZONE_PROFILE_HEADER;
+#else
+  size_t blockSize = size;
+#endif
   void *ptr = NULL;
-  @synchronized(self) {
-    // Allocate memory from the current arena
-    ptr = objc_arena_alloc_inner((objc_arena_t *)_cur, size);
-    if (ptr == NULL) {
-      // If allocation fails, attempt to create a new arena
-      objc_arena_t *new =
-          objc_arena_new((objc_arena_t *)_cur, size > _size ? size : _size);
-      if (new) {
-        _cur = new; // Update current arena to the new one
-        ptr = objc_arena_alloc_inner(new, size);
-      }
+  struct objc_zone_cache *cache = NULL;
+  if (blockSize <= OBJC_SLAB_MAX_SIZE) {
+    // Small allocations are taken from the calling thread's cache, which is
+    // refilled from the slabs in batches
+    cache = _zone_cache_get();
+    if (cache == NULL || cache->zone != self) {
+      cache = [self _threadCache];
     }
-#ifdef DEBUG
-    NXLog(@"  allocWithSize: size=%zu => @%p", size, ptr);
-#endif
-    // Increment the allocation count
-    if (ptr != NULL) {
-      if (_count == SIZE_MAX) {
-        sys_panicf("[NXZone allocWithSize] count overflow");
-      } else {
-        // Increment the allocation count
-        _count++;
-      }
+  }
+  if (cache != NULL) {
+    size_t index = objc_slabs_class_for_size(blockSize);
+    if (cache->count[index] > 0 || [self _fillCache:cache size:blockSize]) {
+      ptr = cache->blocks[index][--cache->count[index]];
+    }
+  } else {
+    @synchronized(self) {
+      ptr = [self _allocWithSize:blockSize];
     }
-    return ptr;
   }
+#ifdef NXZONEPROFILE
+  ptr = objc_zone_profile_alloc((objc_zone_profile_t *)_profile, ptr, size);
+#endif
+#ifdef DEBUG
+  NXLog(@"  allocWithSize: size=%zu => @%p", size, ptr);
+#endif
+  return ptr;
 }
 
 - (void)free:(void *)ptr {
   if (ptr == NULL) {
     return;
   }
-  @synchronized(self) {
 #ifdef DEBUG
-    NXLog(@"  free: @%p", ptr);
+  NXLog(@"  free: @%p", ptr);
 #endif
-    // Free the memory back to the arena
-    BOOL success = objc_arena_free((objc_arena_t *)_root, ptr);
-    if (success) {
-      _count--;
-    } else {
-      sys_panicf("[NXZone free] failed to free memory @%p", ptr);
+#ifdef NXZONEPROFILE
+  ptr = objc_zone_profile_free((objc_zone_profile_t *)_profile, ptr);
+#endif
+  if (objc_slabs_owns(ptr)) {
+    // Small blocks are returned to the calling thread's cache, and half of
+    // the magazine is returned to the slabs when it is full
+    struct objc_zone_cache *cache = _zone_cache_get();
+    if (cache == NULL || cache->zone != self) {
+      cache = [self _threadCache];
+    }
+    if (cache != NULL) {
+      size_t index = objc_slabs_class_for_ptr((objc_slabs_t *)_slabs, ptr);
+      if (cache->count[index] == ZONE_CACHE_SIZE) {
+        [self _drainCache:cache index:index count:ZONE_CACHE_SIZE / 2];
+      }
+      cache->blocks[index][cache->count[index]++] = ptr;
+      return;
     }
   }
+  @synchronized(self) {
+    [self _free:ptr];
+  }
+}
+
+- (void *)reallocWithPtr:(void *)ptr size:(size_t)size {
+  if (ptr == NULL) {
+    return [self allocWithSize:size];
+  }
+  if (size == 0) {
+    [self free:ptr];
+    return NULL;
+  }
+#ifdef NXZONEPROFILE
+  size_t blockSize = size + OBJC_ZONE_PROFILE_HEADER;
+  void *block = (uint8_t *)ptr - OBJC_ZONE_PROFILE_HEADER;
+#else
+  size_t blockSize = size;
+  void *block = ptr;
+#endif
+
+  // A slab block is kept while the new size fits in its size class, and an
+  // arena block grows into the free space after it
+  size_t capacity = 0;
+  BOOL resized = NO;
+  if (objc_slabs_owns(block)) {
+    objc_slabs_stats_class(
+        (objc_slabs_t *)_slabs,
+        objc_slabs_class_for_ptr((objc_slabs_t *)_slabs, block), &capacity,
+        NULL, NULL, NULL);
+    resized = blockSize <= capacity ? YES : NO;
+  } else {
+    @synchronized(self) {
+      capacity = objc_arena_ptr_size(block);
+      resized = objc_arena_resize(block, blockSize);
+    }
+  }
+#ifdef NXZONEPROFILE
+  capacity -= OBJC_ZONE_PROFILE_HEADER;
+  if (resized) {
+    objc_zone_profile_resize((objc_zone_profile_t *)_profile, ptr, size);
+  }
+#endif
+#ifdef DEBUG
+  NXLog(@"  reallocWithPtr: @%p size=%zu resized=%s", ptr, size,
+        resized ? "YES" : "NO");
+#endif
+  if (resized) {
+    return ptr;
+  }
+
+  // Otherwise move the memory to a new allocation
+  void *newPtr = [self allocWithSize:size];
+  if (newPtr != NULL) {
+    sys_memcpy(newPtr, ptr, size < capacity ? size : capacity);
+    [self free:ptr];
+  }
+  return newPtr;
+}
+
+- (void)flushCache {
+  struct objc_zone_cache *cache = _zone_cache_get();
+  if (cache == NULL || cache->zone != self) {
+    return; // No cache for this zone on the calling thread
+  }
+  for (size_t index = 0; index < OBJC_SLAB_CLASSES; index++) {
+    [self _drainCache:cache index:index count:ZONE_CACHE_SIZE];
+  }
+}
+
+- (void)reset {
+  // Memory in a general zone is freed one allocation at a time
+}
+
+- (void)profileObject:(id)object {
+#ifdef NXZONEPROFILE
+  if (_profile != NULL && object != nil) {
+    objc_zone_profile_set_class((objc_zone_profile_t *)_profile, object,
+                                object_getClass(object));
+  }
+#else
+  (void)object;
+#endif
+}
+
+- (BOOL)profileClass:(Class)cls count:(size_t *)count bytes:(size_t *)bytes {
+#ifdef NXZONEPROFILE
+  if (_profile != NULL) {
+    objc_zone_profile_class((objc_zone_profile_t *)_profile, cls, count,
+                            bytes);
+    return YES;
+  }
+#else
+  (void)cls;
+  (void)count;
+  (void)bytes;
+#endif
+  return NO;
+}
+
+- (void)dumpProfile:(size_t)limit {
+#ifdef NXZONEPROFILE
+  if (_profile == NULL) {
+    sys_printf("zone_profile: no statistics for this zone\n");
+  } else {
+    objc_zone_profile_dump((objc_zone_profile_t *)_profile, limit);
+  }
+#else
+  (void)limit;
+  sys_printf("zone_profile: Foundation was built without NXZONE_PROFILE\n");
+#endif
+}
+
+- (void)resetProfile {
+#ifdef NXZONEPROFILE
+  if (_profile != NULL) {
+    objc_zone_profile_reset((objc_zone_profile_t *)_profile);
+  }
+#endif
 }
 
 - (void)dump {
@@ -169,8 +598,18 @@ static id defaultZone = nil;
     } while (alloc != NULL);
     cur = objc_arena_next(cur); // Move to the next arena
   }
-  NXLog(@"Total size: %zu bytes, used: %zu bytes, free: %zu bytes", size, used,
-        free);
+  size_t slabIndex = 0;
+  size_t slabSize, slabPages, slabUsed, slabFree;
+  while (objc_slabs_stats_class((objc_slabs_t *)_slabs, slabIndex++, &slabSize,
+                                &slabPages, &slabUsed, &slabFree)) {
+    if (slabPages != 0) {
+      NXLog(@"  slab size=%zu pages=%zu used=%zu free=%zu", slabSize,
+            slabPages, slabUsed, slabFree);
+    }
+  }
+  size_t slabBytesFree = objc_slabs_stats_free((objc_slabs_t *)_slabs);
+  NXLog(@"Total size: %zu bytes, used: %zu bytes, free: %zu bytes", size,
+        used - slabBytesFree, free + slabBytesFree);
 }
 
 /**
@@ -204,7 +643,9 @@ static id defaultZone = nil;
     used += objc_arena_stats_used(cur);
     cur = objc_arena_next(cur); // Move to the next arena
   }
-  return used;
+
+  // Free blocks in slab pages are not used
+  return used - objc_slabs_stats_free((objc_slabs_t *)_slabs);
 }
 
 /**
@@ -220,7 +661,9 @@ static id defaultZone = nil;
     free += objc_arena_stats_free(cur);
     cur = objc_arena_next(cur); // Move to the next arena
   }
-  return free;
+
+  // Free blocks in slab pages are free
+  return free + objc_slabs_stats_free((objc_slabs_t *)_slabs);
 }
 
 @end
@@ -31,6 +31,12 @@
   return _length;
 }
 
+- (uintptr_t)hash {
+  // The compiler emits constant strings with a fixed layout, so there is no
+  // space to cache the hash in the object
+  return (uint32_t)sys_hash_djb2(_data);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////
 // PUBLIC METHODS
 
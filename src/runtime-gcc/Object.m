@@ -43,6 +43,18 @@
   return class_getName(self);
 }
 
+- (IMP)methodForSelector:(SEL)aSelector {
+  return class_getMethodImplementation(object_getClass(self), aSelector);
+}
+
++ (IMP)methodForSelector:(SEL)aSelector {
+  return class_getClassMethodImplementation(self, aSelector);
+}
+
++ (IMP)instanceMethodForSelector:(SEL)aSelector {
+  return class_getMethodImplementation(self, aSelector);
+}
+
 - (BOOL)isEqual:(id)anObject {
   return self == anObject;
 }
@@ -50,7 +50,8 @@ struct objc_class {
       *ivars; // List of instance variables defined in this class
   struct objc_method_list
       *methods;  // List of instance methods defined in this class
-  void **dtable; // Dispatch table for instance methods
+  struct objc_dtable
+      *dtable; // Dispatch cache of selector to IMP, including inherited IMPs
   struct objc_class
       *subclass_list;             // Pointer to the first subclass of this class
   struct objc_class *sibling_cls; // Pointer to sibling classes
@@ -65,6 +66,8 @@ enum objc_class_flags {
       0x04, // Indicates the class has received the +initialize message
   objc_class_flag_resolved =
       0x08, // Indicates the class has been initialized by the runtime
+  objc_class_flag_initializing =
+      0x10, // Indicates the class is running its +initialize method
 };
 
 struct objc_category {
@@ -1,11 +1,12 @@
 #include "category.h"
 #include "api.h"
 #include "class.h"
+#include "table.h"
 #include <objc/objc.h>
 #include <runtime-sys/sys.h>
 
-#define CATEGORY_TABLE_SIZE 32
-static struct objc_category *category_table[CATEGORY_TABLE_SIZE + 1];
+// Categories, in the order they were registered
+static struct objc_array category_table;
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -15,9 +16,9 @@ void __objc_category_init() {
     return; // Already initialized
   }
   init = YES;
-  for (int i = 0; i <= CATEGORY_TABLE_SIZE; i++) {
-    category_table[i] = NULL;
-  }
+  category_table.count = 0;
+  category_table.capacity = 0;
+  category_table.items = NULL;
 }
 
 void __objc_category_register(struct objc_category *category) {
@@ -29,19 +30,9 @@ void __objc_category_register(struct objc_category *category) {
   sys_printf("__objc_category_register [%s+%s]\n", category->class_name,
              category->name);
 #endif
-  for (int i = 0; i < CATEGORY_TABLE_SIZE; i++) {
-    if (category_table[i] == category) {
-      // Category is already registered, nothing to do
-      return;
-    }
-    if (category_table[i] == NULL) {
-      // Found empty slot, register the category
-      category_table[i] = category;
-      return;
-    }
+  if (!__objc_array_append(&category_table, category)) {
+    sys_panicf("Failed to register category: %s", category->name);
   }
-  sys_panicf("Category table is full, cannot register category: %s",
-             category->name);
 }
 
 static void __objc_category_load_category(struct objc_category *category) {
@@ -81,12 +72,8 @@ BOOL __objc_category_load() {
   init = YES;
 
   // Replace class name with resolved class
-  for (int i = 0; i < CATEGORY_TABLE_SIZE; i++) {
-    struct objc_category *category = category_table[i];
-    if (category == NULL) {
-      continue; // Skip empty slots and continue searching
-    }
-    __objc_category_load_category(category);
+  for (uint32_t i = 0; i < category_table.count; i++) {
+    __objc_category_load_category(category_table.items[i]);
   }
 
   return YES;
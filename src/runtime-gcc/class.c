@@ -1,13 +1,21 @@
 #include "class.h"
 #include "api.h"
+#include "dtable.h"
 #include "hash.h"
 #include "protocol.h"
+#include "selector.h"
+#include "table.h"
 #include <objc/objc.h>
 #include <runtime-sys/sys.h>
 #include <string.h>
 
-#define CLASS_TABLE_SIZE 32
-objc_class_t *class_table[CLASS_TABLE_SIZE + 1];
+/*
+ * Initial class table size, which should be a power of 2
+ */
+#define CLASS_TABLE_SIZE 64
+
+// Classes, keyed by name
+static struct objc_table class_table;
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -18,8 +26,8 @@ void __objc_class_init() {
   }
   init = YES;
 
-  for (int i = 0; i <= CLASS_TABLE_SIZE; i++) {
-    class_table[i] = NULL;
+  if (!__objc_table_init(&class_table, CLASS_TABLE_SIZE)) {
+    sys_panicf("Failed to allocate class table");
   }
 }
 
@@ -31,28 +39,20 @@ void __objc_class_register(objc_class_t *p) {
   sys_printf("__objc_class_register %c[%s] @%p size=%lu\n",
              p->info & objc_class_flag_meta ? '+' : '-', p->name, p, p->size);
 #endif
-  for (int i = 0; i < CLASS_TABLE_SIZE; i++) {
-    if (class_table[i] == p) {
-      // Class is already registered, nothing to do
-      return;
-    }
-    if (class_table[i] == NULL) {
-      // Found empty slot, register the class
-      class_table[i] = p;
-
-      // Register protocols for the class
-      if (p->protocols != NULL) {
-        __objc_protocol_list_register(p->protocols);
-      }
-      return;
-    }
+  objc_class_t *cls = __objc_table_put(&class_table, p->name, p);
+  if (cls == NULL) {
+    sys_panicf("Failed to register class: %s", p->name);
+    return;
+  }
+  if (cls != p) {
+    sys_panicf("Duplicate class named: %s", p->name);
+    return;
+  }
 
-    // Check for duplicate class names
-    if (strcmp(class_table[i]->name, p->name) == 0) {
-      sys_panicf("Duplicate class named: %s", p->name);
-    }
+  // Register protocols for the class
+  if (p->protocols != NULL) {
+    __objc_protocol_list_register(p->protocols);
   }
-  sys_panicf("Class table is full, cannot register class: %s", p->name);
 }
 
 /**
@@ -60,18 +60,45 @@ void __objc_class_register(objc_class_t *p) {
  * Returns the class, or Nil if not found.
  */
 objc_class_t *__objc_lookup_class(const char *name) {
-  if (name == NULL) {
-    return Nil;
+  return __objc_table_get(&class_table, name);
+}
+
+/**
+ * Returns YES if the class is the same as, or inherits from, the superclass.
+ * Only classes which have been sent messages have dispatch tables, and their
+ * superclass chains are always resolved.
+ */
+static BOOL __objc_class_inherits(objc_class_t *cls, objc_class_t *superclass) {
+  for (; cls != Nil; cls = cls->superclass) {
+    if (cls == superclass) {
+      return YES;
+    }
+  }
+  return NO;
+}
+
+/**
+ * Flush the dispatch tables of a class and all its subclasses, which cache
+ * IMPs which may have been replaced. Until the first message is sent, no class
+ * has a dispatch table, so loading does not scan the class table.
+ */
+static void __objc_class_flush_dtables(objc_class_t *cls) {
+  if (_objc_dtable_count() == 0) {
+    return; // No class has been sent a message, so no tables are cached
   }
-  for (int i = 0; i < CLASS_TABLE_SIZE; i++) {
-    if (class_table[i] == NULL || class_table[i]->name == NULL) {
-      continue; // Skip empty slots and continue searching
+  for (uint32_t i = 0; i <= class_table.mask; i++) {
+    if (class_table.entries[i].name == NULL) {
+      continue; // Skip empty slots
+    }
+    objc_class_t *p = class_table.entries[i].value;
+    if (p->dtable != NULL && __objc_class_inherits(p, cls)) {
+      _objc_dtable_flush(p);
     }
-    if (strcmp(class_table[i]->name, name) == 0) {
-      return class_table[i];
+    p = p->metaclass;
+    if (p != NULL && p->dtable != NULL && __objc_class_inherits(p, cls)) {
+      _objc_dtable_flush(p);
     }
   }
-  return Nil; // No class found
 }
 
 /**
@@ -88,28 +115,29 @@ void __objc_class_register_method_list(objc_class_t *cls,
     if (method == NULL || method->name == NULL || method->imp == NULL) {
       continue; // Skip invalid methods
     }
+
+    // Replace the method name with the unique selector name
+    method->name = __objc_selector_unique(method->name);
+    if (method->name == NULL) {
+      sys_panicf("Failed to register selector in class %s\n", cls->name);
+      return;
+    }
 #ifdef OBJCDEBUG
     sys_printf("    %c[%s %s] types=%s imp=%p\n",
                cls->info & objc_class_flag_meta ? '+' : '-', cls->name,
                method->name, method->types, method->imp);
 #endif
-    // We register the version WITH the type
     struct objc_hashitem *item =
         __objc_hash_register(cls, method->name, method->types, method->imp);
     if (item == NULL) {
-      sys_panicf("TODO: Failed to register method %s in class %s\n",
-                 method->name, cls->name);
-      return;
-    }
-
-    // We register the version WITHOUT the type
-    item = __objc_hash_register(cls, method->name, NULL, method->imp);
-    if (item == NULL) {
-      sys_panicf("TODO: Failed to register method %s in class %s\n",
-                 method->name, cls->name);
+      sys_panicf("Failed to register method %s in class %s\n", method->name,
+                 cls->name);
       return;
     }
   }
+
+  // Replaced and added methods invalidate the dispatch tables
+  __objc_class_flush_dtables(cls);
 }
 
 /**
@@ -1,88 +1,145 @@
+#include "dtable.h"
 #include "api.h"
 #include <runtime-sys/sys.h>
 
 ///////////////////////////////////////////////////////////////////////////////
 
 /*
- * Dispatch table size and mask
+ * Initial dispatch table size, which should be a power of 2
  */
-#define DTABLE_SIZE 64 // Should be power of 2
-#define DTABLE_MASK (DTABLE_SIZE - 1)
+#define DTABLE_SIZE 16
 
-///////////////////////////////////////////////////////////////////////////////
+// Serializes writers to the dispatch tables. Readers do not take the lock.
+static sys_mutex_t dtable_lock;
 
-/*
- * Convert a pointer to a hash value in the range [0..DTABLE_SIZE-1]
- */
-static inline uint32_t _objc_dtable_hash_ptr(void *sel_id) {
-  uintptr_t p = (uintptr_t)sel_id;
-  return (uint32_t)((p >> 3) ^ (p >> 12)) & DTABLE_MASK;
-}
+// Number of classes with a dispatch table
+static uint32_t dtable_count = 0;
+
+// Tables which have been flushed, which are never freed since other threads
+// may still be reading them
+static struct objc_dtable *dtable_retired = NULL;
 
 ///////////////////////////////////////////////////////////////////////////////
-// PUBLIC API
+// PRIVATE METHODS
 
 /*
- * Create a new dispatch table for the class
+ * Allocate an empty dispatch table with the given number of slots
  */
-bool _objc_dtable_init(Class cls) {
-  if (cls->dtable != NULL) {
-    return false; // Dispatch table already exists
-  }
-
-  cls->dtable = sys_malloc(sizeof(void *) * DTABLE_SIZE);
-  if (cls->dtable == NULL) {
-    return false; // Memory allocation failed
+static struct objc_dtable *_objc_dtable_new(uint32_t size) {
+  struct objc_dtable *dtable = sys_malloc(
+      sizeof(struct objc_dtable) + sizeof(struct objc_dtable_entry) * size);
+  if (dtable == NULL) {
+    return NULL; // Memory allocation failed
   }
-  for (int i = 0; i < DTABLE_SIZE; i++) {
-    cls->dtable[i] = NULL;
+  dtable->mask = size - 1;
+  dtable->count = 0;
+  dtable->retired = NULL;
+  for (uint32_t i = 0; i < size; i++) {
+    dtable->entries[i].sel_id = NULL;
+    dtable->entries[i].imp = NULL;
   }
-
-  // Return success
-  return true;
+  return dtable;
 }
 
 /*
- * Check whether an IMP exists in the dispatch table
+ * Insert an entry into a table (linear probing). The entry IMP is written
+ * before the selector, so a reader which sees the selector also sees the IMP.
  */
-bool _objc_dtable_exists(Class cls, void *sel_id) {
-  if (cls->dtable == NULL) {
-    return false;
+static void _objc_dtable_insert(struct objc_dtable *dtable, const void *sel_id,
+                                IMP imp) {
+  uint32_t idx = _objc_dtable_hash(sel_id) & dtable->mask;
+  for (;;) {
+    struct objc_dtable_entry *entry = &dtable->entries[idx];
+    if (entry->sel_id == sel_id) {
+      return; // Already exists
+    }
+    if (entry->sel_id == NULL) {
+      entry->imp = imp;
+      __atomic_store_n(&entry->sel_id, sel_id, __ATOMIC_RELEASE);
+      dtable->count++;
+      return;
+    }
+    idx = (idx + 1) & dtable->mask;
   }
+}
 
-  uint32_t hash = _objc_dtable_hash_ptr(sel_id);
-  for (int i = 0; i < DTABLE_SIZE; i++) {
-    uint32_t idx = (hash + (uint32_t)i) & DTABLE_MASK;
-    void *entry = cls->dtable[idx];
+///////////////////////////////////////////////////////////////////////////////
+// PUBLIC API
 
-    if (entry == sel_id)
-      return true;
-    if (entry == NULL)
-      return false; // Hit empty slot, not found
+/*
+ * Initialize the dispatch table lock
+ */
+void _objc_dtable_init(void) {
+  static BOOL init = NO;
+  if (init) {
+    return; // Already initialized
   }
-  return false; // Table full but not found
+  init = YES;
+  dtable_lock = sys_mutex_init();
 }
 
 /*
- * Add an IMP to the dispatch table (linear probing). No deletes supported.
+ * Add an IMP to the dispatch table for a class
  */
-bool _objc_dtable_add(Class cls, void *sel_id) {
-  if (cls->dtable == NULL) {
-    return false;
+bool _objc_dtable_add(Class cls, SEL sel, IMP imp) {
+  sys_mutex_lock(&dtable_lock);
+  struct objc_dtable *dtable = cls->dtable;
+  if (dtable == NULL) {
+    dtable = _objc_dtable_new(DTABLE_SIZE);
+    if (dtable == NULL) {
+      sys_mutex_unlock(&dtable_lock);
+      return false;
+    }
+    __atomic_store_n(&cls->dtable, dtable, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&dtable_count, 1, __ATOMIC_RELEASE);
+  } else if ((dtable->count + 1) * 4 > (dtable->mask + 1) * 3) {
+    // Grow the table by copying the entries into a table of twice the size.
+    // Other threads may still be reading the old table, so it is retired
+    // rather than freed.
+    struct objc_dtable *grown = _objc_dtable_new((dtable->mask + 1) * 2);
+    if (grown == NULL) {
+      sys_mutex_unlock(&dtable_lock);
+      return false;
+    }
+    for (uint32_t i = 0; i <= dtable->mask; i++) {
+      if (dtable->entries[i].sel_id != NULL) {
+        _objc_dtable_insert(grown, dtable->entries[i].sel_id,
+                            dtable->entries[i].imp);
+      }
+    }
+    grown->retired = dtable;
+    __atomic_store_n(&cls->dtable, grown, __ATOMIC_RELEASE);
+    dtable = grown;
   }
+  _objc_dtable_insert(dtable, sel->sel_id, imp);
+  sys_mutex_unlock(&dtable_lock);
+  return true;
+}
 
-  uint32_t hash = _objc_dtable_hash_ptr(sel_id);
-  for (int i = 0; i < DTABLE_SIZE; i++) {
-    uint32_t idx = (hash + (uint32_t)i) & DTABLE_MASK;
-
-    if (cls->dtable[idx] == NULL) {
-      cls->dtable[idx] = sel_id;
-      return true;
-    }
-    if (cls->dtable[idx] == sel_id) {
-      return true; // Already exists
+/*
+ * Remove all entries from the dispatch table for a class. Other threads may
+ * still be reading the table, so it is retired with the tables it replaced
+ * rather than freed.
+ */
+void _objc_dtable_flush(Class cls) {
+  sys_mutex_lock(&dtable_lock);
+  struct objc_dtable *dtable = cls->dtable;
+  if (dtable != NULL) {
+    __atomic_store_n(&cls->dtable, NULL, __ATOMIC_RELEASE);
+    __atomic_sub_fetch(&dtable_count, 1, __ATOMIC_RELEASE);
+    struct objc_dtable *last = dtable;
+    while (last->retired != NULL) {
+      last = last->retired;
     }
+    last->retired = dtable_retired;
+    dtable_retired = dtable;
   }
-  // Should never reach here with proper load factor
-  return false;
+  sys_mutex_unlock(&dtable_lock);
+}
+
+/*
+ * Returns the number of classes which have a dispatch table
+ */
+uint32_t _objc_dtable_count(void) {
+  return __atomic_load_n(&dtable_count, __ATOMIC_ACQUIRE);
 }
@@ -5,16 +5,80 @@
 // Dispatch Table
 
 /*
- * Create a new dispatch table for the class
+ * A dispatch table entry, mapping a unique selector name to the
+ * implementation which should be called when the selector is sent to an
+ * instance of the class.
  */
-bool _objc_dtable_init(Class cls);
+struct objc_dtable_entry {
+  const void *sel_id; // Unique selector name, or NULL if the slot is empty
+  IMP imp;            // Implementation, which may be inherited from a superclass
+};
 
 /*
- * Check whether an IMP exists in the dispatch table
+ * A per-class dispatch table. The table is an open-addressed hash table with
+ * linear probing, which is never more than three-quarters full. Entries are
+ * never removed, and a table which needs to grow is replaced by a larger copy.
  */
-bool _objc_dtable_exists(Class cls, void *sel_id);
+struct objc_dtable {
+  uint32_t mask;                // Number of slots minus one
+  uint32_t count;               // Number of occupied slots
+  struct objc_dtable *retired;  // Table replaced by this one, or flushed
+  struct objc_dtable_entry entries[];
+};
 
 /*
- * Add an IMP to the dispatch table (linear probing). No deletes supported.
+ * Convert a unique selector name to a hash value, which needs to be masked by
+ * the size of the table. Names are not aligned, so the low bits are kept.
  */
-bool _objc_dtable_add(Class cls, void *sel_id);
+static inline uint32_t _objc_dtable_hash(const void *sel_id) {
+  uintptr_t p = (uintptr_t)sel_id;
+  return (uint32_t)(p ^ (p >> 7) ^ (p >> 14));
+}
+
+/*
+ * Return the cached IMP for a selector, or NULL if the selector is not in the
+ * dispatch table for the class. This is safe to call without holding a lock.
+ */
+static inline IMP _objc_dtable_lookup(Class cls, SEL sel) {
+  struct objc_dtable *dtable = __atomic_load_n(&cls->dtable, __ATOMIC_ACQUIRE);
+  if (dtable == NULL) {
+    return NULL;
+  }
+  const void *sel_id = sel->sel_id;
+  uint32_t idx = _objc_dtable_hash(sel_id) & dtable->mask;
+  for (;;) {
+    struct objc_dtable_entry *entry = &dtable->entries[idx];
+    const void *key = __atomic_load_n(&entry->sel_id, __ATOMIC_ACQUIRE);
+    if (key == sel_id) {
+      return entry->imp;
+    }
+    if (key == NULL) {
+      return NULL; // Hit empty slot, not found
+    }
+    idx = (idx + 1) & dtable->mask;
+  }
+}
+
+/*
+ * Initialize the dispatch table lock
+ */
+void _objc_dtable_init(void);
+
+/*
+ * Add an IMP to the dispatch table for a class, creating or growing the table
+ * as necessary. Returns false if memory could not be allocated.
+ */
+bool _objc_dtable_add(Class cls, SEL sel, IMP imp);
+
+/*
+ * Remove all entries from the dispatch table for a class. This should only be
+ * called when methods are added to a class which has already been sent
+ * messages, which normally happens while categories are loaded.
+ */
+void _objc_dtable_flush(Class cls);
+
+/*
+ * Returns the number of classes which have a dispatch table. When it is zero,
+ * no class has been sent a message, and there are no tables to flush.
+ */
+uint32_t _objc_dtable_count(void);
@@ -1,16 +1,126 @@
 #include "hash.h"
 #include <objc/objc.h>
 #include <runtime-sys/sys.h>
-#include <string.h>
 
-#define HASH_TABLE_SIZE 512
-struct objc_hashitem hash_table[HASH_TABLE_SIZE + 1];
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Initial hash table size, which should be a power of 2
+ */
+#define HASH_TABLE_SIZE 256
+
+/*
+ * The table grows when more than half of the slots are occupied, so that a
+ * lookup which misses (which happens for every superclass searched) stays
+ * short.
+ */
+#define HASH_TABLE_LOAD(count, size) ((count) * 2 > (size))
 
-static size_t __objc_hash_compute(objc_class_t *cls, const char *method,
-                                  const char *types);
+/*
+ * A method hash table. Tables which have been replaced by a larger table are
+ * retired rather than freed, since lookups do not take the lock and may still
+ * be reading them.
+ */
+struct objc_hashtable {
+  uint32_t mask;                  // Number of slots minus one
+  uint32_t count;                 // Number of occupied slots
+  struct objc_hashtable *retired; // Smaller table replaced by this one
+  struct objc_hashitem items[];
+};
 
-static BOOL __objc_hash_match(struct objc_hashitem *item, objc_class_t *cls,
-                              const char *method, const char *types);
+static struct objc_hashtable *hash_table = NULL;
+static sys_mutex_t hash_lock;
+
+static uint32_t __objc_hash_compute(objc_class_t *cls, const char *method);
+static struct objc_hashitem *__objc_hash_insert(struct objc_hashtable *table,
+                                                objc_class_t *cls,
+                                                const char *method,
+                                                const char *types, IMP imp,
+                                                uint32_t hash);
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE METHODS
+
+/*
+ * Allocate an empty hash table with the given number of slots
+ */
+static struct objc_hashtable *__objc_hash_new(uint32_t size) {
+  struct objc_hashtable *table = sys_malloc(sizeof(struct objc_hashtable) +
+                                            sizeof(struct objc_hashitem) * size);
+  if (table == NULL) {
+    return NULL; // Memory allocation failed
+  }
+  table->mask = size - 1;
+  table->count = 0;
+  table->retired = NULL;
+  for (uint32_t i = 0; i < size; i++) {
+    table->items[i].cls = NULL;
+  }
+  return table;
+}
+
+/*
+ * Replace the hash table with one of twice the size, reusing the stored
+ * hashes. Returns NO if memory could not be allocated.
+ */
+static BOOL __objc_hash_grow() {
+  struct objc_hashtable *grown = __objc_hash_new((hash_table->mask + 1) * 2);
+  if (grown == NULL) {
+    return NO;
+  }
+  for (uint32_t i = 0; i <= hash_table->mask; i++) {
+    struct objc_hashitem *item = &hash_table->items[i];
+    if (item->cls != NULL) {
+      __objc_hash_insert(grown, item->cls, item->method, item->types,
+                         item->imp, item->hash);
+    }
+  }
+  grown->retired = hash_table;
+  __atomic_store_n(&hash_table, grown, __ATOMIC_RELEASE);
+  return YES;
+}
+
+/*
+ * Insert or replace an item in a table (linear probing). The class is written
+ * last, so a reader which sees the class also sees the rest of the item.
+ */
+static struct objc_hashitem *__objc_hash_insert(struct objc_hashtable *table,
+                                                objc_class_t *cls,
+                                                const char *method,
+                                                const char *types, IMP imp,
+                                                uint32_t hash) {
+  uint32_t idx = hash & table->mask;
+  for (;;) {
+    struct objc_hashitem *item = &table->items[idx];
+    if (item->cls == NULL) {
+      item->method = method;
+      item->types = types;
+      item->imp = imp;
+      item->hash = hash;
+      __atomic_store_n(&item->cls, cls, __ATOMIC_RELEASE);
+      table->count++;
+      return item;
+    }
+    if (item->hash == hash && item->cls == cls && item->method == method) {
+      // Replace the existing implementation, for example from a category
+      item->types = types;
+      __atomic_store_n(&item->imp, imp, __ATOMIC_RELEASE);
+      return item;
+    }
+    idx = (idx + 1) & table->mask;
+  }
+}
+
+/*
+ * Compute the hash for a class and method. The class and method name are
+ * unique pointers, so the pointer values are mixed rather than the names.
+ */
+static uint32_t __objc_hash_compute(objc_class_t *cls, const char *method) {
+  uintptr_t hash = (uintptr_t)cls ^ ((uintptr_t)method * 31);
+  hash ^= hash >> 11;
+  hash ^= hash >> 17;
+  return (uint32_t)hash;
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -22,8 +132,10 @@ void __objc_hash_init() {
   init = YES;
 
   // Initialize the hash table
-  for (int i = 0; i <= HASH_TABLE_SIZE; i++) {
-    hash_table[i].cls = NULL;
+  hash_lock = sys_mutex_init();
+  hash_table = __objc_hash_new(HASH_TABLE_SIZE);
+  if (hash_table == NULL) {
+    sys_panicf("Failed to allocate method hash table");
   }
 }
 
@@ -33,96 +145,75 @@ void __objc_hash_init() {
 struct objc_hashitem *__objc_hash_register(objc_class_t *cls,
                                            const char *method,
                                            const char *types, IMP imp) {
-  size_t hash = __objc_hash_compute(cls, method, types);
-  size_t index = hash;
-  while (hash_table[hash].cls != NULL) {
-    // It we have matched the item exactly, then replace it
-    if (__objc_hash_match(&hash_table[hash], cls, method, types)) {
-      // Replace the existing item with the new implementation
-      struct objc_hashitem *item = &hash_table[hash];
-      item->imp = imp; // Update the implementation pointer
-      return item;     // Return the updated item
-    }
-
-    // Collision detected, find the next available slot
-    hash = (hash + 1) % HASH_TABLE_SIZE;
-    if (hash == index) {
+  uint32_t hash = __objc_hash_compute(cls, method);
+  sys_mutex_lock(&hash_lock);
+  if (HASH_TABLE_LOAD(hash_table->count + 1, hash_table->mask + 1)) {
+    if (!__objc_hash_grow()) {
+      sys_mutex_unlock(&hash_lock);
       return NULL;
     }
   }
-
-  // Insert the new hash item
-  struct objc_hashitem *item = &hash_table[hash];
-  item->cls = cls;
-  item->method = method;
-  item->types = types;
-  item->imp = imp;
-
-  // Return the newly registered item
+  struct objc_hashitem *item =
+      __objc_hash_insert(hash_table, cls, method, types, imp, hash);
+  sys_mutex_unlock(&hash_lock);
   return item;
 }
 
-/*
- * Return YES if the hash item matches the class and method
- * it will also return NO if types is not null and the types
- * do not match
- */
-inline static BOOL __objc_hash_match(struct objc_hashitem *item,
-                                     objc_class_t *cls, const char *method,
-                                     const char *types) {
-  if (types) {
-    // Prefer to match types if provided
-    return item->cls == cls && item->method != NULL && method != NULL &&
-           strcmp(item->method, method) == 0 && item->types != NULL &&
-           strcmp(item->types, types) == 0;
-  } else {
-    return item->cls == cls && item->method != NULL && method != NULL &&
-           strcmp(item->method, method) == 0;
-  }
-}
-
 /*
  * Lookup an implementation for a method in the hash table
  */
-struct objc_hashitem *__objc_hash_lookup(objc_class_t *cls, const char *method,
-                                         const char *types) {
-  size_t hash = __objc_hash_compute(cls, method, types);
-  size_t index = hash;
-  while (hash_table[hash].cls != NULL) {
-    // Check if the class, method, and types match
-    if (__objc_hash_match(&hash_table[hash], cls, method, types)) {
-      // Found a match
-      return &hash_table[hash];
+struct objc_hashitem *__objc_hash_lookup(objc_class_t *cls,
+                                         const char *method) {
+  struct objc_hashtable *table =
+      __atomic_load_n(&hash_table, __ATOMIC_ACQUIRE);
+  if (table == NULL) {
+    return NULL;
+  }
+  uint32_t hash = __objc_hash_compute(cls, method);
+  uint32_t idx = hash & table->mask;
+  for (;;) {
+    struct objc_hashitem *item = &table->items[idx];
+    objc_class_t *item_cls = __atomic_load_n(&item->cls, __ATOMIC_ACQUIRE);
+    if (item_cls == NULL) {
+      return NULL; // Hit empty slot, not found
     }
-    // Increment the hash to check the next item
-    hash = (hash + 1) % HASH_TABLE_SIZE;
-    if (hash == index) {
-      return NULL;
+    if (item->hash == hash && item_cls == cls && item->method == method) {
+      return item;
     }
+    idx = (idx + 1) & table->mask;
   }
-
-  // If we exited the loop because we found an empty slot, method not found
-  return NULL;
 }
 
-static size_t __objc_hash_compute(objc_class_t *cls, const char *method,
-                                  const char *types) {
-  size_t hash = 0;
-  for (const char *p = cls->name; *p; p++) {
-    hash = (hash * 31) + *p;
-  }
-  if (cls->info & objc_class_flag_meta) {
-    hash += 0x10000; // Meta class flag
+/*
+ * Print statistics about the hash table
+ */
+void __objc_hash_stats() {
+  sys_mutex_lock(&hash_lock);
+  struct objc_hashtable *table = hash_table;
+  if (table == NULL) {
+    sys_mutex_unlock(&hash_lock);
+    return;
   }
-  if (method != NULL) {
-    for (const char *p = method; *p; p++) {
-      hash = (hash * 31) + *p;
+
+  // The probe length of an item is the distance from its home slot, plus one
+  uint32_t size = table->mask + 1;
+  uint32_t probes = 0;
+  uint32_t max_probe = 0;
+  for (uint32_t i = 0; i < size; i++) {
+    struct objc_hashitem *item = &table->items[i];
+    if (item->cls == NULL) {
+      continue;
     }
-  }
-  if (types != NULL) {
-    for (const char *p = types; *p; p++) {
-      hash = (hash * 31) + *p;
+    uint32_t probe = ((i - item->hash) & table->mask) + 1;
+    probes += probe;
+    if (probe > max_probe) {
+      max_probe = probe;
     }
   }
-  return hash % HASH_TABLE_SIZE;
+  sys_printf("objc_hash: %u/%u slots used (%u%%), probes avg=%u.%02u max=%u\n",
+             table->count, size, table->count * 100 / size,
+             table->count ? probes / table->count : 0,
+             table->count ? (probes * 100 / table->count) % 100 : 0,
+             max_probe);
+  sys_mutex_unlock(&hash_lock);
 }
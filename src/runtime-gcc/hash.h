@@ -2,15 +2,15 @@
 #include "class.h"
 
 /*
- * Objective-C runtime hash table for selectors.
- * This structure is used to store and manage selectors in the Objective-C
- * runtime.
+ * Objective-C runtime hash table for methods. Each item maps a class and a
+ * unique selector name to the implementation registered for the class.
  */
 struct objc_hashitem {
-  objc_class_t *cls;  // Pointer to the class that owns this selector
-  const char *method; // Key for the selector, typically the selector name
-  const char *types;  // Types encoding for the selector
-  IMP imp;            // Implementation pointer for the selector
+  objc_class_t *cls;  // Pointer to the class that owns this method, or NULL
+  const char *method; // Key for the selector, which is the unique name
+  const char *types;  // Types encoding for the method
+  IMP imp;            // Implementation pointer for the method
+  uint32_t hash;      // Hash of the class and method, computed on registration
 };
 
 /*
@@ -21,16 +21,24 @@ struct objc_hashitem {
 void __objc_hash_init();
 
 /*
- * Register a new selector in the hash table. This function adds a new method to
- * the hash table, allowing it to be looked up later. Returns nil on failure, or
- * a pointer to the newly registered hash item on success.
+ * Register a method in the hash table. If the class already has a method with
+ * the same name, the implementation is replaced. Returns NULL if memory could
+ * not be allocated, or a pointer to the registered hash item on success.
  */
 struct objc_hashitem *__objc_hash_register(objc_class_t *cls,
                                            const char *method,
                                            const char *types, IMP imp);
 
 /*
- * Lookup an implementation for a method in the hash table
+ * Lookup a method for a class in the hash table. The method name must be the
+ * unique selector name. Superclasses are not searched. Returns NULL if the
+ * class does not implement the method.
  */
-struct objc_hashitem *__objc_hash_lookup(objc_class_t *cls, const char *method,
-                                         const char *types);
\ No newline at end of file
+struct objc_hashitem *__objc_hash_lookup(objc_class_t *cls,
+                                         const char *method);
+
+/*
+ * Print statistics about the hash table: the number of slots and methods,
+ * and the average and longest probe lengths.
+ */
+void __objc_hash_stats();
@@ -1,27 +1,77 @@
 #include "api.h"
 #include "category.h"
 #include "class.h"
+#include "dtable.h"
 #include "hash.h"
+#include "message.h"
+#include "profile.h"
+#include "selector.h"
 #include "statics.h"
 #include <objc/objc.h>
 #include <runtime-sys/sys.h>
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Serializes loading of categories and statics, and +initialize. The lock is
+// held while +initialize runs, and can be entered again by the owning thread,
+// so that +initialize can send messages to other classes.
+static sys_mutex_t initialize_lock;
+static uintptr_t initialize_owner = 0;
+static uint32_t initialize_depth = 0;
+
+///////////////////////////////////////////////////////////////////////////////
+
 // This function is called when a message is sent to a nil object.
 static id __objc_nil_method(id receiver, SEL selector OBJC_UNUSED) {
   return receiver;
 }
 
+/*
+ * Returns YES if the class has been sent +initialize, which is recorded on the
+ * metaclass.
+ */
+static inline BOOL __objc_class_is_initialized(objc_class_t *cls) {
+  objc_class_t *meta_cls =
+      cls->info & objc_class_flag_meta ? cls : cls->metaclass;
+  return (__atomic_load_n(&meta_cls->info, __ATOMIC_ACQUIRE) &
+          objc_class_flag_initialized)
+             ? YES
+             : NO;
+}
+
+/*
+ * Acquire the initialize lock, which may already be held by this thread
+ */
+static void __objc_initialize_lock() {
+  uintptr_t self = sys_thread_id();
+  if (__atomic_load_n(&initialize_owner, __ATOMIC_RELAXED) != self) {
+    sys_mutex_lock(&initialize_lock);
+    __atomic_store_n(&initialize_owner, self, __ATOMIC_RELAXED);
+  }
+  initialize_depth++;
+}
+
+/*
+ * Release the initialize lock
+ */
+static void __objc_initialize_unlock() {
+  if (--initialize_depth == 0) {
+    __atomic_store_n(&initialize_owner, 0, __ATOMIC_RELAXED);
+    sys_mutex_unlock(&initialize_lock);
+  }
+}
+
 static IMP __objc_msg_lookup(objc_class_t *cls, SEL selector) {
   if (cls == Nil || selector == NULL) {
     return NULL; // Invalid parameters
   }
 
-  // TODO: Initialize the dispatch table for the class if it doesn't exist
-  // Consider mutex in multi-threaded environment
-  // TODO: Lookup selector->sel_id in the dispatch table first
-  // If found, return the IMP directly
+  // Lookup the selector in the dispatch table first, and if found, return the
+  // IMP directly
+  IMP imp = _objc_dtable_lookup(cls, selector);
+  if (imp != NULL) {
+    return imp;
+  }
 
 #ifdef OBJCDEBUG
   sys_printf("objc_msg_lookup %c[%s %s]\n",
@@ -30,39 +80,52 @@ static IMP __objc_msg_lookup(objc_class_t *cls, SEL selector) {
 #endif
 
   // Descend through the classes looking for the method
-  // TODO: Also look at the categories of the class
-  while (cls != Nil) {
+  uint32_t hops = 0;
+  for (objc_class_t *cur = cls; cur != Nil; cur = cur->superclass, hops++) {
 #ifdef OBJCDEBUG
     sys_printf("  %c[%s %s] types=%s\n",
-               cls->info & objc_class_flag_meta ? '+' : '-', cls->name,
+               cur->info & objc_class_flag_meta ? '+' : '-', cur->name,
                sel_getName(selector), selector->sel_type);
 #endif
-    struct objc_hashitem *item =
-        __objc_hash_lookup(cls, selector->sel_id, selector->sel_type);
+    struct objc_hashitem *item = __objc_hash_lookup(cur, selector->sel_id);
     if (item != NULL) {
-      // Consider mutex in multi-threaded environment
-      // TODO: Lookup selector->sel_id in the dispatch table first
-      // If found, return the IMP directly
-      return item->imp; // Return the implementation pointer
+      imp = item->imp;
+      break;
     }
-    cls = cls->superclass;
   }
+#ifdef OBJCPROFILE
+  __objc_profile_lookup(cls, selector, hops);
+#else
+  (void)hops;
+#endif
 
-  return NULL; // Method not found
+  // Cache the IMP in the dispatch table of the class the lookup started
+  // from, so inherited methods are found without descending next time. Only
+  // initialized classes have dispatch tables, so that a dispatch table hit
+  // does not need to check the class has been initialized.
+  if (imp != NULL && __objc_class_is_initialized(cls)) {
+    _objc_dtable_add(cls, selector, imp);
+  }
+
+  return imp;
 }
 
+/*
+ * Send +initialize to a class, after its superclasses. The initialize lock
+ * must be held.
+ */
 static void __objc_send_initialize(objc_class_t *cls) {
   if (cls == Nil) {
     return;
   }
 
-  // Don't call initialize on the same class twice
-  if (cls->info & objc_class_flag_initialized) {
+  // Don't call initialize on the same class twice. A class which is
+  // initializing is running +initialize on this thread, which holds the lock.
+  if (cls->info & (objc_class_flag_initialized | objc_class_flag_initializing)) {
     return;
   }
-
-  // Mark the class as initialized early to prevent recursion
-  cls->info |= objc_class_flag_initialized;
+  __atomic_fetch_or(&cls->info, objc_class_flag_initializing,
+                    __ATOMIC_RELAXED);
 
   // If the superclass has an initialize method, call it first
   if (cls->superclass) {
@@ -70,11 +133,16 @@ static void __objc_send_initialize(objc_class_t *cls) {
   }
 
   // Find and call the initialize method
-  static struct objc_selector initialize = {
-      .sel_id = "initialize", // The selector for the initialize method
-      .sel_type = "v16@0:8"   // The type encoding for the initialize method
-  };
-  IMP imp = __objc_msg_lookup(cls, &initialize); // Lookup the initialize method
+  SEL initialize = sel_registerName("initialize");
+
+#ifdef OBJCDEBUG
+  sys_printf("  +[%s initialize] \n", cls->name);
+#endif
+#ifdef OBJCPROFILE
+  __objc_profile_initialize(cls, initialize);
+#endif
+
+  IMP imp = __objc_msg_lookup(cls, initialize); // Lookup the initialize method
   if (imp != NULL) {
     // Call the initialize method - suppress function cast warning as this is a
     // legitimate cast from variadic IMP to non-variadic function for
@@ -82,29 +150,51 @@ static void __objc_send_initialize(objc_class_t *cls) {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wcast-function-type"
     ((void (*)(id, SEL))imp)(
-        (id)cls, &initialize); // Call the initialize method on the class
+        (id)cls, initialize); // Call the initialize method on the class
 #pragma GCC diagnostic pop
   }
+
+  // Mark the class as initialized. Other threads which see the flag, or a
+  // dispatch table, also see the effects of +initialize.
+  __atomic_fetch_or(&cls->info, objc_class_flag_initialized, __ATOMIC_RELEASE);
+  __atomic_fetch_and(&cls->info, ~(unsigned long)objc_class_flag_initializing,
+                     __ATOMIC_RELAXED);
 }
 
-/**
- * Message dispatch function. Returns the implementation pointer for
- * the specified selector. Returns the nil_method if the receiver is nil,
- * and panics if the selector is not found.
+/*
+ * Make sure a class has been sent +initialize. The first class to be
+ * initialized also loads static instances and categories, so once this
+ * returns no more methods will be added to the class.
  */
-IMP objc_msg_lookup(id receiver, SEL selector) {
-  if (receiver == NULL) {
-    return (IMP)__objc_nil_method;
+static void __objc_class_initialize(objc_class_t *cls) {
+  if (__objc_class_is_initialized(cls)) {
+    return;
   }
+  __objc_initialize_lock();
 
   // First load the static instances and categories
-  static BOOL init = NO;
-  if (init == NO) {
-    init = YES; // Set init to YES to prevent multiple initializations
+  static BOOL loaded = NO;
+  if (loaded == NO) {
+    loaded = YES;
     __objc_statics_load();
     __objc_category_load();
+#ifdef OBJCDEBUG
+    __objc_hash_stats();
+#endif
   }
 
+  // Call the class's initialize method
+  __objc_send_initialize(cls->info & objc_class_flag_meta ? cls
+                                                           : cls->metaclass);
+  __objc_initialize_unlock();
+}
+
+/*
+ * Dispatch a message which is not in the dispatch table of the receiver's
+ * class. The first message sent loads static instances and categories, and
+ * the first message sent to a class sends it +initialize.
+ */
+static IMP __objc_msg_lookup_slow(id receiver, SEL selector) {
   // Get the class of the receiver
   objc_class_t *cls = receiver->isa;
   if (cls == Nil) {
@@ -113,32 +203,59 @@ IMP objc_msg_lookup(id receiver, SEL selector) {
     return NULL;
   }
 
+  // If the class of the receiver has not been initialized, then this is the
+  // time to do it
+  __objc_class_initialize(cls);
+
   IMP imp = __objc_msg_lookup(cls, selector);
   if (imp == NULL) {
     sys_panicf(
         "objc_msg_lookup: class=%c[%s %s] selector->types=%s cannot send "
         "message\n",
-        receiver->isa->info & objc_class_flag_meta ? '+' : '-',
-        receiver->isa->name, sel_getName(selector), selector->sel_type);
+        cls->info & objc_class_flag_meta ? '+' : '-', cls->name,
+        sel_getName(selector), selector->sel_type);
   } else {
 #ifdef OBJCDEBUG
     sys_printf("    => IMP @%p\n", imp);
 #endif
   }
+  return imp;
+}
 
-  // If the class has of the receiver not been initialized, then this is the
-  // time to do it
-  objc_class_t *meta_cls =
-      cls->info & objc_class_flag_meta ? cls : cls->metaclass;
-  if (!(meta_cls->info & objc_class_flag_initialized)) {
-#ifdef OBJCDEBUG
-    sys_printf("  +[%s initialize] \n", cls->name);
+///////////////////////////////////////////////////////////////////////////////
+
+void __objc_message_init() {
+  static BOOL init = NO;
+  if (init) {
+    return; // Already initialized
+  }
+  init = YES;
+  initialize_lock = sys_mutex_init();
+#ifdef OBJCPROFILE
+  __objc_profile_init();
 #endif
-    // Call the class's initialize method
-    __objc_send_initialize(meta_cls);
+}
+
+/**
+ * Message dispatch function. Returns the implementation pointer for
+ * the specified selector. Returns the nil_method if the receiver is nil,
+ * and panics if the selector is not found.
+ */
+IMP objc_msg_lookup(id receiver, SEL selector) {
+  if (receiver == NULL) {
+    return (IMP)__objc_nil_method;
   }
+#ifdef OBJCPROFILE
+  __objc_profile_send(receiver->isa, selector);
+#endif
 
-  return imp;
+  // Only initialized classes have dispatch tables, so a hit can be returned
+  // without any further checks
+  IMP imp = _objc_dtable_lookup(receiver->isa, selector);
+  if (imp != NULL) {
+    return imp;
+  }
+  return __objc_msg_lookup_slow(receiver, selector);
 }
 
 /**
@@ -150,6 +267,9 @@ IMP objc_msg_lookup_super(struct objc_super *super, SEL selector) {
   if (super == NULL || super->receiver == nil) {
     return NULL;
   }
+#ifdef OBJCPROFILE
+  __objc_profile_send(super->superclass, selector);
+#endif
   IMP imp = __objc_msg_lookup(super->superclass, selector);
   if (imp == NULL) {
     sys_panicf(
@@ -197,6 +317,31 @@ BOOL object_respondsToSelector(id object, SEL selector) {
   return __objc_msg_lookup(cls, selector) == NULL ? NO : YES;
 }
 
+IMP class_getMethodImplementation(Class cls, SEL selector) {
+  if (cls == Nil) {
+    return NULL;
+  }
+  if (selector == NULL) {
+    sys_panicf("class_getMethodImplementation: SEL is NULL");
+    return NULL;
+  }
+
+  // Initialize the class first, so that categories have been loaded and the
+  // IMP returned is the one a message send would use
+  __objc_class_initialize(cls);
+  return __objc_msg_lookup(cls, selector);
+}
+
+IMP class_getClassMethodImplementation(Class cls, SEL selector) {
+  if (cls == Nil) {
+    return NULL;
+  }
+  if (!(cls->info & objc_class_flag_meta)) {
+    cls = cls->metaclass; // Use the metaclass for class methods
+  }
+  return class_getMethodImplementation(cls, selector);
+}
+
 BOOL class_metaclassRespondsToSelector(Class cls, SEL selector) {
   if (cls == Nil) {
     return NO;
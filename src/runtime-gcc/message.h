@@ -0,0 +1,6 @@
+#pragma once
+
+/*
+ * Initializes the lock for message dispatch, which serializes +initialize
+ */
+void __objc_message_init();
@@ -1,8 +1,11 @@
 #include "api.h"
 #include "category.h"
 #include "class.h"
+#include "dtable.h"
 #include "hash.h"
+#include "message.h"
 #include "protocol.h"
+#include "selector.h"
 #include "statics.h"
 #include <objc/objc.h>
 #include <runtime-sys/sys.h>
@@ -16,17 +19,9 @@ static void __objc_module_register(struct objc_module *module) {
     return;
   }
 
-  // Replace referenced selectors from names to SEL's
-  struct objc_selector *refs = module->symtab->refs;
-  if (refs != NULL && module->symtab->sel_ref_cnt > 0) {
-#ifdef OBJCDEBUG
-    sys_printf("TODO: Replace selectors @%p (sel_ref_cnt=%ld)\n", refs,
-               module->symtab->sel_ref_cnt);
-#endif
-    // TODO: Implement actual selector replacement
-    // This should iterate through refs and replace sel_id strings with unique
-    // SEL pointers
-  }
+  // Replace referenced selectors from names to unique names
+  __objc_selector_register_refs(module->symtab->refs,
+                                module->symtab->sel_ref_cnt);
 
 #ifdef OBJCDEBUG
   sys_printf("__objc_module_register %s cls_def_cnt=%d cat_def_cnt=%d\n",
@@ -58,6 +53,9 @@ static void __objc_module_register(struct objc_module *module) {
 void __objc_exec_class(struct objc_module *module) {
   __objc_class_init();
   __objc_hash_init();
+  __objc_selector_init();
+  _objc_dtable_init();
+  __objc_message_init();
   __objc_statics_init();
   __objc_category_init();
   __objc_protocol_init();
@@ -1,24 +0,0 @@
-#include <objc/objc.h>
-
-/**
- * @brief Acquire a lock on the specified object for thread synchronization.
- * @param obj The object to lock. Should not be nil.
- * @return 0 on success, or a non-zero error code on failure.
- */
-int objc_sync_enter(id obj) {
-  // TODO: Implement actual synchronization
-  // For now, return success (no-op)
-  return 0;
-}
-
-/**
- * @brief Release a lock on the specified object.
- * @param obj The object to unlock. Must be the same object passed to
- * objc_sync_enter().
- * @return 0 on success, or a non-zero error code on failure.
- */
-int objc_sync_exit(id obj) {
-  // TODO: Implement actual synchronization
-  // For now, return success (no-op)
-  return 0;
-}
\ No newline at end of file
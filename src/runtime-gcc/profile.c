@@ -0,0 +1,258 @@
+#include "profile.h"
+#include "api.h"
+#include <objc/objc.h>
+#include <runtime-sys/sys.h>
+
+#ifdef OBJCPROFILE
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Number of counters, which should be a power of 2. Sends for a class and
+ * selector which do not fit in the table are counted as dropped.
+ */
+#ifdef SYSTEM_NAME_PICO
+#define PROFILE_TABLE_SIZE 256
+#else
+#define PROFILE_TABLE_SIZE 4096
+#endif
+
+/*
+ * Counters for a class and selector
+ */
+struct objc_profile_entry {
+  Class cls;           // Class of the receiver, or NULL if the slot is empty
+  const void *sel_id;  // Unique selector name
+  uint32_t sends;      // Number of messages sent
+  uint32_t lookups;    // Number of lookups which missed the dispatch table
+  uint32_t hops;       // Number of superclasses walked by those lookups
+  uint32_t initialize; // Number of times +initialize was sent
+};
+
+static struct objc_profile_entry profile_table[PROFILE_TABLE_SIZE];
+static uint32_t profile_dropped = 0;
+static sys_mutex_t profile_lock;
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE METHODS
+
+static inline uint32_t __objc_profile_hash(Class cls, const void *sel_id) {
+  uintptr_t hash = (uintptr_t)cls ^ ((uintptr_t)sel_id * 31);
+  hash ^= hash >> 11;
+  return (uint32_t)hash & (PROFILE_TABLE_SIZE - 1);
+}
+
+/*
+ * Return the counters for a class and selector, or NULL if they have not been
+ * added. Entries are found without the lock; the selector is written before
+ * the class, so a reader which sees the class also sees the selector.
+ */
+static struct objc_profile_entry *__objc_profile_find(Class cls,
+                                                      const void *sel_id) {
+  uint32_t start = __objc_profile_hash(cls, sel_id);
+  uint32_t idx = start;
+  do {
+    struct objc_profile_entry *entry = &profile_table[idx];
+    Class key = __atomic_load_n(&entry->cls, __ATOMIC_ACQUIRE);
+    if (key == NULL) {
+      break; // Not found
+    }
+    if (key == cls && entry->sel_id == sel_id) {
+      return entry;
+    }
+    idx = (idx + 1) & (PROFILE_TABLE_SIZE - 1);
+  } while (idx != start);
+  return NULL;
+}
+
+/*
+ * Return the counters for a class and selector, adding them if necessary.
+ * Returns NULL if the table is full.
+ */
+static struct objc_profile_entry *__objc_profile_entry(Class cls, SEL sel) {
+  const void *sel_id = sel->sel_id;
+  struct objc_profile_entry *entry = __objc_profile_find(cls, sel_id);
+  if (entry != NULL) {
+    return entry;
+  }
+
+  // Add the entry, checking again in case another thread added it
+  uint32_t start = __objc_profile_hash(cls, sel_id);
+  uint32_t idx = start;
+  sys_mutex_lock(&profile_lock);
+  do {
+    struct objc_profile_entry *slot = &profile_table[idx];
+    if (slot->cls == NULL) {
+      slot->sel_id = sel_id;
+      __atomic_store_n(&slot->cls, cls, __ATOMIC_RELEASE);
+      entry = slot;
+      break;
+    }
+    if (slot->cls == cls && slot->sel_id == sel_id) {
+      entry = slot;
+      break;
+    }
+    idx = (idx + 1) & (PROFILE_TABLE_SIZE - 1);
+  } while (idx != start);
+  sys_mutex_unlock(&profile_lock);
+
+  if (entry == NULL) {
+    __atomic_fetch_add(&profile_dropped, 1, __ATOMIC_RELAXED);
+  }
+  return entry;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void __objc_profile_init() {
+  static BOOL init = NO;
+  if (init) {
+    return; // Already initialized
+  }
+  init = YES;
+  profile_lock = sys_mutex_init();
+}
+
+void __objc_profile_send(Class cls, SEL sel) {
+  struct objc_profile_entry *entry = __objc_profile_entry(cls, sel);
+  if (entry != NULL) {
+    __atomic_fetch_add(&entry->sends, 1, __ATOMIC_RELAXED);
+  }
+}
+
+void __objc_profile_lookup(Class cls, SEL sel, uint32_t hops) {
+  struct objc_profile_entry *entry = __objc_profile_entry(cls, sel);
+  if (entry != NULL) {
+    __atomic_fetch_add(&entry->lookups, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&entry->hops, hops, __ATOMIC_RELAXED);
+  }
+}
+
+void __objc_profile_initialize(Class cls, SEL sel) {
+  struct objc_profile_entry *entry = __objc_profile_entry(cls, sel);
+  if (entry != NULL) {
+    __atomic_fetch_add(&entry->initialize, 1, __ATOMIC_RELAXED);
+  }
+}
+
+#endif // OBJCPROFILE
+
+///////////////////////////////////////////////////////////////////////////////
+// PUBLIC METHODS
+
+/**
+ * Print the message sends with the highest counts
+ */
+void objc_profile_dump(size_t limit) {
+#ifdef OBJCPROFILE
+  // Totals
+  uint32_t sends = 0, lookups = 0, hops = 0, entries = 0;
+  for (uint32_t i = 0; i < PROFILE_TABLE_SIZE; i++) {
+    struct objc_profile_entry *entry = &profile_table[i];
+    if (__atomic_load_n(&entry->cls, __ATOMIC_ACQUIRE) == NULL) {
+      continue;
+    }
+    sends += entry->sends;
+    lookups += entry->lookups;
+    hops += entry->hops;
+    entries++;
+  }
+  sys_printf("objc_profile: sends=%u lookups=%u hops=%u entries=%u "
+             "dropped=%u\n",
+             sends, lookups, hops, entries, profile_dropped);
+  if (limit == 0 || limit > entries) {
+    limit = entries;
+  }
+
+  // Print the entries in order of sends, then lookups. Each pass finds the
+  // largest entry which is smaller than the one printed before, so that the
+  // table does not need to be copied or sorted.
+  sys_printf("%10s %10s %6s %4s  %s\n", "sends", "lookups", "hops", "init",
+             "method");
+  struct objc_profile_entry *prev = NULL;
+  for (size_t n = 0; n < limit; n++) {
+    struct objc_profile_entry *best = NULL;
+    for (uint32_t i = 0; i < PROFILE_TABLE_SIZE; i++) {
+      struct objc_profile_entry *entry = &profile_table[i];
+      if (__atomic_load_n(&entry->cls, __ATOMIC_ACQUIRE) == NULL) {
+        continue;
+      }
+      // Order by sends, then lookups, then position in the table
+      if (prev != NULL &&
+          (entry->sends > prev->sends ||
+           (entry->sends == prev->sends &&
+            (entry->lookups > prev->lookups ||
+             (entry->lookups == prev->lookups && entry <= prev))))) {
+        continue; // Already printed
+      }
+      if (best == NULL || entry->sends > best->sends ||
+          (entry->sends == best->sends && entry->lookups > best->lookups)) {
+        best = entry;
+      }
+    }
+    if (best == NULL) {
+      break;
+    }
+    sys_printf("%10u %10u %6u %4u  %c[%s %s]\n", best->sends, best->lookups,
+               best->hops, best->initialize,
+               best->cls->info & objc_class_flag_meta ? '+' : '-',
+               best->cls->name, (const char *)best->sel_id);
+    prev = best;
+  }
+#else
+  (void)limit;
+  sys_printf("objc_profile: runtime was built without OBJC_PROFILE\n");
+#endif
+}
+
+/**
+ * Reset the profiling counters
+ */
+void objc_profile_reset(void) {
+#ifdef OBJCPROFILE
+  for (uint32_t i = 0; i < PROFILE_TABLE_SIZE; i++) {
+    struct objc_profile_entry *entry = &profile_table[i];
+    __atomic_store_n(&entry->sends, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&entry->lookups, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&entry->hops, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&entry->initialize, 0, __ATOMIC_RELAXED);
+  }
+  __atomic_store_n(&profile_dropped, 0, __ATOMIC_RELAXED);
+#endif
+}
+
+/**
+ * Return the counters for a class and selector
+ */
+BOOL objc_profile_counters(Class cls, SEL sel, uint32_t *sends,
+                           uint32_t *lookups, uint32_t *hops) {
+#ifdef OBJCPROFILE
+  struct objc_profile_entry *entry = NULL;
+  if (cls != Nil && sel != NULL) {
+    entry = __objc_profile_find(cls, sel->sel_id);
+  }
+  if (sends != NULL) {
+    *sends = entry ? __atomic_load_n(&entry->sends, __ATOMIC_RELAXED) : 0;
+  }
+  if (lookups != NULL) {
+    *lookups = entry ? __atomic_load_n(&entry->lookups, __ATOMIC_RELAXED) : 0;
+  }
+  if (hops != NULL) {
+    *hops = entry ? __atomic_load_n(&entry->hops, __ATOMIC_RELAXED) : 0;
+  }
+  return YES;
+#else
+  (void)cls;
+  (void)sel;
+  if (sends != NULL) {
+    *sends = 0;
+  }
+  if (lookups != NULL) {
+    *lookups = 0;
+  }
+  if (hops != NULL) {
+    *hops = 0;
+  }
+  return NO;
+#endif
+}
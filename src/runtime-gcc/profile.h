@@ -0,0 +1,34 @@
+#pragma once
+#include "api.h"
+
+///////////////////////////////////////////////////////////////////////////////////
+// METHODS
+
+/*
+ * The dispatch profiler is only built when OBJCPROFILE is defined. The
+ * counters are keyed by class and unique selector name.
+ */
+#ifdef OBJCPROFILE
+
+/*
+ * Initializes the dispatch profiler
+ */
+void __objc_profile_init();
+
+/*
+ * Count a message send to an instance of a class
+ */
+void __objc_profile_send(Class cls, SEL sel);
+
+/*
+ * Count a lookup which missed the dispatch table, and the number of
+ * superclasses walked to find the method
+ */
+void __objc_profile_lookup(Class cls, SEL sel, uint32_t hops);
+
+/*
+ * Count +initialize sent to a class
+ */
+void __objc_profile_initialize(Class cls, SEL sel);
+
+#endif // OBJCPROFILE
@@ -1,11 +1,217 @@
 #include "protocol.h"
 #include "api.h"
+#include "table.h"
 #include <objc/objc.h>
 #include <runtime-sys/sys.h>
-#include <string.h>
 
+/*
+ * Initial protocol table size, which should be a power of 2
+ */
 #define PROTOCOL_TABLE_SIZE 32
-objc_protocol_t *protocol_table[PROTOCOL_TABLE_SIZE + 1];
+
+/*
+ * Initial conformance cache size, which should be a power of 2
+ */
+#define PROTOCOL_CACHE_SIZE 64
+
+/*
+ * The cache grows when more than half of the slots are occupied
+ */
+#define PROTOCOL_CACHE_LOAD(count, size) ((count) * 2 > (size))
+
+/*
+ * A conformance cache entry, recording whether a class conforms to a
+ * protocol. The protocol is the pointer passed to class_conformsTo, which may
+ * be a copy of the registered protocol.
+ */
+struct objc_protocol_cache_entry {
+  Class cls;                 // Class
+  objc_protocol_t *protocol; // Protocol, or NULL if the slot is empty
+  uint32_t hash;             // Hash of the class and protocol
+  BOOL conforms;             // YES if the class conforms to the protocol
+};
+
+/*
+ * The conformance cache is an open-addressed hash table with linear probing.
+ * Entries are never removed, since the protocols adopted by a class do not
+ * change once it is loaded. Tables which have been replaced by a larger table
+ * are retired rather than freed, since lookups do not take the lock.
+ */
+struct objc_protocol_cache {
+  uint32_t mask;                       // Number of slots minus one
+  uint32_t count;                      // Number of occupied slots
+  struct objc_protocol_cache *retired; // Smaller table replaced by this one
+  struct objc_protocol_cache_entry entries[];
+};
+
+// Protocols, keyed by name
+static struct objc_table protocol_table;
+
+// Conformance cache, keyed by class and protocol
+static struct objc_protocol_cache *protocol_cache = NULL;
+static sys_mutex_t protocol_cache_lock;
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE METHODS
+
+/*
+ * Allocate an empty conformance cache with the given number of slots
+ */
+static struct objc_protocol_cache *__objc_protocol_cache_new(uint32_t size) {
+  struct objc_protocol_cache *cache =
+      sys_malloc(sizeof(struct objc_protocol_cache) +
+                 sizeof(struct objc_protocol_cache_entry) * size);
+  if (cache == NULL) {
+    return NULL; // Memory allocation failed
+  }
+  cache->mask = size - 1;
+  cache->count = 0;
+  cache->retired = NULL;
+  for (uint32_t i = 0; i < size; i++) {
+    cache->entries[i].protocol = NULL;
+  }
+  return cache;
+}
+
+/*
+ * Compute the hash for a class and protocol from their pointer values
+ */
+static inline uint32_t __objc_protocol_cache_hash(Class cls,
+                                                  objc_protocol_t *protocol) {
+  uintptr_t hash = ((uintptr_t)cls >> 3) ^ ((uintptr_t)protocol * 31);
+  hash ^= hash >> 11;
+  hash ^= hash >> 17;
+  return (uint32_t)hash;
+}
+
+/*
+ * Insert an entry into a cache (linear probing), unless the class and
+ * protocol are already in the cache. The protocol is written last, so a
+ * reader which sees the protocol also sees the rest of the entry.
+ */
+static void __objc_protocol_cache_insert(struct objc_protocol_cache *cache,
+                                         Class cls, objc_protocol_t *protocol,
+                                         uint32_t hash, BOOL conforms) {
+  uint32_t idx = hash & cache->mask;
+  for (;;) {
+    struct objc_protocol_cache_entry *entry = &cache->entries[idx];
+    if (entry->protocol == NULL) {
+      entry->cls = cls;
+      entry->hash = hash;
+      entry->conforms = conforms;
+      __atomic_store_n(&entry->protocol, protocol, __ATOMIC_RELEASE);
+      cache->count++;
+      return;
+    }
+    if (entry->cls == cls && entry->protocol == protocol) {
+      return; // Already cached by another thread
+    }
+    idx = (idx + 1) & cache->mask;
+  }
+}
+
+/*
+ * Return the cache entry for a class and protocol, or NULL if the
+ * conformance has not been cached. This is safe to call without holding the
+ * lock.
+ */
+static struct objc_protocol_cache_entry *
+__objc_protocol_cache_lookup(Class cls, objc_protocol_t *protocol,
+                             uint32_t hash) {
+  struct objc_protocol_cache *cache =
+      __atomic_load_n(&protocol_cache, __ATOMIC_ACQUIRE);
+  if (cache == NULL) {
+    return NULL;
+  }
+  uint32_t idx = hash & cache->mask;
+  for (;;) {
+    struct objc_protocol_cache_entry *entry = &cache->entries[idx];
+    objc_protocol_t *key = __atomic_load_n(&entry->protocol, __ATOMIC_ACQUIRE);
+    if (key == NULL) {
+      return NULL; // Hit empty slot, not found
+    }
+    if (key == protocol && entry->cls == cls) {
+      return entry;
+    }
+    idx = (idx + 1) & cache->mask;
+  }
+}
+
+/*
+ * Add the conformance of a class to a protocol to the cache, growing the
+ * cache if necessary. If memory cannot be allocated, the result is not
+ * cached.
+ */
+static void __objc_protocol_cache_add(Class cls, objc_protocol_t *protocol,
+                                      uint32_t hash, BOOL conforms) {
+  sys_mutex_lock(&protocol_cache_lock);
+  struct objc_protocol_cache *cache = protocol_cache;
+  if (cache == NULL) {
+    sys_mutex_unlock(&protocol_cache_lock);
+    return;
+  }
+  if (PROTOCOL_CACHE_LOAD(cache->count + 1, cache->mask + 1)) {
+    struct objc_protocol_cache *grown =
+        __objc_protocol_cache_new((cache->mask + 1) * 2);
+    if (grown == NULL) {
+      sys_mutex_unlock(&protocol_cache_lock);
+      return;
+    }
+    for (uint32_t i = 0; i <= cache->mask; i++) {
+      struct objc_protocol_cache_entry *entry = &cache->entries[i];
+      if (entry->protocol != NULL) {
+        __objc_protocol_cache_insert(grown, entry->cls, entry->protocol,
+                                     entry->hash, entry->conforms);
+      }
+    }
+    grown->retired = cache;
+    __atomic_store_n(&protocol_cache, grown, __ATOMIC_RELEASE);
+    cache = grown;
+  }
+  __objc_protocol_cache_insert(cache, cls, protocol, hash, conforms);
+  sys_mutex_unlock(&protocol_cache_lock);
+}
+
+/*
+ * Return the registered protocol with the same name as a protocol. Each
+ * module which refers to a protocol has its own copy, and only the first copy
+ * loaded is registered. Returns the protocol itself if no protocol with the
+ * name has been registered.
+ */
+static objc_protocol_t *__objc_protocol_unique(objc_protocol_t *protocol) {
+  objc_protocol_t *unique = __objc_table_get(&protocol_table, protocol->name);
+  return unique != NULL ? unique : protocol;
+}
+
+/*
+ * Returns YES if a protocol is, or incorporates, another protocol. The
+ * incorporated protocols are uniqued before they are compared, since only
+ * the lists of protocols adopted by a class are uniqued when they are
+ * registered. If the other protocol is not registered, there is no unique
+ * copy of it, so protocols are compared by name instead of by pointer.
+ */
+static BOOL __objc_protocol_conforms(objc_protocol_t *protocol,
+                                     objc_protocol_t *other,
+                                     BOOL registered) {
+  if (protocol == other) {
+    return YES;
+  }
+  if (registered == NO && protocol->name != NULL && other->name != NULL &&
+      sys_strcmp(protocol->name, other->name) == 0) {
+    return YES;
+  }
+  for (struct objc_protocol_list *list = protocol->protocol_list;
+       list != NULL; list = list->next) {
+    for (size_t i = 0; i < list->count; i++) {
+      if (list->protocols[i] != NULL &&
+          __objc_protocol_conforms(__objc_protocol_unique(list->protocols[i]),
+                                   other, registered)) {
+        return YES;
+      }
+    }
+  }
+  return NO;
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -16,46 +222,42 @@ void __objc_protocol_init() {
   }
   init = YES;
 
-  for (int i = 0; i <= PROTOCOL_TABLE_SIZE; i++) {
-    protocol_table[i] = NULL;
+  if (!__objc_table_init(&protocol_table, PROTOCOL_TABLE_SIZE)) {
+    sys_panicf("Failed to allocate protocol table");
+  }
+  protocol_cache_lock = sys_mutex_init();
+  protocol_cache = __objc_protocol_cache_new(PROTOCOL_CACHE_SIZE);
+  if (protocol_cache == NULL) {
+    sys_panicf("Failed to allocate protocol cache");
   }
 }
 
-void __objc_protocol_register(objc_protocol_t *p) {
+objc_protocol_t *__objc_protocol_register(objc_protocol_t *p) {
   if (p == NULL || p->name == NULL) {
-    return;
+    return p;
   }
 #ifdef OBJCDEBUG
   sys_printf("__objc_protocol_register <%s>\n", p->name);
 #endif
-  for (int i = 0; i < PROTOCOL_TABLE_SIZE; i++) {
-    if (protocol_table[i] == p || protocol_table[i] == NULL) {
-      protocol_table[i] = p;
-      return;
-    }
-    if (strcmp(protocol_table[i]->name, p->name) == 0) {
-      sys_printf(
-          "Warning: Duplicate protocol named: %s. Registration skipped.\n",
-          p->name);
-      return;
-    }
+  objc_protocol_t *protocol = __objc_table_put(&protocol_table, p->name, p);
+  if (protocol == NULL) {
+    sys_panicf("Failed to register protocol: %s", p->name);
+    return p;
   }
-  sys_panicf("Protocol table is full, cannot register protocol: %s", p->name);
+  if (protocol == p) {
+    // Register the protocols incorporated by a newly registered protocol
+    __objc_protocol_list_register(p->protocol_list);
+  }
+  return protocol;
 }
 
 void __objc_protocol_list_register(struct objc_protocol_list *list) {
-  if (list == NULL) {
-    return; // Nothing to register
-  }
-  for (size_t i = 0; i < list->count; i++) {
-    objc_protocol_t *protocol = list->protocols[i];
-    if (protocol != NULL && protocol->name != NULL) {
-      __objc_protocol_register(protocol);
+  for (; list != NULL; list = list->next) {
+    for (size_t i = 0; i < list->count; i++) {
+      // Replace copies of a protocol with the registered protocol
+      list->protocols[i] = __objc_protocol_register(list->protocols[i]);
     }
   }
-  if (list->next != NULL) {
-    __objc_protocol_list_register(list->next); // Register next protocol list
-  }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -79,26 +281,16 @@ BOOL proto_conformsTo(objc_protocol_t *protocol,
   if (protocol == NULL || otherProtocol == NULL) {
     return NO; // Cannot check conformance with NULL protocols
   }
-  // Check for same protocol
   if (protocol == otherProtocol) {
     return YES; // Protocols are the same
   }
-  // Check for name
-  if (strcmp(protocol->name, otherProtocol->name) == 0) {
-    return YES; // Protocols are the same
+  objc_protocol_t *other =
+      __objc_table_get(&protocol_table, otherProtocol->name);
+  if (other == NULL) {
+    return __objc_protocol_conforms(__objc_protocol_unique(protocol),
+                                    otherProtocol, NO);
   }
-  // Check other protocols in the list
-  struct objc_protocol_list *proto = protocol->protocol_list;
-  while (proto != NULL) {
-    for (size_t i = 0; i < proto->count; i++) {
-      if (proto_conformsTo(proto->protocols[i], otherProtocol)) {
-        return YES; // Found a matching protocol
-      }
-    }
-    proto = proto->next; // Move to next protocol list
-  }
-  // No matching protocol found
-  return NO;
+  return __objc_protocol_conforms(__objc_protocol_unique(protocol), other, YES);
 }
 
 /**
@@ -109,23 +301,38 @@ BOOL class_conformsTo(Class cls, objc_protocol_t *otherProtocol) {
     return NO; // Cannot check conformance with Nil class or NULL protocol
   }
 
-  // Check if the class implements the protocol directly
-  struct objc_protocol_list *proto = cls->protocols;
-  while (proto != NULL) {
-    for (size_t i = 0; i < proto->count; i++) {
-      if (proto_conformsTo(proto->protocols[i], otherProtocol)) {
-        return YES; // Found a matching protocol
-      }
-    }
-    proto = proto->next; // Move to next protocol list
+  // Return the cached result, if the class has been checked before
+  uint32_t hash = __objc_protocol_cache_hash(cls, otherProtocol);
+  struct objc_protocol_cache_entry *entry =
+      __objc_protocol_cache_lookup(cls, otherProtocol, hash);
+  if (entry != NULL) {
+    return entry->conforms;
   }
 
-  // Get superclass and check if it conforms
-  Class superclass = class_getSuperclass(cls);
-  if (superclass != Nil) {
-    return class_conformsTo(superclass, otherProtocol); // Check superclass
+  // Check the protocols adopted by the class and its superclasses, against
+  // the registered copy of the protocol if there is one
+  objc_protocol_t *protocol =
+      __objc_table_get(&protocol_table, otherProtocol->name);
+  BOOL registered = protocol != NULL;
+  if (registered == NO) {
+    protocol = otherProtocol;
+  }
+  BOOL conforms = NO;
+  for (Class cur = cls; cur != Nil && conforms == NO; cur = cur->superclass) {
+    for (struct objc_protocol_list *list = cur->protocols;
+         list != NULL && conforms == NO; list = list->next) {
+      for (size_t i = 0; i < list->count; i++) {
+        if (list->protocols[i] != NULL &&
+            __objc_protocol_conforms(list->protocols[i], protocol,
+                                     registered)) {
+          conforms = YES;
+          break;
+        }
+      }
+    }
   }
 
-  // Class does not conform to the protocol
-  return NO;
+  // Cache the result for next time
+  __objc_protocol_cache_add(cls, otherProtocol, hash, conforms);
+  return conforms;
 }
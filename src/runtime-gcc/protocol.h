@@ -17,11 +17,13 @@ typedef struct objc_protocol objc_protocol_t;
 void __objc_protocol_init();
 
 /*
- * Register a protocol in the Objective-C runtime.
+ * Register a protocol in the Objective-C runtime, and return the registered
+ * protocol with the same name, which is the first one registered.
  */
-void __objc_protocol_register(objc_protocol_t *protocol);
+objc_protocol_t *__objc_protocol_register(objc_protocol_t *protocol);
 
 /*
- * Register protocols from a list of protocols
+ * Register protocols from a list of protocols, replacing each protocol in
+ * the list with the registered protocol of the same name.
  */
 void __objc_protocol_list_register(struct objc_protocol_list *list);
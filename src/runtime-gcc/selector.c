@@ -0,0 +1,241 @@
+#include "selector.h"
+#include "api.h"
+#include <objc/objc.h>
+#include <runtime-sys/sys.h>
+#include <string.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Initial selector table size, which should be a power of 2
+ */
+#define SELECTOR_TABLE_SIZE 256
+
+/*
+ * Number of selectors allocated at a time in the selector arena
+ */
+#define SELECTOR_CHUNK_SIZE 64
+
+/*
+ * A registered selector. The hash of the name is computed once, when the
+ * selector is registered, and is reused when the table grows.
+ */
+struct objc_selector_entry {
+  struct objc_selector sel; // Untyped selector with the unique name
+  uintptr_t hash;           // Hash of the selector name
+};
+
+/*
+ * Selectors are allocated in chunks which are never freed, so SEL values
+ * returned by sel_registerName remain valid for the lifetime of the program.
+ */
+struct objc_selector_chunk {
+  struct objc_selector_chunk *next;
+  size_t count;
+  struct objc_selector_entry entries[SELECTOR_CHUNK_SIZE];
+};
+
+static struct objc_selector_entry **selector_table = NULL;
+static uint32_t selector_mask = 0;
+static uint32_t selector_count = 0;
+static struct objc_selector_chunk *selector_chunk = NULL;
+static sys_mutex_t selector_lock;
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE METHODS
+
+/*
+ * Find the selector entry for a name, or NULL if not found
+ */
+static struct objc_selector_entry *__objc_selector_find(const char *name,
+                                                        uintptr_t hash) {
+  if (selector_table == NULL) {
+    return NULL;
+  }
+  uint32_t idx = (uint32_t)hash & selector_mask;
+  for (;;) {
+    struct objc_selector_entry *entry = selector_table[idx];
+    if (entry == NULL) {
+      return NULL; // Hit empty slot, not found
+    }
+    if (entry->hash == hash && (entry->sel.sel_id == name ||
+                                strcmp(entry->sel.sel_id, name) == 0)) {
+      return entry;
+    }
+    idx = (idx + 1) & selector_mask;
+  }
+}
+
+/*
+ * Resize the table to the given number of slots, reusing the stored hashes
+ */
+static BOOL __objc_selector_resize(uint32_t size) {
+  struct objc_selector_entry **table =
+      sys_malloc(sizeof(struct objc_selector_entry *) * size);
+  if (table == NULL) {
+    return NO;
+  }
+  for (uint32_t i = 0; i < size; i++) {
+    table[i] = NULL;
+  }
+  if (selector_table != NULL) {
+    for (uint32_t i = 0; i <= selector_mask; i++) {
+      struct objc_selector_entry *entry = selector_table[i];
+      if (entry == NULL) {
+        continue;
+      }
+      uint32_t idx = (uint32_t)entry->hash & (size - 1);
+      while (table[idx] != NULL) {
+        idx = (idx + 1) & (size - 1);
+      }
+      table[idx] = entry;
+    }
+    sys_free(selector_table);
+  }
+  selector_table = table;
+  selector_mask = size - 1;
+  return YES;
+}
+
+/*
+ * Add a new selector entry with the given name, which is not copied
+ */
+static struct objc_selector_entry *__objc_selector_add(const char *name,
+                                                       uintptr_t hash) {
+  // Keep the table at most half full
+  if (selector_table == NULL) {
+    if (!__objc_selector_resize(SELECTOR_TABLE_SIZE)) {
+      return NULL;
+    }
+  } else if ((selector_count + 1) * 2 > selector_mask + 1) {
+    if (!__objc_selector_resize((selector_mask + 1) * 2)) {
+      return NULL;
+    }
+  }
+
+  // Allocate the entry from the arena
+  if (selector_chunk == NULL || selector_chunk->count == SELECTOR_CHUNK_SIZE) {
+    struct objc_selector_chunk *chunk =
+        sys_malloc(sizeof(struct objc_selector_chunk));
+    if (chunk == NULL) {
+      return NULL;
+    }
+    chunk->next = selector_chunk;
+    chunk->count = 0;
+    selector_chunk = chunk;
+  }
+  struct objc_selector_entry *entry =
+      &selector_chunk->entries[selector_chunk->count++];
+  entry->sel.sel_id = (void *)name;
+  entry->sel.sel_type = NULL;
+  entry->hash = hash;
+
+  // Insert the entry into the table
+  uint32_t idx = (uint32_t)hash & selector_mask;
+  while (selector_table[idx] != NULL) {
+    idx = (idx + 1) & selector_mask;
+  }
+  selector_table[idx] = entry;
+  selector_count++;
+  return entry;
+}
+
+/*
+ * Find or register a selector. If copy is YES, a newly registered name is
+ * copied, otherwise the name must remain valid for the lifetime of the
+ * program.
+ */
+static struct objc_selector_entry *__objc_selector_register(const char *name,
+                                                            BOOL copy) {
+  uintptr_t hash = sys_hash_djb2(name);
+  struct objc_selector_entry *entry = __objc_selector_find(name, hash);
+  if (entry != NULL) {
+    return entry;
+  }
+  if (copy) {
+    size_t size = strlen(name) + 1;
+    char *name_copy = sys_malloc(size);
+    if (name_copy == NULL) {
+      return NULL;
+    }
+    sys_memcpy(name_copy, name, size);
+    name = name_copy;
+  }
+  return __objc_selector_add(name, hash);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void __objc_selector_init() {
+  static BOOL init = NO;
+  if (init) {
+    return; // Already initialized
+  }
+  init = YES;
+  selector_lock = sys_mutex_init();
+}
+
+const char *__objc_selector_unique(const char *name) {
+  if (name == NULL) {
+    return NULL;
+  }
+  sys_mutex_lock(&selector_lock);
+  struct objc_selector_entry *entry = __objc_selector_register(name, NO);
+  sys_mutex_unlock(&selector_lock);
+  return entry ? entry->sel.sel_id : NULL;
+}
+
+void __objc_selector_register_refs(struct objc_selector *refs,
+                                   unsigned long count) {
+  if (refs == NULL) {
+    return;
+  }
+
+  // The list of referenced selectors is terminated by a NULL name, and the
+  // count may be zero
+  sys_mutex_lock(&selector_lock);
+  for (unsigned long i = 0; refs[i].sel_id != NULL && (count == 0 || i < count);
+       i++) {
+    struct objc_selector_entry *entry =
+        __objc_selector_register(refs[i].sel_id, NO);
+    if (entry == NULL) {
+      sys_panicf("Failed to register selector: %s",
+                 (const char *)refs[i].sel_id);
+      break;
+    }
+    refs[i].sel_id = entry->sel.sel_id;
+  }
+  sys_mutex_unlock(&selector_lock);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PUBLIC METHODS
+
+/**
+ * Registers a selector name with the runtime, and returns the selector.
+ */
+SEL sel_registerName(const char *name) {
+  if (name == NULL) {
+    return NULL;
+  }
+  sys_mutex_lock(&selector_lock);
+  struct objc_selector_entry *entry = __objc_selector_register(name, YES);
+  sys_mutex_unlock(&selector_lock);
+  return entry ? &entry->sel : NULL;
+}
+
+/**
+ * Returns the selector with the given name, registering it if necessary, the
+ * same as sel_registerName.
+ */
+SEL sel_getUid(const char *name) { return sel_registerName(name); }
+
+/**
+ * Returns YES if two selectors have the same name.
+ */
+BOOL sel_isEqual(SEL sel, SEL other) {
+  if (sel == NULL || other == NULL) {
+    return sel == other;
+  }
+  return sel->sel_id == other->sel_id;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "api.h"
+
+///////////////////////////////////////////////////////////////////////////////////
+// METHODS
+
+/*
+ * Initializes the Objective-C runtime selector table
+ */
+void __objc_selector_init();
+
+/*
+ * Returns the unique name for a selector, registering the name if it has
+ * not been seen before. Two selectors with the same name always have the same
+ * unique name pointer, so selectors can be compared by pointer. Returns NULL
+ * if memory could not be allocated.
+ */
+const char *__objc_selector_unique(const char *name);
+
+/*
+ * Replace the selector names referenced by a module with unique names, so
+ * that message dispatch can compare and hash selectors by pointer.
+ */
+void __objc_selector_register_refs(struct objc_selector *refs,
+                                   unsigned long count);
@@ -1,11 +1,12 @@
 #include "api.h"
 #include "class.h"
+#include "table.h"
 #include <objc/objc.h>
 #include <runtime-sys/sys.h>
 #include <string.h>
 
-#define STATICS_TABLE_SIZE 32
-static struct objc_static_instances_list *statics_table[STATICS_TABLE_SIZE + 1];
+// Static instance lists, in the order they were registered
+static struct objc_array statics_table;
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -15,9 +16,9 @@ void __objc_statics_init() {
     return; // Already initialized
   }
   init = YES;
-  for (int i = 0; i <= STATICS_TABLE_SIZE; i++) {
-    statics_table[i] = NULL;
-  }
+  statics_table.count = 0;
+  statics_table.capacity = 0;
+  statics_table.items = NULL;
 }
 
 void __objc_statics_register(struct objc_static_instances_list *statics) {
@@ -27,19 +28,10 @@ void __objc_statics_register(struct objc_static_instances_list *statics) {
 #ifdef OBJCDEBUG
   sys_printf("__objc_statics_register [%s]\n", statics->class_name);
 #endif
-  for (int i = 0; i < STATICS_TABLE_SIZE; i++) {
-    if (statics_table[i] == statics) {
-      // Static list is already registered, nothing to do
-      return;
-    }
-    if (statics_table[i] == NULL) {
-      // Found empty slot, register the static list
-      statics_table[i] = statics;
-      return;
-    }
+  if (!__objc_array_append(&statics_table, statics)) {
+    sys_panicf("Failed to register static instances of class: %s",
+               statics->class_name);
   }
-  sys_panicf("Static instances table is full, cannot register class: %s",
-             statics->class_name);
 }
 
 static void __objc_statics_load_list(struct objc_static_instances_list *list) {
@@ -64,12 +56,8 @@ BOOL __objc_statics_load() {
   init = YES;
 
   // Replace class name with resolved class
-  for (int i = 0; i < STATICS_TABLE_SIZE; i++) {
-    struct objc_static_instances_list *list = statics_table[i];
-    if (list == NULL) {
-      continue; // No static instances in this slot
-    }
-    __objc_statics_load_list(list);
+  for (uint32_t i = 0; i < statics_table.count; i++) {
+    __objc_statics_load_list(statics_table.items[i]);
   }
 
   return YES;
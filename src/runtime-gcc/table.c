@@ -0,0 +1,133 @@
+#include "table.h"
+#include <objc/objc.h>
+#include <runtime-sys/sys.h>
+#include <string.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Initial array capacity
+ */
+#define ARRAY_CAPACITY 16
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE METHODS
+
+/*
+ * Return the slot for a name, which is either the slot containing the name or
+ * the empty slot where it should be inserted
+ */
+static struct objc_table_entry *
+__objc_table_slot(struct objc_table_entry *entries, uint32_t mask,
+                  const char *name, uintptr_t hash) {
+  uint32_t idx = (uint32_t)hash & mask;
+  for (;;) {
+    struct objc_table_entry *entry = &entries[idx];
+    if (entry->name == NULL) {
+      return entry;
+    }
+    if (entry->hash == hash &&
+        (entry->name == name || strcmp(entry->name, name) == 0)) {
+      return entry;
+    }
+    idx = (idx + 1) & mask;
+  }
+}
+
+/*
+ * Allocate empty slots for a table
+ */
+static struct objc_table_entry *__objc_table_new(uint32_t size) {
+  struct objc_table_entry *entries =
+      sys_malloc(sizeof(struct objc_table_entry) * size);
+  if (entries == NULL) {
+    return NULL; // Memory allocation failed
+  }
+  for (uint32_t i = 0; i < size; i++) {
+    entries[i].name = NULL;
+  }
+  return entries;
+}
+
+/*
+ * Resize the table to twice the number of slots, reusing the stored hashes
+ */
+static BOOL __objc_table_grow(struct objc_table *table) {
+  uint32_t mask = (table->mask << 1) | 1;
+  struct objc_table_entry *entries = __objc_table_new(mask + 1);
+  if (entries == NULL) {
+    return NO;
+  }
+  for (uint32_t i = 0; i <= table->mask; i++) {
+    struct objc_table_entry *entry = &table->entries[i];
+    if (entry->name != NULL) {
+      *__objc_table_slot(entries, mask, entry->name, entry->hash) = *entry;
+    }
+  }
+  sys_free(table->entries);
+  table->entries = entries;
+  table->mask = mask;
+  return YES;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+BOOL __objc_table_init(struct objc_table *table, uint32_t size) {
+  table->entries = __objc_table_new(size);
+  if (table->entries == NULL) {
+    return NO;
+  }
+  table->mask = size - 1;
+  table->count = 0;
+  return YES;
+}
+
+void *__objc_table_get(struct objc_table *table, const char *name) {
+  if (table->entries == NULL || name == NULL) {
+    return NULL;
+  }
+  struct objc_table_entry *entry = __objc_table_slot(
+      table->entries, table->mask, name, sys_hash_djb2(name));
+  return entry->name ? entry->value : NULL;
+}
+
+void *__objc_table_put(struct objc_table *table, const char *name,
+                       void *value) {
+  uintptr_t hash = sys_hash_djb2(name);
+  struct objc_table_entry *entry =
+      __objc_table_slot(table->entries, table->mask, name, hash);
+  if (entry->name != NULL) {
+    return entry->value; // Already exists
+  }
+
+  // Keep the table at most half full
+  if ((table->count + 1) * 2 > table->mask + 1) {
+    if (!__objc_table_grow(table)) {
+      return NULL;
+    }
+    entry = __objc_table_slot(table->entries, table->mask, name, hash);
+  }
+  entry->name = name;
+  entry->hash = hash;
+  entry->value = value;
+  table->count++;
+  return value;
+}
+
+BOOL __objc_array_append(struct objc_array *array, void *item) {
+  if (array->count == array->capacity) {
+    uint32_t capacity = array->capacity ? array->capacity * 2 : ARRAY_CAPACITY;
+    void **items = sys_malloc(sizeof(void *) * capacity);
+    if (items == NULL) {
+      return NO;
+    }
+    if (array->items != NULL) {
+      sys_memcpy(items, array->items, sizeof(void *) * array->count);
+      sys_free(array->items);
+    }
+    array->items = items;
+    array->capacity = capacity;
+  }
+  array->items[array->count++] = item;
+  return YES;
+}
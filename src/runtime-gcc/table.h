@@ -0,0 +1,65 @@
+#pragma once
+#include "api.h"
+
+///////////////////////////////////////////////////////////////////////////////////
+// TYPES
+
+/*
+ * An entry in a name table. The hash of the name is computed once, when the
+ * entry is added, and is reused when the table grows.
+ */
+struct objc_table_entry {
+  const char *name; // Name of the entry, or NULL if the slot is empty
+  uintptr_t hash;   // Hash of the name
+  void *value;      // Value for the name
+};
+
+/*
+ * A table which maps names to values, used for the class and protocol
+ * registries. The table is an open-addressed hash table with linear probing,
+ * which is never more than half full. Entries are never removed.
+ *
+ * Tables are only modified while modules are loaded, so they are not locked.
+ */
+struct objc_table {
+  uint32_t mask;                    // Number of slots minus one
+  uint32_t count;                   // Number of occupied slots
+  struct objc_table_entry *entries; // Slots
+};
+
+/*
+ * An array of pointers which grows as items are appended, used for lists
+ * which are loaded in the order they were registered.
+ */
+struct objc_array {
+  uint32_t count;    // Number of items
+  uint32_t capacity; // Number of items allocated
+  void **items;      // Items
+};
+
+///////////////////////////////////////////////////////////////////////////////////
+// METHODS
+
+/*
+ * Initialize a table with the given number of slots, which should be a power
+ * of 2. Returns NO if memory could not be allocated.
+ */
+BOOL __objc_table_init(struct objc_table *table, uint32_t size);
+
+/*
+ * Return the value for a name, or NULL if the name is not in the table.
+ */
+void *__objc_table_get(struct objc_table *table, const char *name);
+
+/*
+ * Add a value for a name, which is not copied. If the name is already in the
+ * table, the existing value is returned and the table is not changed.
+ * Returns NULL if memory could not be allocated.
+ */
+void *__objc_table_put(struct objc_table *table, const char *name,
+                       void *value);
+
+/*
+ * Append an item to an array. Returns NO if memory could not be allocated.
+ */
+BOOL __objc_array_append(struct objc_array *array, void *item);
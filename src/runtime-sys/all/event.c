@@ -284,3 +284,102 @@ bool sys_event_queue_unlock(sys_event_queue_t *queue) {
 
   return sys_mutex_unlock(&queue->mutex);
 }
+
+///////////////////////////////////////////////////////////////////////////////
+// EVENT POOL
+
+// Number of slots in each word of the bitmap
+#define SYS_EVENT_POOL_BITS 32
+
+sys_event_pool_t sys_event_pool_init(size_t size, size_t count) {
+  sys_event_pool_t pool = {0};
+
+  // Validate arguments
+  if (size == 0 || count == 0) {
+    return pool;
+  }
+
+  // Each slot is aligned to eight bytes
+  size = (size + 7) & ~(size_t)7;
+
+  // Allocate the bitmap and the slots together, with the bitmap first so
+  // that the slots are aligned
+  size_t words = (count + SYS_EVENT_POOL_BITS - 1) / SYS_EVENT_POOL_BITS;
+  size_t bitmap = (words * sizeof(sys_atomic_t) + 7) & ~(size_t)7;
+  uint8_t *data = (uint8_t *)sys_malloc(bitmap + size * count);
+  if (data == NULL) {
+    return pool;
+  }
+
+  // Mark every slot as free
+  pool.used = (sys_atomic_t *)data;
+  for (size_t i = 0; i < words; i++) {
+    sys_atomic_init(&pool.used[i], 0);
+  }
+  pool.slots = data + bitmap;
+  pool.size = size;
+  pool.count = count;
+  return pool;
+}
+
+void sys_event_pool_finalize(sys_event_pool_t *pool) {
+  if (pool == NULL || pool->used == NULL) {
+    return;
+  }
+  sys_free(pool->used);
+  sys_memset(pool, 0, sizeof(*pool));
+}
+
+void *sys_event_pool_alloc(sys_event_pool_t *pool) {
+  if (sys_event_pool_valid(pool) == false) {
+    return NULL;
+  }
+  size_t words = (pool->count + SYS_EVENT_POOL_BITS - 1) / SYS_EVENT_POOL_BITS;
+  for (size_t i = 0; i < words; i++) {
+    // The last word may have fewer slots than bits
+    size_t bits = pool->count - i * SYS_EVENT_POOL_BITS;
+    uint32_t mask = bits < SYS_EVENT_POOL_BITS ? ((uint32_t)1 << bits) - 1
+                                               : UINT32_MAX;
+
+    // Claim the first free slot in the word, and try again if another
+    // producer changed the word first
+    uint32_t word = sys_atomic_get(&pool->used[i]);
+    while ((~word & mask) != 0) {
+      uint32_t bit = (uint32_t)__builtin_ctz(~word & mask);
+      if (sys_atomic_cas(&pool->used[i], &word, word | ((uint32_t)1 << bit))) {
+        return pool->slots + (i * SYS_EVENT_POOL_BITS + bit) * pool->size;
+      }
+    }
+  }
+
+  // Every slot is in use
+  return NULL;
+}
+
+void sys_event_pool_free(sys_event_pool_t *pool, void *ptr) {
+  if (ptr == NULL || sys_event_pool_valid(pool) == false) {
+    return;
+  }
+  size_t index = (size_t)((uint8_t *)ptr - pool->slots) / pool->size;
+  sys_assert((uint8_t *)ptr >= pool->slots && index < pool->count);
+  sys_atomic_t *used = &pool->used[index / SYS_EVENT_POOL_BITS];
+  uint32_t bit = (uint32_t)1 << (index % SYS_EVENT_POOL_BITS);
+
+  // Release the slot with release ordering, so that the slot is not
+  // reused before the consumer has finished with it
+  uint32_t word = sys_atomic_get(used);
+  while (sys_atomic_cas(used, &word, word & ~bit) == false) {
+  }
+}
+
+size_t sys_event_pool_used(sys_event_pool_t *pool) {
+  if (sys_event_pool_valid(pool) == false) {
+    return 0;
+  }
+  size_t used = 0;
+  size_t words = (pool->count + SYS_EVENT_POOL_BITS - 1) / SYS_EVENT_POOL_BITS;
+  for (size_t i = 0; i < words; i++) {
+    used += (size_t)__builtin_popcount(sys_atomic_get(&pool->used[i]));
+  }
+  return used;
+}
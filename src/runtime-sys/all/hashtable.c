@@ -1,98 +1,169 @@
 #include "hashtable.h"
 #include <runtime-sys/sys.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////
-// LIFECYCLE
+// PRIVATE METHODS
 
-/** @brief Initialize a new hash table
+/** @brief Return the number of entries which can hold a key or tombstone
+ * before the table is resized, which keeps a quarter of the entries empty so
+ * that probes stay short.
  */
-static sys_hashtable_t *
-_sys_hashtable_new(size_t size, sys_hashtable_t *prev,
-                   sys_hashtable_keyequals_t keyequals) {
-  sys_assert(size > 0);
-  sys_assert(prev == NULL || prev->next == NULL);
+static inline size_t _sys_hashtable_limit(size_t size) {
+  return size - (size >> 2);
+}
 
-  // Allocate memory for the hash table structure
-  size_t total_size =
-      sizeof(sys_hashtable_t) + size * sizeof(sys_hashtable_entry_t);
-  sys_hashtable_t *table = sys_malloc(total_size);
-  if (table == NULL) {
-    return NULL; // Allocation failed
-  }
+/** @brief Mix the bits of a hash, so that the control byte and the first
+ * group are taken from all of them.
+ */
+static inline uint32_t _sys_hashtable_mix(uintptr_t hash) {
+  uint32_t h = (uint32_t)hash;
+#if UINTPTR_MAX > 0xFFFFFFFF
+  h ^= (uint32_t)(hash >> 32);
+#endif
+  h ^= h >> 16;
+  h *= 0x85ebca6b;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35;
+  h ^= h >> 16;
+  return h;
+}
 
-  // Set next pointer
-  if (prev) {
-    prev->next = table;
+/** @brief Return a mask with bit i set for each control byte i in a group
+ * which is equal to a value.
+ */
+static inline uint32_t _sys_hashtable_match(const uint8_t *ctrl,
+                                            uint8_t value) {
+#if defined(__SSE2__)
+  __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+  __m128i match = _mm_cmpeq_epi8(group, _mm_set1_epi8((char)value));
+  return (uint32_t)_mm_movemask_epi8(match);
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  static const uint8_t bits[SYS_HASHTABLE_GROUP] = {
+      1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+  uint8x16_t match = vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(value));
+  match = vandq_u8(match, vld1q_u8(bits));
+  return (uint32_t)vaddv_u8(vget_low_u8(match)) |
+         ((uint32_t)vaddv_u8(vget_high_u8(match)) << 8);
+#elif defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  // Portable version, for targets such as the Cortex-M0+ without SIMD, which
+  // compares a word of four control bytes at a time
+  uint32_t mask = 0;
+  for (size_t i = 0; i < SYS_HASHTABLE_GROUP; i += 4) {
+    uint32_t word;
+    sys_memcpy(&word, ctrl + i, sizeof(word));
+    word ^= 0x01010101U * value;
+
+    // Set the high bit of each byte which is zero, then gather the four high
+    // bits into the low bits
+    uint32_t zero =
+        ~(((word & 0x7F7F7F7FU) + 0x7F7F7F7FU) | word) & 0x80808080U;
+    mask |= ((((zero >> 7) * 0x00204081U) >> 21) & 0xF) << i;
   }
+  return mask;
+#else
+  uint32_t mask = 0;
+  for (size_t i = 0; i < SYS_HASHTABLE_GROUP; i++) {
+    if (ctrl[i] == value) {
+      mask |= (uint32_t)1 << i;
+    }
+  }
+  return mask;
+#endif
+}
 
-  // Initialize the hash table
-  sys_memset(table, 0, total_size);
-  table->next = NULL;
-  table->size = size;
-  table->keyequals = keyequals;
-  table->entries = (sys_hashtable_entry_t *)(table + 1);
-
-  // Return the new hash table
-  return table;
+/** @brief Return the index of the lowest bit in a non-zero mask.
+ */
+static inline size_t _sys_hashtable_lowest(uint32_t mask) {
+  sys_assert(mask);
+  return (size_t)__builtin_ctz(mask);
 }
 
-/** @brief Initialize a new chain of hash tables
+/** @brief Return the smallest power of two which is at least size.
  */
-sys_hashtable_t *sys_hashtable_init(size_t size,
-                                    sys_hashtable_keyequals_t keyequals) {
-  sys_assert(size > 0);
-  return _sys_hashtable_new(size, NULL, keyequals);
+static size_t _sys_hashtable_round(size_t size) {
+  size_t round = 1;
+  while (round < size) {
+    if (round > (SIZE_MAX >> 1)) {
+      sys_panicf("Hash table too large for expansion");
+    }
+    round <<= 1;
+  }
+  return round;
 }
 
-/** @brief Free all the hash tables in the chain
+/** @brief Allocate empty entries and control bytes for a table.
  */
-void sys_hashtable_finalize(sys_hashtable_t *table) {
+static bool _sys_hashtable_alloc(sys_hashtable_t *table, size_t size) {
   sys_assert(table);
+  sys_assert(size > 0 && (size & (size - 1)) == 0);
 
-  // Free each hash table in the chain
-  while (table) {
-    sys_hashtable_t *next = table->next;
-    sys_free(table);
-    table = next;
+  // The control bytes follow the entries, padded to a whole number of groups
+  size_t groups = (size + SYS_HASHTABLE_GROUP - 1) / SYS_HASHTABLE_GROUP;
+  size_t ctrl_size = groups * SYS_HASHTABLE_GROUP;
+  if (size > (SIZE_MAX - ctrl_size) / sizeof(sys_hashtable_entry_t)) {
+    sys_panicf("Hash table too large for expansion");
+  }
+  size_t entries_size = size * sizeof(sys_hashtable_entry_t);
+  sys_hashtable_entry_t *entries = sys_malloc(entries_size + ctrl_size);
+  if (entries == NULL) {
+    return false; // Allocation failed
   }
+  sys_memset(entries, 0, entries_size);
+  uint8_t *ctrl = (uint8_t *)entries + entries_size;
+  sys_memset(ctrl, SYS_HASHTABLE_CTRL_EMPTY, size);
+  sys_memset(ctrl + size, SYS_HASHTABLE_CTRL_PADDING, ctrl_size - size);
+
+  // Set the table to the new entries
+  table->entries = entries;
+  table->ctrl = ctrl;
+  table->size = size;
+  table->groups = groups;
+  table->used = 0;
+  table->deleted = 0;
+  return true;
 }
 
-///////////////////////////////////////////////////////////////////////////////
-// PRIVATE METHODS
-
-/** @brief Search for an entry in a hash table using a hash key
+/** @brief Search for an entry in a hash table using a hash key, comparing
+ * the control bytes of a group of entries at once
  */
 static sys_hashtable_entry_t *
 _sys_hashtable_get_bykey_inner(sys_hashtable_t *table, uintptr_t hash,
                                void *keyptr) {
   sys_assert(table);
 
-  // Calculate the starting index based on the key hash
-  size_t start_index = hash % table->size;
-  size_t index = start_index;
-  size_t probes = 0;
-  while (probes < table->size) {
-    sys_hashtable_entry_t *entry = &table->entries[index];
-
-    // Found the hash and it's not deleted
-    if (entry->hash == hash && !IS_DELETED(entry)) {
-      if (table->keyequals == NULL) {
-        // No key comparison function, just return if hashes match
-        return entry;
-      } else if (table->keyequals(keyptr, entry->keyptr)) {
-        // Exact match found using key comparison function
+  // Probe each group in turn, starting at the group chosen by the hash
+  uint32_t mixed = _sys_hashtable_mix(hash);
+  uint8_t h2 = (uint8_t)(mixed >> 25);
+  size_t group_mask = table->groups - 1;
+  size_t group = mixed & group_mask;
+  for (size_t probes = 0; probes < table->groups; probes++) {
+    size_t base = group * SYS_HASHTABLE_GROUP;
+    const uint8_t *ctrl = table->ctrl + base;
+
+    // Compare the keys of the entries with the same control byte
+    uint32_t mask = _sys_hashtable_match(ctrl, h2);
+    while (mask) {
+      sys_hashtable_entry_t *entry =
+          &table->entries[base + _sys_hashtable_lowest(mask)];
+      if (entry->hash == hash &&
+          (table->keyequals == NULL || table->keyequals(keyptr, entry->keyptr))) {
         return entry;
       }
+      mask &= mask - 1;
     }
 
-    // Empty slot found (never been used) - key definitely not in table
-    if (entry->value == 0 && !IS_DELETED(entry)) {
+    // An empty entry ends the search, since the key would have been put there
+    if (_sys_hashtable_match(ctrl, SYS_HASHTABLE_CTRL_EMPTY)) {
       return NULL;
     }
 
-    // Continue probing through deleted entries and collisions
-    index = (index + 1) % table->size;
-    probes++;
+    // Continue probing through full groups
+    group = (group + 1) & group_mask;
   }
 
   // Searched entire table without finding key or empty slot
@@ -105,93 +176,203 @@ static sys_hashtable_entry_t *
 _sys_hashtable_find_slot(sys_hashtable_t *table, uintptr_t hash, void *keyptr) {
   sys_assert(table != NULL);
 
-  size_t start_index = hash % table->size;
-  size_t index = start_index;
-  size_t probes = 0;
-  sys_hashtable_entry_t *first_deleted = NULL;
-
-  while (probes < table->size) {
-    sys_hashtable_entry_t *entry = &table->entries[index];
+  uint32_t mixed = _sys_hashtable_mix(hash);
+  uint8_t h2 = (uint8_t)(mixed >> 25);
+  size_t group_mask = table->groups - 1;
+  size_t group = mixed & group_mask;
+  sys_hashtable_entry_t *first_free = NULL;
+  for (size_t probes = 0; probes < table->groups; probes++) {
+    size_t base = group * SYS_HASHTABLE_GROUP;
+    const uint8_t *ctrl = table->ctrl + base;
 
     // Case 1: Exact match found
-    if (entry->hash == hash && !IS_DELETED(entry)) {
-      if (table->keyequals == NULL || table->keyequals(keyptr, entry->keyptr)) {
+    uint32_t mask = _sys_hashtable_match(ctrl, h2);
+    while (mask) {
+      sys_hashtable_entry_t *entry =
+          &table->entries[base + _sys_hashtable_lowest(mask)];
+      if (entry->hash == hash &&
+          (table->keyequals == NULL || table->keyequals(keyptr, entry->keyptr))) {
         return entry;
       }
+      mask &= mask - 1;
     }
 
-    // Case 2: Empty slot found
-    if (entry->value == 0 && !IS_DELETED(entry)) {
-      // The key is not in the table. Return the first deleted slot if we found
-      // one, otherwise return this empty slot. This is the insertion point.
-      return first_deleted ? first_deleted : entry;
+    // Case 2: Remember the first deleted or empty slot, but keep searching
+    // for an exact match until a group with an empty slot
+    uint32_t empty = _sys_hashtable_match(ctrl, SYS_HASHTABLE_CTRL_EMPTY);
+    if (first_free == NULL) {
+      uint32_t slots =
+          empty | _sys_hashtable_match(ctrl, SYS_HASHTABLE_CTRL_DELETED);
+      if (slots) {
+        first_free = &table->entries[base + _sys_hashtable_lowest(slots)];
+      }
     }
-
-    // Case 3: Deleted slot found
-    if (IS_DELETED(entry) && first_deleted == NULL) {
-      // Remember this slot, but keep searching for an exact match.
-      first_deleted = entry;
+    if (empty) {
+      return first_free;
     }
 
     // Continue probing
-    index = (index + 1) % table->size;
-    probes++;
+    group = (group + 1) & group_mask;
   }
 
-  // If we get here, the table is full. Return the first deleted slot if
-  // available. If first_deleted is NULL, the table is full of non-matching
-  // keys, so we can't insert.
-  return first_deleted;
+  // If we get here, there are no empty slots. Return the first deleted slot
+  // if available, or NULL if the table is full of non-matching keys.
+  return first_free;
 }
 
-///////////////////////////////////////////////////////////////////////////////
-// PUBLIC METHODS
+/** @brief Set the control byte and flags of an entry for a key.
+ */
+static inline void _sys_hashtable_set_full(sys_hashtable_t *table,
+                                           sys_hashtable_entry_t *entry,
+                                           uintptr_t hash) {
+  size_t index = (size_t)(entry - table->entries);
+  table->ctrl[index] = (uint8_t)(_sys_hashtable_mix(hash) >> 25);
+  CLEAR_DELETED(entry);
+}
 
-/** @brief Search for an entry across all hash tables in the chain using a hash
- * key.
+/** @brief Mark an entry as deleted. When its group has an empty slot, no
+ * search continues past the group, so the entry can be made empty instead of
+ * leaving a tombstone.
  */
-sys_hashtable_entry_t *sys_hashtable_get_key(sys_hashtable_t *root,
-                                             uintptr_t hash, void *keyptr) {
-  sys_assert(root != NULL);
-
-  // Traverse the chain of hash tables
-  sys_hashtable_t *table = root;
-  while (table) {
-    sys_hashtable_entry_t *entry =
-        _sys_hashtable_get_bykey_inner(table, hash, keyptr);
-    if (entry) {
-      return entry; // Found in this table
+static void _sys_hashtable_set_deleted(sys_hashtable_t *table,
+                                       sys_hashtable_entry_t *entry) {
+  size_t index = (size_t)(entry - table->entries);
+  size_t base = index & ~(size_t)(SYS_HASHTABLE_GROUP - 1);
+  SET_DELETED(entry);
+  if (_sys_hashtable_match(table->ctrl + base, SYS_HASHTABLE_CTRL_EMPTY)) {
+    table->ctrl[index] = SYS_HASHTABLE_CTRL_EMPTY;
+    table->used--;
+  } else {
+    table->ctrl[index] = SYS_HASHTABLE_CTRL_DELETED;
+    table->deleted++;
+  }
+}
+
+/** @brief Move the keys into new entries of a different size, dropping the
+ * tombstones.
+ */
+static bool _sys_hashtable_rehash(sys_hashtable_t *table, size_t size) {
+  sys_assert(table);
+
+  // Allocate the new entries, keeping the old ones to move the keys from
+  sys_hashtable_t old = *table;
+  if (_sys_hashtable_alloc(table, size) == false) {
+    return false; // Allocation failed
+  }
+
+  // Insert each key into the first empty entry, since the keys are unique
+  size_t group_mask = table->groups - 1;
+  for (size_t i = 0; i < old.size; i++) {
+    sys_hashtable_entry_t *entry = &old.entries[i];
+    if (!IS_FULL(old.ctrl[i]) || entry->value == 0) {
+      continue;
     }
-    table = table->next; // Move to next table in chain
+    uint32_t mixed = _sys_hashtable_mix(entry->hash);
+    size_t group = mixed & group_mask;
+    uint32_t empty;
+    while ((empty = _sys_hashtable_match(table->ctrl +
+                                             group * SYS_HASHTABLE_GROUP,
+                                         SYS_HASHTABLE_CTRL_EMPTY)) == 0) {
+      group = (group + 1) & group_mask;
+    }
+    size_t index = group * SYS_HASHTABLE_GROUP + _sys_hashtable_lowest(empty);
+    table->entries[index] = *entry;
+    table->ctrl[index] = (uint8_t)(mixed >> 25);
+    if (entry->keyptr == entry->keybuf) {
+      // Keys stored in the entry move with it
+      table->entries[index].keyptr = table->entries[index].keybuf;
+    }
+    table->used++;
   }
 
-  // Key not found in any table in the chain
-  return NULL;
+  // Free the old entries, and the control bytes after them
+  sys_free(old.entries);
+  return true;
+}
+
+/** @brief Resize the table so that a new key can be inserted. When most of
+ * the used entries are tombstones, the table is compacted at the same size,
+ * or else the size is doubled.
+ */
+static bool _sys_hashtable_grow(sys_hashtable_t *table) {
+  sys_assert(table);
+  size_t keys = table->used - table->deleted + 1;
+  size_t size = table->size;
+  if (keys > _sys_hashtable_limit(size) / 2) {
+    while (keys > _sys_hashtable_limit(size)) {
+      if (size > (SIZE_MAX >> 1)) {
+        sys_panicf("Hash table too large for expansion");
+      }
+      size = size << 1;
+    }
+  }
+  return _sys_hashtable_rehash(table, size);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// LIFECYCLE
+
+/** @brief Initialize a new hash table
+ */
+sys_hashtable_t *sys_hashtable_init(size_t size,
+                                    sys_hashtable_keyequals_t keyequals) {
+  sys_assert(size > 0);
+
+  // Allocate memory for the hash table structure
+  sys_hashtable_t *table = sys_malloc(sizeof(sys_hashtable_t));
+  if (table == NULL) {
+    return NULL; // Allocation failed
+  }
+
+  // Allocate the entries, rounding the size up to a power of two so that
+  // indexes can be masked
+  if (_sys_hashtable_alloc(table, _sys_hashtable_round(size)) == false) {
+    sys_free(table);
+    return NULL; // Allocation failed
+  }
+  table->keyequals = keyequals;
+
+  // Return the new hash table
+  return table;
+}
+
+/** @brief Free the hash table
+ */
+void sys_hashtable_finalize(sys_hashtable_t *table) {
+  sys_assert(table);
+  sys_free(table->entries);
+  sys_free(table);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PUBLIC METHODS
+
+/** @brief Search for an entry in the hash table using a hash key.
+ */
+sys_hashtable_entry_t *sys_hashtable_get_key(sys_hashtable_t *table,
+                                             uintptr_t hash, void *keyptr) {
+  sys_assert(table != NULL);
+  return _sys_hashtable_get_bykey_inner(table, hash, keyptr);
 }
 
 /** @brief Search for an entry in the hash table by value.
  */
-sys_hashtable_entry_t *sys_hashtable_get_value(sys_hashtable_t *root,
+sys_hashtable_entry_t *sys_hashtable_get_value(sys_hashtable_t *table,
                                                uintptr_t value) {
-  sys_assert(root);
+  sys_assert(table);
   sys_assert(value);
 
-  // Traverse the chain of hash tables
-  sys_hashtable_t *table = root;
-  while (table) {
-    // Linear search through all entries in current table
-    for (size_t i = 0; i < table->size; i++) {
-      sys_hashtable_entry_t *entry = &table->entries[i];
+  // Linear search through all entries
+  for (size_t i = 0; i < table->size; i++) {
+    sys_hashtable_entry_t *entry = &table->entries[i];
 
-      // Check if entry matches value and is not deleted
-      if (!IS_DELETED(entry) && entry->value == value) {
-        return entry; // Found matching value
-      }
+    // Check if entry matches value and is not deleted
+    if (!IS_DELETED(entry) && entry->value == value) {
+      return entry; // Found matching value
     }
-    table = table->next; // Move to next table in chain
   }
 
-  // Value not found in any table in the chain
+  // Value not found
   return NULL;
 }
 
@@ -210,64 +391,49 @@ sys_hashtable_entry_t *sys_hashtable_get_value(sys_hashtable_t *root,
  * a value in the hash table. If an entry with the same hash and key already
  * exists, the value should be replaced.
  */
-sys_hashtable_entry_t *sys_hashtable_put(sys_hashtable_t *root, uintptr_t hash,
-                                         void *keyptr, bool *samekey) {
-  sys_assert(root);
+sys_hashtable_entry_t *sys_hashtable_put(sys_hashtable_t *table,
+                                         uintptr_t hash, void *keyptr,
+                                         bool *samekey) {
+  sys_assert(table);
 
   // Initialize samekey to false by default
   if (samekey) {
     *samekey = false;
   }
 
-  // Single-pass approach: search for existing key or available slot in one
-  // traversal
-  sys_hashtable_t *table = root;
-  sys_hashtable_t *prev = NULL;
-  while (table != NULL) {
-    sys_hashtable_entry_t *slot = _sys_hashtable_find_slot(table, hash, keyptr);
-    if (slot == NULL) {
-      prev = table; // Keep track of the last table
-      table = table->next;
-      continue;
-    }
-
-    // Check if this is an existing key (exact match found)
-    if (slot->hash == hash && !IS_DELETED(slot) &&
-        (table->keyequals == NULL || table->keyequals(keyptr, slot->keyptr))) {
-      // Key exists - this is an overwrite
-      if (samekey) {
-        *samekey = true;
-      }
-      return slot;
+  // Search for the existing key or an available slot in one traversal
+  sys_hashtable_entry_t *slot = _sys_hashtable_find_slot(table, hash, keyptr);
+  if (slot != NULL && IS_FULL(table->ctrl[slot - table->entries])) {
+    // Key exists - this is an overwrite
+    if (samekey) {
+      *samekey = true;
     }
-
-    // We found an available slot (empty or deleted) for a new key
-    slot->keyptr = keyptr;
-    slot->hash = hash;
-    CLEAR_DELETED(slot);
     return slot;
   }
 
-  // All tables are full - create a new one with 1.5x growth
-  // Check for potential overflow in size calculation
-  if (root->size > (SIZE_MAX / 3)) {
-    // Size too large for safe 1.5x expansion
-    sys_panicf("Hash table too large for expansion");
+  // A new key which does not reuse a tombstone uses another entry, so resize
+  // the table first if it is too full
+  if (slot == NULL ||
+      (table->ctrl[slot - table->entries] != SYS_HASHTABLE_CTRL_DELETED &&
+       table->used + 1 > _sys_hashtable_limit(table->size))) {
+    if (_sys_hashtable_grow(table)) {
+      slot = _sys_hashtable_find_slot(table, hash, keyptr);
+    } else if (slot == NULL) {
+      return NULL; // Allocation failed, and the table is full
+    }
   }
+  sys_assert(slot);
 
-  size_t new_size = (root->size == 0) ? 1 : root->size + (root->size >> 1);
-  sys_assert(new_size > 0 && new_size >= root->size); // Ensure we always grow
-  table = _sys_hashtable_new(new_size, prev, root->keyequals);
-  if (table == NULL) {
-    return NULL; // Allocation failed
+  // Claim the slot for the new key
+  if (table->ctrl[slot - table->entries] == SYS_HASHTABLE_CTRL_DELETED) {
+    table->deleted--;
+  } else {
+    table->used++;
   }
-
-  // Insert into the new table using linear probing
-  sys_hashtable_entry_t *slot = _sys_hashtable_find_slot(table, hash, keyptr);
-  sys_assert(slot);
-  slot->hash = hash;
-  CLEAR_DELETED(slot);
+  _sys_hashtable_set_full(table, slot, hash);
   slot->keyptr = keyptr;
+  slot->hash = hash;
+  slot->value = 0;
   return slot;
 }
 
@@ -280,7 +446,7 @@ sys_hashtable_entry_t *sys_hashtable_delete_key(sys_hashtable_t *table,
   if (entry == NULL) {
     return NULL; // Not found
   }
-  SET_DELETED(entry); // Mark as deleted
+  _sys_hashtable_set_deleted(table, entry); // Mark as deleted
   // Note: We keep keyptr and value intact so the caller can release objects,
   // but the slot will be reused for new entries
   return entry; // Return the deleted entry
@@ -297,8 +463,8 @@ sys_hashtable_entry_t *sys_hashtable_delete_value(sys_hashtable_t *table,
   if (entry == NULL) {
     return NULL; // Not found
   }
-  SET_DELETED(entry); // Mark as deleted
-  return entry;       // Return the deleted entry
+  _sys_hashtable_set_deleted(table, entry); // Mark as deleted
+  return entry; // Return the deleted entry
 }
 
 /** @brief Get the next entry from the iterator
@@ -313,28 +479,22 @@ sys_hashtable_iterator_next(sys_hashtable_t *table,
   sys_hashtable_iterator_t *iter = *iterator;
   sys_assert(iter != NULL);
 
-  // If the iterator is not initialized, start from the first table
+  // If the iterator is not initialized, start from the first entry
   if (iter->table == NULL) {
     iter->table = table;
     iter->index = 0; // Start from the first index
   }
 
-  while (iter->table) {
-    // Search for next valid entry in current table
-    while (iter->index < iter->table->size) {
-      sys_hashtable_entry_t *entry = &iter->table->entries[iter->index];
-      iter->index++;
+  // Search for next valid entry
+  while (iter->index < iter->table->size) {
+    sys_hashtable_entry_t *entry = &iter->table->entries[iter->index];
+    iter->index++;
 
-      // Return entries that are not deleted and have been used (non-zero
-      // value)
-      if (!IS_DELETED(entry) && entry->value != 0) {
-        return entry;
-      }
+    // Return entries that are not deleted and have been used (non-zero
+    // value)
+    if (!IS_DELETED(entry) && entry->value != 0) {
+      return entry;
     }
-
-    // Move to next table in chain
-    iter->table = iter->table->next;
-    iter->index = 0;
   }
 
   // Iteration complete - reset iterator for potential reuse
@@ -343,45 +503,25 @@ sys_hashtable_iterator_next(sys_hashtable_t *table,
   return NULL;
 }
 
-/** @brief Get the number of active entries in the hash table chain.
+/** @brief Get the number of active entries in the hash table.
  */
 size_t sys_hashtable_count(sys_hashtable_t *table) {
   sys_assert(table != NULL);
 
+  // Count entries that are not deleted and have been used (non-zero value)
   size_t count = 0;
-  sys_hashtable_t *current = table;
-
-  // Traverse all tables in the chain
-  while (current) {
-    // Count active entries in current table
-    for (size_t i = 0; i < current->size; i++) {
-      sys_hashtable_entry_t *entry = &current->entries[i];
-
-      // Count entries that are not deleted and have been used (non-zero
-      // value)
-      if (!IS_DELETED(entry) && entry->value != 0) {
-        count++;
-      }
+  for (size_t i = 0; i < table->size; i++) {
+    sys_hashtable_entry_t *entry = &table->entries[i];
+    if (!IS_DELETED(entry) && entry->value != 0) {
+      count++;
     }
-    current = current->next;
   }
-
   return count;
 }
 
-/** @brief Get the total capacity of all tables in the chain.
+/** @brief Get the capacity of the hash table.
  */
 size_t sys_hashtable_capacity(sys_hashtable_t *table) {
   sys_assert(table != NULL);
-
-  size_t capacity = 0;
-  sys_hashtable_t *current = table;
-
-  // Traverse all tables in the chain and sum their sizes
-  while (current) {
-    capacity += current->size;
-    current = current->next;
-  }
-
-  return capacity;
+  return table->size;
 }
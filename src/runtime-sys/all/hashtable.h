@@ -21,20 +21,43 @@
 #define SET_DELETED(entry) ((entry)->flags |= SYS_HASHTABLE_ENTRY_DELETED)
 #define CLEAR_DELETED(entry) ((entry)->flags &= ~SYS_HASHTABLE_ENTRY_DELETED)
 
+// Number of control bytes which are matched at once, which is a SIMD
+// register, or a word on targets without SIMD
+#if defined(__SSE2__) || (defined(__ARM_NEON) && defined(__aarch64__))
+#define SYS_HASHTABLE_GROUP 16
+#else
+#define SYS_HASHTABLE_GROUP 4
+#endif
+
+// Control bytes. A used entry has the top seven bits of its mixed hash, so
+// the high bit is clear
+#define SYS_HASHTABLE_CTRL_EMPTY 0x80   ///< Entry has never been used
+#define SYS_HASHTABLE_CTRL_DELETED 0xFE ///< Entry is a tombstone
+#define SYS_HASHTABLE_CTRL_PADDING 0xFF ///< Past the last entry in a group
+#define IS_FULL(ctrl) ((ctrl) < 0x80)
+
 ///////////////////////////////////////////////////////////////////////////////
 // PRIVATE TYPES
 
 /** @brief Represents a hash table.
  */
 struct sys_hashtable {
-  struct sys_hashtable *next;
-  size_t size;
+  size_t size;    ///< Number of entries, which is a power of two
+  size_t groups;  ///< Number of groups of control bytes
+  size_t used;    ///< Number of entries which hold a key or a tombstone
+  size_t deleted; ///< Number of entries which hold a tombstone
   sys_hashtable_keyequals_t keyequals;
   /**
-   * @brief Points to memory allocated after the struct, which contains the
-   * hash table buckets.
+   * @brief Points to the hash table buckets, which are allocated separately
+   * so that they can be replaced when the table is resized.
    */
   sys_hashtable_entry_t *entries;
+  /**
+   * @brief Points to a control byte for each entry, allocated after the
+   * entries and padded to a whole number of groups, so that a group of
+   * entries can be searched by comparing control bytes.
+   */
+  uint8_t *ctrl;
 #if defined(__LP64__) || defined(_WIN64)
 } __attribute__((aligned(8))); // 64-bit systems: 8-byte alignment
 #else
@@ -1,4 +1,76 @@
 #include <objc/objc.h>
+#include <runtime-sys/sys.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Number of lock stripes, which should be a power of 2. Objects which hash to
+ * the same stripe share a lock, so more stripes means less contention between
+ * unrelated objects.
+ */
+#ifdef SYSTEM_NAME_PICO
+#define OBJC_SYNC_STRIPES 8
+#else
+#define OBJC_SYNC_STRIPES 64
+#endif
+
+/*
+ * A lock stripe. The owner is only ever set to the identifier of the calling
+ * thread while the mutex is held, and is cleared before the mutex is
+ * released, so a thread can check whether it already holds the stripe
+ * without taking the mutex. Stripes are aligned so that each is on its own
+ * cache line.
+ */
+struct objc_sync_stripe {
+  sys_mutex_t mutex; // Lock for the objects in the stripe
+  uintptr_t owner;   // Identifier of the thread holding the lock, or 0
+  uint32_t depth;    // Number of times the owner has entered the lock
+} __attribute__((aligned(64)));
+
+static struct objc_sync_stripe objc_sync_stripes[OBJC_SYNC_STRIPES];
+
+// 0 = not initialized, 1 = initializing, 2 = initialized
+static uint32_t objc_sync_state = 0;
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE METHODS
+
+/*
+ * Initialize the lock stripes on first use. Threads which race to initialize
+ * the stripes wait until the first thread has finished.
+ */
+static void _objc_sync_init(void) {
+  uint32_t expected = 0;
+  if (__atomic_compare_exchange_n(&objc_sync_state, &expected, 1, false,
+                                  __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+    for (int i = 0; i < OBJC_SYNC_STRIPES; i++) {
+      objc_sync_stripes[i].mutex = sys_mutex_init();
+      objc_sync_stripes[i].owner = 0;
+      objc_sync_stripes[i].depth = 0;
+    }
+    __atomic_store_n(&objc_sync_state, 2, __ATOMIC_RELEASE);
+    return;
+  }
+  while (__atomic_load_n(&objc_sync_state, __ATOMIC_ACQUIRE) != 2) {
+    // Wait for the other thread to finish initializing
+  }
+}
+
+/*
+ * Return the lock stripe for an object. Objects are at least 8-byte aligned,
+ * so the low bits of the address are discarded.
+ */
+static inline struct objc_sync_stripe *_objc_sync_stripe(id obj) {
+  if (__atomic_load_n(&objc_sync_state, __ATOMIC_ACQUIRE) != 2) {
+    _objc_sync_init();
+  }
+  uintptr_t p = (uintptr_t)obj >> 3;
+  p ^= p >> 7;
+  return &objc_sync_stripes[p & (OBJC_SYNC_STRIPES - 1)];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PUBLIC METHODS
 
 /**
  * @brief Acquire a lock on the specified object for thread synchronization.
@@ -7,7 +79,21 @@ int objc_sync_enter(id obj) {
   if (obj == nil) {
     return -1; // Error code for nil object
   }
-  // TODO
+  struct objc_sync_stripe *stripe = _objc_sync_stripe(obj);
+  uintptr_t self = sys_thread_id();
+
+  // If this thread already holds the stripe, then enter it again
+  if (__atomic_load_n(&stripe->owner, __ATOMIC_RELAXED) == self) {
+    stripe->depth++;
+    return 0;
+  }
+
+  // Acquire the lock and take ownership
+  if (!sys_mutex_lock(&stripe->mutex)) {
+    return -1;
+  }
+  __atomic_store_n(&stripe->owner, self, __ATOMIC_RELAXED);
+  stripe->depth = 1;
   return 0; // Success
 }
 
@@ -18,6 +104,20 @@ int objc_sync_exit(id obj) {
   if (obj == nil) {
     return -1; // Error code for nil object
   }
-  // TODO
+  struct objc_sync_stripe *stripe = _objc_sync_stripe(obj);
+
+  // The lock must be held by this thread
+  if (__atomic_load_n(&stripe->owner, __ATOMIC_RELAXED) != sys_thread_id()) {
+    return -1;
+  }
+  if (--stripe->depth > 0) {
+    return 0; // Still held by an outer objc_sync_enter
+  }
+
+  // Give up ownership and release the lock
+  __atomic_store_n(&stripe->owner, 0, __ATOMIC_RELAXED);
+  if (!sys_mutex_unlock(&stripe->mutex)) {
+    return -1;
+  }
   return 0; // Success
 }
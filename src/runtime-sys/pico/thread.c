@@ -3,6 +3,17 @@
 #include <pico/stdlib.h>
 #include <runtime-sys/sys.h>
 
+// Maximum number of exit functions for the thread on each core
+#define PICO_THREAD_ATEXIT_MAX 4
+
+// The exit functions for the thread on each core. Each core only changes its
+// own functions, so no lock is needed.
+static struct {
+  sys_thread_func_t func;
+  void *arg;
+} pico_thread_atexit[NUM_CORES][PICO_THREAD_ATEXIT_MAX];
+static uint8_t pico_thread_atexit_count[NUM_CORES] = {0};
+
 /**
  * @brief Wrapper function to adapt sys_thread_func_t to Pico multicore function
  */
@@ -17,6 +28,13 @@ static void pico_thread_wrapper(void) {
   } else {
     sys_panicf("Pico thread wrapper: function pointer is NULL");
   }
+
+  // Call the exit functions, most recent first
+  uint8_t core = get_core_num();
+  while (pico_thread_atexit_count[core] > 0) {
+    uint8_t i = --pico_thread_atexit_count[core];
+    pico_thread_atexit[core][i].func(pico_thread_atexit[core][i].arg);
+  }
 }
 
 /**
@@ -38,6 +56,25 @@ uint8_t sys_thread_core(void) {
   return (uint8_t)get_core_num();
 }
 
+uintptr_t sys_thread_id(void) {
+  // Each core runs a single thread, so the core number identifies the thread
+  return (uintptr_t)get_core_num() + 1;
+}
+
+bool sys_thread_atexit(sys_thread_func_t func, void *arg) {
+  uint8_t core = get_core_num();
+  if (func == NULL) {
+    return false;
+  }
+  if (pico_thread_atexit_count[core] >= PICO_THREAD_ATEXIT_MAX) {
+    return false; // No more exit functions for this core
+  }
+  uint8_t i = pico_thread_atexit_count[core]++;
+  pico_thread_atexit[core][i].func = func;
+  pico_thread_atexit[core][i].arg = arg;
+  return true;
+}
+
 /**
  * @brief Pauses the execution of the current thread for a specified time.
  */
@@ -25,6 +25,21 @@
 #include <sys/sysinfo.h>
 #endif
 
+/**
+ * @brief Function to call when a thread exits, in a list for each thread
+ */
+typedef struct thread_atexit {
+  struct thread_atexit *next;
+  sys_thread_func_t func;
+  void *arg;
+} thread_atexit_t;
+
+// The key for the list of exit functions of each thread. It is created once,
+// with a destructor which calls the functions when the thread exits.
+static pthread_key_t thread_atexit_key;
+static pthread_once_t thread_atexit_once = PTHREAD_ONCE_INIT;
+static bool thread_atexit_valid = false;
+
 /**
  * @brief Thread wrapper structure for pthread compatibility
  */
@@ -210,3 +225,50 @@ uint8_t sys_thread_core(void) {
   // Default fallback for other platforms or if detection fails
   return 0;
 }
+
+uintptr_t sys_thread_id(void) { return (uintptr_t)pthread_self(); }
+
+/**
+ * @brief Call the exit functions of a thread, most recent first
+ */
+static void thread_atexit_run(void *value) {
+  thread_atexit_t *entry = (thread_atexit_t *)value;
+  while (entry != NULL) {
+    thread_atexit_t *next = entry->next;
+    entry->func(entry->arg);
+    sys_free(entry);
+    entry = next;
+  }
+}
+
+/**
+ * @brief Create the key for the exit functions
+ */
+static void thread_atexit_init(void) {
+  thread_atexit_valid =
+      pthread_key_create(&thread_atexit_key, thread_atexit_run) == 0;
+}
+
+bool sys_thread_atexit(sys_thread_func_t func, void *arg) {
+  if (func == NULL) {
+    return false;
+  }
+  if (pthread_once(&thread_atexit_once, thread_atexit_init) != 0 ||
+      thread_atexit_valid == false) {
+    return false;
+  }
+
+  // Add the function to the front of the list for the thread
+  thread_atexit_t *entry = sys_malloc(sizeof(thread_atexit_t));
+  if (entry == NULL) {
+    return false;
+  }
+  entry->func = func;
+  entry->arg = arg;
+  entry->next = (thread_atexit_t *)pthread_getspecific(thread_atexit_key);
+  if (pthread_setspecific(thread_atexit_key, entry) != 0) {
+    sys_free(entry);
+    return false;
+  }
+  return true;
+}
@@ -24,4 +24,17 @@ add_subdirectory(NXFoundation_21)
 add_subdirectory(NXFoundation_22)
 add_subdirectory(NXFoundation_23)
 add_subdirectory(NXFoundation_24)
+add_subdirectory(NXFoundation_25)
+add_subdirectory(NXFoundation_26)
+add_subdirectory(NXFoundation_27)
+add_subdirectory(NXFoundation_28)
+add_subdirectory(NXFoundation_29)
+add_subdirectory(NXFoundation_30)
+add_subdirectory(NXFoundation_31)
+add_subdirectory(NXFoundation_32)
+add_subdirectory(NXFoundation_33)
+add_subdirectory(NXFoundation_34)
+add_subdirectory(NXFoundation_35)
+add_subdirectory(NXFoundation_36)
+add_subdirectory(NXFoundation_37)
 
@@ -0,0 +1,140 @@
+#include <Foundation/Foundation.h>
+#include <runtime-sys/sys.h>
+#include <tests/tests.h>
+
+// Maximum number of threads in the benchmark
+#ifdef SYSTEM_NAME_PICO
+#define MAX_THREADS 2
+#define ITERATIONS 20000
+#else
+#define MAX_THREADS 8
+#define ITERATIONS 200000
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// FORWARD DECLARATIONS
+
+int test_retain_release(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// COUNTED OBJECT
+
+static int deallocCount = 0;
+
+@interface Counted : NXObject
+@end
+
+@implementation Counted
+- (void)dealloc {
+  deallocCount++;
+  [super dealloc];
+}
+@end
+
+///////////////////////////////////////////////////////////////////////////////
+// MAIN
+
+int main(void) {
+  NXZone *zone = [NXZone zoneWithSize:2048];
+  test_assert(zone != nil);
+
+  // Run the test for retain and release
+  int returnValue = TestMain("NXFoundation_25", test_retain_release);
+
+  // Clean up
+  [zone release];
+
+  // Return the result of the test
+  return returnValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// WORKERS
+
+typedef struct {
+  sys_waitgroup_t *wg;
+  id object;
+  uint32_t iterations;
+} worker_args_t;
+
+static void worker_fn(void *arg) {
+  worker_args_t *w = (worker_args_t *)arg;
+  for (uint32_t i = 0; i < w->iterations; i++) {
+    [w->object retain];
+    [w->object release];
+  }
+  if (w->wg != NULL) {
+    sys_waitgroup_done(w->wg);
+  }
+}
+
+// Start a worker on another thread, or return false
+static bool start_worker(worker_args_t *args) {
+#ifdef SYSTEM_NAME_PICO
+  return sys_thread_create_on_core(worker_fn, args, 1);
+#else
+  return sys_thread_create(worker_fn, args);
+#endif
+}
+
+// Send retain/release pairs to the object from the given number of threads,
+// one of which is the calling thread, and print the throughput. Returns NO
+// if a thread could not be created.
+static BOOL benchmark(id object, int nthreads) {
+  worker_args_t args[MAX_THREADS];
+  sys_waitgroup_t wg = sys_waitgroup_init();
+  uint64_t start = sys_date_get_timestamp();
+  for (int i = 0; i < nthreads; i++) {
+    args[i].wg = i == 0 ? NULL : &wg;
+    args[i].object = object;
+    args[i].iterations = ITERATIONS;
+  }
+  for (int i = 1; i < nthreads; i++) {
+    sys_waitgroup_add(&wg, 1);
+    if (!start_worker(&args[i])) {
+      sys_printf("NXFoundation_25: failed to create thread %d\n", i);
+      sys_waitgroup_done(&wg);
+      sys_waitgroup_finalize(&wg);
+      return NO;
+    }
+  }
+  worker_fn(&args[0]);
+  sys_waitgroup_finalize(&wg);
+  uint64_t ms = sys_date_get_timestamp() - start;
+
+  uint64_t pairs = (uint64_t)nthreads * ITERATIONS;
+  sys_printf("NXFoundation_25: threads=%d pairs=%u time=%ums pairs/s=%u\n",
+             nthreads, (unsigned)pairs, (unsigned)ms,
+             (unsigned)(ms > 0 ? pairs * 1000 / ms : pairs * 1000));
+  return YES;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TESTS
+
+int test_retain_release(void) {
+  // An object is deallocated when the last reference is released
+  Counted *object = [[Counted alloc] init];
+  test_assert(object != nil);
+  test_assert([object retain] == object);
+  [object release];
+  test_assert(deallocCount == 0);
+  [object release];
+  test_assert(deallocCount == 1);
+
+  // Throughput from one thread up to the number of cores. The object is
+  // only deallocated by the final release.
+  object = [[Counted alloc] init];
+  test_assert(object != nil);
+  int nthreads = sys_thread_numcores();
+  if (nthreads > MAX_THREADS) {
+    nthreads = MAX_THREADS;
+  }
+  for (int n = 1; n <= nthreads; n++) {
+    test_assert(benchmark(object, n));
+    test_assert(deallocCount == 1);
+  }
+  [object release];
+  test_assert(deallocCount == 2);
+  return 0;
+}
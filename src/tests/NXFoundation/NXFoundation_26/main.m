@@ -0,0 +1,126 @@
+#include <Foundation/Foundation.h>
+#include <runtime-sys/sys.h>
+#include <tests/tests.h>
+
+// Number of allocations in the benchmark
+#ifdef SYSTEM_NAME_PICO
+#define ALLOCATIONS 10000
+#define LIVE 256
+#else
+#define ALLOCATIONS 100000
+#define LIVE 4096
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// FORWARD DECLARATIONS
+
+int test_zone_slabs(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// MAIN
+
+int main(void) {
+  NXZone *zone = [NXZone zoneWithSize:64 * 1024];
+  test_assert(zone != nil);
+
+  // Run the test for the zone slabs
+  int returnValue = TestMain("NXFoundation_26", test_zone_slabs);
+
+  // Clean up
+  [zone release];
+
+  // Return the result of the test
+  return returnValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// HELPERS
+
+// Return an allocation size: mostly small objects, with one in sixteen
+// allocations too large for a slab
+static size_t allocation_size(uint32_t i) {
+  if (i % 16 == 0) {
+    return 300 + (i % 700);
+  }
+  return 8 + (i % 31) * 8;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TESTS
+
+int test_zone_slabs(void) {
+  NXZone *zone = [NXZone defaultZone];
+  size_t used = [zone bytesUsed];
+  size_t total = [zone bytesTotal];
+
+  // Allocations of different sizes do not overlap
+  void *small = [zone allocWithSize:24];
+  void *medium = [zone allocWithSize:200];
+  void *large = [zone allocWithSize:1024];
+  test_assert(small != NULL && medium != NULL && large != NULL);
+  sys_memset(small, 0x11, 24);
+  sys_memset(medium, 0x22, 200);
+  sys_memset(large, 0x33, 1024);
+  test_assert(((uint8_t *)small)[23] == 0x11);
+  test_assert(((uint8_t *)medium)[199] == 0x22);
+  test_assert(((uint8_t *)large)[1023] == 0x33);
+  test_assert([zone bytesUsed] > used);
+  [zone dump];
+
+  // A freed block is reused by the next allocation of the same size
+  [zone free:small];
+  test_assert([zone allocWithSize:24] == small);
+  [zone free:small];
+  [zone free:medium];
+  [zone free:large];
+
+  // Allocate and free mixed-size blocks, keeping up to LIVE blocks
+  // allocated at once
+  static void *ptrs[LIVE];
+  uint64_t start = sys_date_get_timestamp();
+  for (uint32_t i = 0; i < ALLOCATIONS; i++) {
+    uint32_t slot = i % LIVE;
+    if (ptrs[slot] != NULL) {
+      [zone free:ptrs[slot]];
+    }
+    ptrs[slot] = [zone allocWithSize:allocation_size(i)];
+    test_assert(ptrs[slot] != NULL);
+  }
+  for (uint32_t i = 0; i < LIVE; i++) {
+    [zone free:ptrs[i]];
+    ptrs[i] = NULL;
+  }
+  uint64_t ms = sys_date_get_timestamp() - start;
+  sys_printf("NXFoundation_26: allocations=%u time=%ums allocs/s=%u\n",
+             (unsigned)ALLOCATIONS, (unsigned)ms,
+             (unsigned)(ms > 0 ? (uint64_t)ALLOCATIONS * 1000 / ms
+                               : (uint64_t)ALLOCATIONS * 1000));
+
+  // Statistics account for all the memory in the zone
+  [zone dump];
+  test_assert([zone bytesTotal] >= total);
+  test_assert([zone bytesUsed] + [zone bytesFree] <= [zone bytesTotal]);
+
+  // Freed neighbouring blocks are merged, so a larger block fits in the
+  // space they leave without growing the zone
+  NXZone *small_zone = [NXZone zoneWithSize:4096];
+  test_assert(small_zone != nil);
+  void *blocks[6];
+  for (int i = 0; i < 6; i++) {
+    blocks[i] = [small_zone allocWithSize:512];
+    test_assert(blocks[i] != NULL);
+  }
+  size_t small_total = [small_zone bytesTotal];
+  for (int i = 0; i < 6; i += 2) {
+    [small_zone free:blocks[i]];
+  }
+  for (int i = 1; i < 6; i += 2) {
+    [small_zone free:blocks[i]];
+  }
+  void *merged = [small_zone allocWithSize:3000];
+  test_assert(merged != NULL);
+  test_assert([small_zone bytesTotal] == small_total);
+  [small_zone free:merged];
+  [small_zone release];
+  return 0;
+}
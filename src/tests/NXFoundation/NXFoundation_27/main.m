@@ -0,0 +1,166 @@
+#include <Foundation/Foundation.h>
+#include <runtime-sys/sys.h>
+#include <tests/tests.h>
+
+// Maximum number of threads in the benchmark
+#ifdef SYSTEM_NAME_PICO
+#define MAX_THREADS 2
+#define ITERATIONS 2000
+#else
+#define MAX_THREADS 8
+#define ITERATIONS 20000
+#endif
+
+// Number of blocks each thread holds at once
+#define BATCH 16
+
+///////////////////////////////////////////////////////////////////////////////
+// FORWARD DECLARATIONS
+
+int test_zone_threads(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// MAIN
+
+int main(void) {
+  NXZone *zone = [NXZone zoneWithSize:64 * 1024];
+  test_assert(zone != nil);
+
+  // Run the test for allocation from several threads
+  int returnValue = TestMain("NXFoundation_27", test_zone_threads);
+
+  // Clean up
+  [zone release];
+
+  // Return the result of the test
+  return returnValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// WORKERS
+
+typedef struct {
+  sys_waitgroup_t *wg;
+  NXZone *zone;
+  uint32_t iterations;
+  uint32_t errors;
+} worker_args_t;
+
+// Allocate and free batches of small blocks, checking that no other thread
+// writes to a block while it is allocated
+static void worker_fn(void *arg) {
+  worker_args_t *w = (worker_args_t *)arg;
+  void *blocks[BATCH];
+  for (uint32_t i = 0; i < w->iterations; i++) {
+    for (uint32_t j = 0; j < BATCH; j++) {
+      size_t size = 16 + ((i + j) % 16) * 16;
+      blocks[j] = [w->zone allocWithSize:size];
+      if (blocks[j] == NULL) {
+        w->errors++;
+        continue;
+      }
+      *(uintptr_t *)blocks[j] = (uintptr_t)blocks[j] ^ (uintptr_t)w;
+    }
+    for (uint32_t j = 0; j < BATCH; j++) {
+      if (blocks[j] == NULL) {
+        continue;
+      }
+      if (*(uintptr_t *)blocks[j] != ((uintptr_t)blocks[j] ^ (uintptr_t)w)) {
+        w->errors++;
+      }
+      [w->zone free:blocks[j]];
+    }
+  }
+
+  // The cached blocks are returned to the zone when the thread exits
+  if (w->wg != NULL) {
+    sys_waitgroup_done(w->wg);
+  }
+}
+
+// Start a worker on another thread, or return false
+static bool start_worker(worker_args_t *args) {
+#ifdef SYSTEM_NAME_PICO
+  return sys_thread_create_on_core(worker_fn, args, 1);
+#else
+  return sys_thread_create(worker_fn, args);
+#endif
+}
+
+// Allocate and free blocks from the given number of threads, one of which is
+// the calling thread, and print the throughput. Returns NO if a thread could
+// not be created or a block was corrupted.
+static BOOL benchmark(NXZone *zone, int nthreads) {
+  worker_args_t args[MAX_THREADS];
+  sys_waitgroup_t wg = sys_waitgroup_init();
+  uint64_t start = sys_date_get_timestamp();
+  for (int i = 0; i < nthreads; i++) {
+    args[i].wg = i == 0 ? NULL : &wg;
+    args[i].zone = zone;
+    args[i].iterations = ITERATIONS;
+    args[i].errors = 0;
+  }
+  for (int i = 1; i < nthreads; i++) {
+    sys_waitgroup_add(&wg, 1);
+    if (!start_worker(&args[i])) {
+      sys_printf("NXFoundation_27: failed to create thread %d\n", i);
+      sys_waitgroup_done(&wg);
+      sys_waitgroup_finalize(&wg);
+      return NO;
+    }
+  }
+  worker_fn(&args[0]);
+  sys_waitgroup_finalize(&wg);
+  uint64_t ms = sys_date_get_timestamp() - start;
+
+  // The calling thread does not exit, so it returns its cached blocks
+  [zone flushCache];
+
+  for (int i = 0; i < nthreads; i++) {
+    if (args[i].errors != 0) {
+      sys_printf("NXFoundation_27: thread %d had %u errors\n", i,
+                 (unsigned)args[i].errors);
+      return NO;
+    }
+  }
+  uint64_t allocs = (uint64_t)nthreads * ITERATIONS * BATCH;
+  sys_printf("NXFoundation_27: threads=%d allocs=%u time=%ums allocs/s=%u\n",
+             nthreads, (unsigned)allocs, (unsigned)ms,
+             (unsigned)(ms > 0 ? allocs * 1000 / ms : allocs * 1000));
+  return YES;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TESTS
+
+int test_zone_threads(void) {
+  NXZone *zone = [NXZone defaultZone];
+
+  // A block freed by this thread is reused by its next allocation
+  void *block = [zone allocWithSize:32];
+  test_assert(block != NULL);
+  [zone free:block];
+  test_assert([zone allocWithSize:32] == block);
+  [zone free:block];
+  [zone flushCache];
+
+  // Throughput from one thread up to the number of cores. The first run
+  // leaves a slab page for each size class, and after each later run the
+  // memory used by the zone returns to where it was. The cache of each
+  // thread is flushed when the thread exits, which may be shortly after it
+  // finishes.
+  int nthreads = sys_thread_numcores();
+  if (nthreads > MAX_THREADS) {
+    nthreads = MAX_THREADS;
+  }
+  test_assert(benchmark(zone, 1));
+  size_t used = [zone bytesUsed];
+  for (int n = 2; n <= nthreads; n++) {
+    test_assert(benchmark(zone, n));
+    for (int i = 0; i < 100 && [zone bytesUsed] != used; i++) {
+      sys_sleep(10);
+    }
+    test_assert([zone bytesUsed] == used);
+  }
+  return 0;
+}
@@ -0,0 +1,119 @@
+#include <Foundation/Foundation.h>
+#include <runtime-sys/sys.h>
+#include <string.h>
+#include <tests/tests.h>
+
+// Number of run loop iterations in the benchmark
+#ifdef SYSTEM_NAME_PICO
+#define ITERATIONS 1000
+#else
+#define ITERATIONS 10000
+#endif
+
+// Number of objects allocated in each iteration
+#define OBJECTS 16
+
+///////////////////////////////////////////////////////////////////////////////
+// FORWARD DECLARATIONS
+
+int test_zone_scratch(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// MAIN
+
+int main(void) {
+  NXZone *zone = [NXZone zoneWithSize:64 * 1024];
+  test_assert(zone != nil);
+
+  // Run the test for scratch zones
+  int returnValue = TestMain("NXFoundation_28", test_zone_scratch);
+
+  // Clean up
+  [zone release];
+
+  // Return the result of the test
+  return returnValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// HELPERS
+
+// Allocate and release objects in a zone, as in one run loop iteration
+static uint64_t run_iterations(NXZone *zone) {
+  uint64_t start = sys_date_get_timestamp();
+  for (uint32_t i = 0; i < ITERATIONS; i++) {
+    NXObject *objects[OBJECTS];
+    for (uint32_t j = 0; j < OBJECTS; j++) {
+      objects[j] = [[NXObject allocWithZone:zone] init];
+      test_assert(objects[j] != nil);
+    }
+    for (uint32_t j = 0; j < OBJECTS; j++) {
+      [objects[j] release];
+    }
+    [zone reset];
+  }
+  return sys_date_get_timestamp() - start;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TESTS
+
+int test_zone_scratch(void) {
+  // A scratch zone is not the default zone
+  NXZone *defaultZone = [NXZone defaultZone];
+  NXZone *scratch = [NXZone scratchZoneWithSize:1024];
+  test_assert(scratch != nil);
+  test_assert([NXZone defaultZone] == defaultZone);
+  size_t used = [scratch bytesUsed];
+  size_t total = [scratch bytesTotal];
+
+  // Allocations follow each other, and freeing does nothing
+  uint8_t *a = [scratch allocWithSize:10];
+  uint8_t *b = [scratch allocWithSize:20];
+  test_assert(a != NULL && b != NULL);
+  test_assert(((uintptr_t)a & 7) == 0 && ((uintptr_t)b & 7) == 0);
+  test_assert(b == a + 16);
+  [scratch free:a];
+  test_assert([scratch allocWithSize:8] == b + 24);
+  test_assert([scratch bytesUsed] == used + 48);
+
+  // Objects are created in the zone, and releasing them does not free them
+  NXString *string =
+      [[NXString allocWithZone:scratch] initWithFormat:@"scratch %d", 42];
+  test_assert(string != nil);
+  test_assert([string length] == 10);
+  test_assert(strcmp([string cStr], "scratch 42") == 0);
+  [string release];
+
+  // The zone grows when it is full
+  for (int i = 0; i < 8; i++) {
+    test_assert([scratch allocWithSize:256] != NULL);
+  }
+  test_assert([scratch bytesTotal] > total);
+  [scratch dump];
+
+  // Reset recycles all the memory, and keeps the chunks
+  size_t grown = [scratch bytesTotal];
+  [scratch reset];
+  test_assert([scratch bytesUsed] == used);
+  test_assert([scratch bytesTotal] == grown);
+  test_assert([scratch allocWithSize:10] == a);
+  [scratch reset];
+
+  // Reset does nothing for a general zone
+  void *block = [defaultZone allocWithSize:10];
+  test_assert(block != NULL);
+  [defaultZone reset];
+  [defaultZone free:block];
+
+  // Compare objects created in a scratch zone and in the default zone
+  uint64_t scratch_ms = run_iterations(scratch);
+  uint64_t default_ms = run_iterations(defaultZone);
+  sys_printf("NXFoundation_28: objects=%u scratch=%ums default=%ums\n",
+             (unsigned)(ITERATIONS * OBJECTS), (unsigned)scratch_ms,
+             (unsigned)default_ms);
+  test_assert([scratch bytesUsed] == used);
+
+  [scratch release];
+  return 0;
+}
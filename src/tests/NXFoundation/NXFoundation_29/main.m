@@ -0,0 +1,128 @@
+#include <Foundation/Foundation.h>
+#include <runtime-sys/sys.h>
+#include <tests/tests.h>
+
+// Number of objects in the benchmark
+#ifdef SYSTEM_NAME_PICO
+#define OBJECTS 2000
+#else
+#define OBJECTS 100000
+#endif
+
+// Number of objects deallocated
+static int deallocated = 0;
+
+///////////////////////////////////////////////////////////////////////////////
+// TEST CLASSES
+
+@interface Tracked : NXObject {
+  BOOL _child; ///< Autorelease another object when deallocated
+}
+- (id)initWithChild:(BOOL)child;
+@end
+
+@implementation Tracked
+- (id)initWithChild:(BOOL)child {
+  self = [super init];
+  if (self) {
+    _child = child;
+  }
+  return self;
+}
+- (void)dealloc {
+  deallocated++;
+  if (_child) {
+    [[[Tracked alloc] initWithChild:NO] autorelease];
+  }
+  [super dealloc];
+}
+@end
+
+///////////////////////////////////////////////////////////////////////////////
+// FORWARD DECLARATIONS
+
+int test_autorelease_pages(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// MAIN
+
+int main(void) {
+  NXZone *zone = [NXZone zoneWithSize:64 * 1024];
+  test_assert(zone != nil);
+
+  // Run the test for autorelease pool pages
+  int returnValue = TestMain("NXFoundation_29", test_autorelease_pages);
+
+  // Clean up
+  [zone release];
+
+  // Return the result of the test
+  return returnValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TESTS
+
+int test_autorelease_pages(void) {
+  NXAutoreleasePool *pool = [[NXAutoreleasePool alloc] init];
+  test_assert(pool != nil);
+  size_t used = [[NXZone defaultZone] bytesUsed];
+
+  // Objects across many pages are all released by a drain
+  deallocated = 0;
+  for (int i = 0; i < 1000; i++) {
+    test_assert([[[Tracked alloc] initWithChild:NO] autorelease] != nil);
+  }
+  test_assert(deallocated == 0);
+  [pool drain];
+  test_assert(deallocated == 1000);
+
+  // An object added twice is released twice
+  deallocated = 0;
+  Tracked *twice = [[Tracked alloc] initWithChild:NO];
+  [[twice retain] autorelease];
+  [twice autorelease];
+  [pool drain];
+  test_assert(deallocated == 1);
+
+  // Objects autoreleased while the pool is drained are also released
+  deallocated = 0;
+  for (int i = 0; i < 10; i++) {
+    [[[Tracked alloc] initWithChild:YES] autorelease];
+  }
+  [pool drain];
+  test_assert(deallocated == 20);
+
+  // Draining an inner pool does not release objects in the outer pool
+  deallocated = 0;
+  [[[Tracked alloc] initWithChild:NO] autorelease];
+  NXAutoreleasePool *inner = [[NXAutoreleasePool alloc] init];
+  test_assert([NXAutoreleasePool currentPool] == inner);
+  [[[Tracked alloc] initWithChild:NO] autorelease];
+  [inner release];
+  test_assert(deallocated == 1);
+  test_assert([NXAutoreleasePool currentPool] == pool);
+  [pool drain];
+  test_assert(deallocated == 2);
+
+  // Extra pages are freed by a drain
+  test_assert([[NXZone defaultZone] bytesUsed] <= used + 4096);
+
+  // Autorelease and drain many objects
+  uint64_t start = sys_date_get_timestamp();
+  for (int i = 0; i < OBJECTS; i++) {
+    [[[NXObject alloc] init] autorelease];
+    if (i % 1000 == 999) {
+      [pool drain];
+    }
+  }
+  [pool drain];
+  uint64_t ms = sys_date_get_timestamp() - start;
+  sys_printf("NXFoundation_29: objects=%u time=%ums objects/s=%u\n",
+             (unsigned)OBJECTS, (unsigned)ms,
+             (unsigned)(ms > 0 ? (uint64_t)OBJECTS * 1000 / ms
+                               : (uint64_t)OBJECTS * 1000));
+
+  [pool release];
+  return 0;
+}
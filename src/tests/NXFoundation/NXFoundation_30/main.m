@@ -0,0 +1,168 @@
+#include <Foundation/Foundation.h>
+#include <runtime-sys/sys.h>
+#include <tests/tests.h>
+
+// Maximum number of threads in the benchmark
+#ifdef SYSTEM_NAME_PICO
+#define MAX_THREADS 2
+#define OBJECTS 2000
+#else
+#define MAX_THREADS 8
+#define OBJECTS 50000
+#endif
+
+// Number of objects deallocated, from all threads
+static sys_atomic_t deallocated;
+
+///////////////////////////////////////////////////////////////////////////////
+// TEST CLASSES
+
+@interface Tracked : NXObject
+@end
+
+@implementation Tracked
+- (void)dealloc {
+  sys_atomic_inc(&deallocated);
+  [super dealloc];
+}
+@end
+
+///////////////////////////////////////////////////////////////////////////////
+// FORWARD DECLARATIONS
+
+int test_autorelease_threads(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// MAIN
+
+int main(void) {
+  NXZone *zone = [NXZone zoneWithSize:64 * 1024];
+  test_assert(zone != nil);
+
+  // Run the test for autorelease pools on several threads
+  int returnValue = TestMain("NXFoundation_30", test_autorelease_threads);
+
+  // Clean up
+  [zone release];
+
+  // Return the result of the test
+  return returnValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// WORKERS
+
+typedef struct {
+  sys_waitgroup_t *wg;
+  uint32_t objects;
+  uint32_t errors;
+} worker_args_t;
+
+// Create a pool on the calling thread, autorelease objects into it and
+// drain it, checking that the pool is not shared with other threads
+static void worker_fn(void *arg) {
+  worker_args_t *w = (worker_args_t *)arg;
+  id outer = [NXAutoreleasePool currentPool];
+  NXAutoreleasePool *pool = [[NXAutoreleasePool alloc] init];
+  if (pool == nil || [NXAutoreleasePool currentPool] != pool) {
+    w->errors++;
+  }
+  for (uint32_t i = 0; i < w->objects; i++) {
+    [[[Tracked alloc] init] autorelease];
+    if (i % 100 == 99) {
+      [pool drain];
+    }
+    if ([NXAutoreleasePool currentPool] != pool) {
+      w->errors++;
+    }
+  }
+  [pool release];
+  if ([NXAutoreleasePool currentPool] != outer) {
+    w->errors++;
+  }
+
+  // Return the cached zone blocks before the thread exits
+  [[NXZone defaultZone] flushCache];
+  if (w->wg != NULL) {
+    sys_waitgroup_done(w->wg);
+  }
+}
+
+// Start a worker on another thread, or return false
+static bool start_worker(worker_args_t *args) {
+#ifdef SYSTEM_NAME_PICO
+  return sys_thread_create_on_core(worker_fn, args, 1);
+#else
+  return sys_thread_create(worker_fn, args);
+#endif
+}
+
+// Autorelease objects from the given number of threads, one of which is the
+// calling thread, and print the throughput. Returns NO if a thread could not
+// be created or a thread saw another thread's pool.
+static BOOL benchmark(int nthreads) {
+  worker_args_t args[MAX_THREADS];
+  sys_waitgroup_t wg = sys_waitgroup_init();
+  sys_atomic_set(&deallocated, 0);
+  uint64_t start = sys_date_get_timestamp();
+  for (int i = 0; i < nthreads; i++) {
+    args[i].wg = i == 0 ? NULL : &wg;
+    args[i].objects = OBJECTS;
+    args[i].errors = 0;
+  }
+  for (int i = 1; i < nthreads; i++) {
+    sys_waitgroup_add(&wg, 1);
+    if (!start_worker(&args[i])) {
+      sys_printf("NXFoundation_30: failed to create thread %d\n", i);
+      sys_waitgroup_done(&wg);
+      sys_waitgroup_finalize(&wg);
+      return NO;
+    }
+  }
+  worker_fn(&args[0]);
+  sys_waitgroup_finalize(&wg);
+  uint64_t ms = sys_date_get_timestamp() - start;
+
+  for (int i = 0; i < nthreads; i++) {
+    if (args[i].errors != 0) {
+      sys_printf("NXFoundation_30: thread %d had %u errors\n", i,
+                 (unsigned)args[i].errors);
+      return NO;
+    }
+  }
+  uint64_t objects = (uint64_t)nthreads * OBJECTS;
+  if (sys_atomic_get(&deallocated) != objects) {
+    sys_printf("NXFoundation_30: %u of %u objects deallocated\n",
+               (unsigned)sys_atomic_get(&deallocated), (unsigned)objects);
+    return NO;
+  }
+  sys_printf("NXFoundation_30: threads=%d objects=%u time=%ums objects/s=%u\n",
+             nthreads, (unsigned)objects, (unsigned)ms,
+             (unsigned)(ms > 0 ? objects * 1000 / ms : objects * 1000));
+  return YES;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TESTS
+
+int test_autorelease_threads(void) {
+  // Pools are pushed and popped on the calling thread
+  test_assert([NXAutoreleasePool currentPool] == nil);
+  NXAutoreleasePool *pool = [[NXAutoreleasePool alloc] init];
+  test_assert([NXAutoreleasePool currentPool] == pool);
+
+  // Each thread drains its own pool, and the pool of this thread is the
+  // current pool again when the threads finish
+  int nthreads = sys_thread_numcores();
+  if (nthreads > MAX_THREADS) {
+    nthreads = MAX_THREADS;
+  }
+  for (int n = 1; n <= nthreads; n++) {
+    test_assert(benchmark(n));
+    test_assert([NXAutoreleasePool currentPool] == pool);
+  }
+
+  [pool release];
+  test_assert([NXAutoreleasePool currentPool] == nil);
+  return 0;
+}
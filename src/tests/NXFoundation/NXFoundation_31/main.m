@@ -0,0 +1,135 @@
+#include <Foundation/Foundation.h>
+#include <runtime-sys/sys.h>
+#include <tests/tests.h>
+
+// Number of objects in the benchmark
+#ifdef SYSTEM_NAME_PICO
+#define OBJECTS 10000
+#else
+#define OBJECTS 200000
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// TEST CLASSES
+
+@interface Pooled : NXObject {
+  int _value;
+}
+@end
+
+@implementation Pooled
+NXOBJECT_POOL(4)
+@end
+
+@interface LargePooled : Pooled {
+  char _data[256];
+}
+@end
+
+@implementation LargePooled
+@end
+
+///////////////////////////////////////////////////////////////////////////////
+// FORWARD DECLARATIONS
+
+int test_object_pool(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// MAIN
+
+int main(void) {
+  NXZone *zone = [NXZone zoneWithSize:64 * 1024];
+  test_assert(zone != nil);
+
+  // Run the test for object pools
+  int returnValue = TestMain("NXFoundation_31", test_object_pool);
+
+  // Clean up
+  [zone release];
+
+  // Return the result of the test
+  return returnValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// HELPERS
+
+// Allocate and release objects of a class, and return the time taken
+static uint64_t run_objects(Class cls) {
+  uint64_t start = sys_date_get_timestamp();
+  for (int i = 0; i < OBJECTS; i++) {
+    id object = [[cls alloc] init];
+    test_assert(object != nil);
+    [object release];
+  }
+  return sys_date_get_timestamp() - start;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TESTS
+
+int test_object_pool(void) {
+  // A pool zone allocates slots which fit the size, and is not the default
+  // zone
+  NXZone *defaultZone = [NXZone defaultZone];
+  NXZone *pool = [NXZone poolZoneWithSize:24 count:2];
+  test_assert(pool != nil);
+  test_assert([NXZone defaultZone] == defaultZone);
+  test_assert([pool allocWithSize:100] == NULL);
+
+  // Freed slots are reused first, and the pool grows when it is full
+  void *a = [pool allocWithSize:24];
+  void *b = [pool allocWithSize:8];
+  test_assert(a != NULL && b != NULL && a != b);
+  [pool free:a];
+  test_assert([pool allocWithSize:24] == a);
+  size_t total = [pool bytesTotal];
+  void *c = [pool allocWithSize:24];
+  test_assert(c != NULL);
+  test_assert([pool bytesTotal] > total);
+  test_assert([pool bytesUsed] == 3 * 24);
+  test_assert([pool bytesFree] == 24);
+  [pool dump];
+  [pool free:a];
+  [pool free:b];
+  [pool free:c];
+  test_assert([pool bytesUsed] == 0);
+  [pool release];
+
+  // A class with a pool allocates its instances from the pool, and a
+  // released instance is reused by the next allocation
+  test_assert([NXObject objectPool] == nil);
+  NXZone *objects = [Pooled objectPool];
+  test_assert(objects != nil);
+  test_assert([Pooled objectPool] == objects);
+  Pooled *first = [[Pooled alloc] init];
+  test_assert(first != nil);
+  test_assert([objects bytesUsed] > 0);
+  [first release];
+  test_assert([objects bytesUsed] == 0);
+  Pooled *second = [[Pooled alloc] init];
+  test_assert(second == first);
+
+  // An explicit zone is used instead of the pool
+  Pooled *zoned = [[Pooled allocWithZone:defaultZone] init];
+  test_assert(zoned != nil);
+  size_t used = [objects bytesUsed];
+  [zoned release];
+  test_assert([objects bytesUsed] == used);
+
+  // A subclass which is too large for a slot uses the default zone
+  LargePooled *large = [[LargePooled alloc] init];
+  test_assert(large != nil);
+  test_assert([objects bytesUsed] == used);
+  [large release];
+  [second release];
+  [objects dump];
+
+  // Compare objects from the pool and from the default zone
+  uint64_t pool_ms = run_objects([Pooled class]);
+  uint64_t zone_ms = run_objects([NXObject class]);
+  sys_printf("NXFoundation_31: objects=%u pool=%ums zone=%ums\n",
+             (unsigned)OBJECTS, (unsigned)pool_ms, (unsigned)zone_ms);
+  test_assert([objects bytesUsed] == 0);
+  return 0;
+}
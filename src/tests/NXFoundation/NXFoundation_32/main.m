@@ -0,0 +1,150 @@
+#include <Foundation/Foundation.h>
+#include <runtime-sys/sys.h>
+#include <tests/tests.h>
+
+// Number of appends in the benchmark
+#ifdef SYSTEM_NAME_PICO
+#define APPENDS 2000
+#else
+#define APPENDS 100000
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// FORWARD DECLARATIONS
+
+int test_zone_realloc(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// MAIN
+
+int main(void) {
+  NXZone *zone = [NXZone zoneWithSize:64 * 1024];
+  test_assert(zone != nil);
+
+  // Run the test for resizing memory
+  int returnValue = TestMain("NXFoundation_32", test_zone_realloc);
+
+  // Clean up
+  [zone release];
+
+  // Return the result of the test
+  return returnValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// HELPERS
+
+// Return YES if the first size bytes of memory are all set to a value
+static BOOL check_bytes(const void *ptr, uint8_t value, size_t size) {
+  const uint8_t *bytes = ptr;
+  for (size_t i = 0; i < size; i++) {
+    if (bytes[i] != value) {
+      return NO;
+    }
+  }
+  return YES;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TESTS
+
+int test_zone_realloc(void) {
+  // Memory at the end of the zone grows in place, and keeps its contents
+  NXZone *zone = [NXZone zoneWithSize:16 * 1024];
+  test_assert(zone != nil);
+  void *ptr = [zone allocWithSize:1024];
+  test_assert(ptr != NULL);
+  sys_memset(ptr, 0x11, 1024);
+  void *grown = [zone reallocWithPtr:ptr size:4096];
+  test_assert(grown == ptr);
+  test_assert(check_bytes(grown, 0x11, 1024));
+
+  // Memory which is followed by another allocation moves
+  void *next = [zone allocWithSize:1024];
+  test_assert(next != NULL);
+  void *moved = [zone reallocWithPtr:grown size:8192];
+  test_assert(moved != NULL && moved != grown);
+  test_assert(check_bytes(moved, 0x11, 1024));
+  [zone free:next];
+
+  // Shrinking keeps the memory in place, and releases the end of it
+  void *shrunk = [zone reallocWithPtr:moved size:512];
+  test_assert(shrunk == moved);
+  test_assert(check_bytes(shrunk, 0x11, 512));
+
+  // Small blocks stay in their size class, and move when they outgrow it
+  uint8_t *small = [zone reallocWithPtr:NULL size:20];
+  test_assert(small != NULL);
+  sys_memset(small, 0x22, 20);
+  test_assert([zone reallocWithPtr:small size:30] == small);
+  uint8_t *larger = [zone reallocWithPtr:small size:500];
+  test_assert(larger != NULL && larger != small);
+  test_assert(check_bytes(larger, 0x22, 20));
+
+  // A size of zero frees the memory, and releasing the zone checks that no
+  // memory was left allocated
+  test_assert([zone reallocWithPtr:larger size:0] == NULL);
+  test_assert([zone reallocWithPtr:shrunk size:0] == NULL);
+  [zone release];
+
+  // The last allocation in a scratch zone grows in place, and others are
+  // copied
+  NXZone *scratch = [NXZone scratchZoneWithSize:4096];
+  test_assert(scratch != nil);
+  void *first = [scratch allocWithSize:64];
+  sys_memset(first, 0x33, 64);
+  void *last = [scratch allocWithSize:64];
+  sys_memset(last, 0x44, 64);
+  test_assert([scratch reallocWithPtr:last size:1024] == last);
+  test_assert(check_bytes(last, 0x44, 64));
+  void *copy = [scratch reallocWithPtr:first size:128];
+  test_assert(copy != NULL && copy != first);
+  test_assert(check_bytes(copy, 0x33, 64));
+  [scratch release];
+
+  // Memory in a pool zone cannot outgrow its slot
+  NXZone *pool = [NXZone poolZoneWithSize:32 count:4];
+  test_assert(pool != nil);
+  void *slot = [pool allocWithSize:16];
+  test_assert([pool reallocWithPtr:slot size:32] == slot);
+  test_assert([pool reallocWithPtr:slot size:33] == NULL);
+  [pool free:slot];
+  [pool release];
+
+  // Repeated appends grow the capacity geometrically
+  NXZone *appendZone = [NXZone zoneWithSize:64 * 1024];
+  test_assert(appendZone != nil);
+  uint64_t start = sys_date_get_timestamp();
+  NXString *string = [[NXString allocWithZone:appendZone] init];
+  NXData *data = [[NXData allocWithZone:appendZone] init];
+  NXArray *array = [[NXArray allocWithZone:appendZone] init];
+  size_t stringGrowth = 0, dataGrowth = 0, arrayGrowth = 0;
+  for (int i = 0; i < APPENDS; i++) {
+    size_t stringCap = [string capacity];
+    size_t dataCap = [data capacity];
+    size_t arrayCap = [array capacity];
+    test_assert([string appendCString:"x"]);
+    test_assert([data appendBytes:"xy" size:2]);
+    test_assert([array append:string]);
+    stringGrowth += [string capacity] != stringCap ? 1 : 0;
+    dataGrowth += [data capacity] != dataCap ? 1 : 0;
+    arrayGrowth += [array capacity] != arrayCap ? 1 : 0;
+  }
+  uint64_t ms = sys_date_get_timestamp() - start;
+  test_assert([string length] == APPENDS);
+  test_assert([data size] == 2 * APPENDS);
+  test_assert([array count] == APPENDS);
+  test_assert(check_bytes([string cStr], 'x', APPENDS));
+  test_assert(stringGrowth < 64 && dataGrowth < 64 && arrayGrowth < 64);
+  sys_printf("NXFoundation_32: appends=%u time=%ums growth=%zu/%zu/%zu\n",
+             (unsigned)APPENDS, (unsigned)ms, stringGrowth, dataGrowth,
+             arrayGrowth);
+  [appendZone dump];
+
+  // All the memory is returned to the zone
+  [array release];
+  [data release];
+  [string release];
+  [appendZone release];
+  return 0;
+}
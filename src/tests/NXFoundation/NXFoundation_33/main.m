@@ -0,0 +1,141 @@
+#include <Foundation/Foundation.h>
+#include <runtime-sys/sys.h>
+#include <string.h>
+#include <tests/tests.h>
+
+// Number of values in the benchmark
+#ifdef SYSTEM_NAME_PICO
+#define VALUES 10000
+#else
+#define VALUES 200000
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// FORWARD DECLARATIONS
+
+int test_small_values(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// MAIN
+
+int main(void) {
+  NXZone *zone = [NXZone zoneWithSize:64 * 1024];
+  test_assert(zone != nil);
+
+  // Run the test for small strings and numbers
+  int returnValue = TestMain("NXFoundation_33", test_small_values);
+
+  // Clean up
+  [zone release];
+
+  // Return the result of the test
+  return returnValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// HELPERS
+
+// Return YES if the data of a string is stored in the string object
+static BOOL is_inline(NXString *string) {
+  uintptr_t data = (uintptr_t)[string bytes];
+  uintptr_t start = (uintptr_t)string;
+  return data >= start && data < start + class_getInstanceSize([NXString class])
+             ? YES
+             : NO;
+}
+
+// Create numbers in a range, and return the time taken
+static uint64_t run_numbers(int32_t first) {
+  uint64_t start = sys_date_get_timestamp();
+  for (int i = 0; i < VALUES; i++) {
+    NXAutoreleasePool *pool = [[NXAutoreleasePool alloc] init];
+    NXNumber *number = [NXNumber numberWithInt32:first + (i % 200)];
+    test_assert([number int32Value] == first + (i % 200));
+    [pool release];
+  }
+  return sys_date_get_timestamp() - start;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TESTS
+
+int test_small_values(void) {
+  NXAutoreleasePool *pool = [[NXAutoreleasePool alloc] init];
+
+  // Small integers of every type share one instance for each value
+  NXNumber *small = [NXNumber numberWithInt32:42];
+  test_assert(small == [NXNumber numberWithInt16:42]);
+  test_assert(small == [NXNumber numberWithInt64:42]);
+  test_assert(small == [NXNumber numberWithUnsignedInt16:42]);
+  test_assert(small == [NXNumber numberWithUnsignedInt32:42]);
+  test_assert(small == [NXNumber numberWithUnsignedInt64:42]);
+  test_assert([small int32Value] == 42 && [small unsignedInt64Value] == 42);
+  test_assert([small isEqual:[NXNumber numberWithInt64:42]]);
+  test_cstrings_equal([[small description] cStr], "42");
+
+  // The range of the cache is from -16 to 255, and zero is a singleton
+  test_assert([NXNumber numberWithInt32:-16] ==
+              [NXNumber numberWithInt64:-16]);
+  test_assert([[NXNumber numberWithInt32:-16] int32Value] == -16);
+  test_assert([NXNumber numberWithInt32:255] ==
+              [NXNumber numberWithUnsignedInt32:255]);
+  test_assert([NXNumber numberWithInt32:0] == [NXNumber zeroValue]);
+
+  // Larger integers are separate instances
+  NXNumber *large = [NXNumber numberWithInt32:256];
+  test_assert(large != [NXNumber numberWithInt32:256]);
+  test_assert([large isEqual:[NXNumber numberWithInt32:256]]);
+  test_assert([NXNumber numberWithInt32:-17] !=
+              [NXNumber numberWithInt32:-17]);
+
+  // Shared numbers can be retained and released
+  [[small retain] release];
+  test_assert([[NXNumber numberWithInt32:42] int32Value] == 42);
+
+  // Compare the time to create small and large numbers
+  uint64_t small_ms = run_numbers(0);
+  uint64_t large_ms = run_numbers(100000);
+  sys_printf("NXFoundation_33: numbers=%u small=%ums large=%ums\n",
+             (unsigned)VALUES, (unsigned)small_ms, (unsigned)large_ms);
+
+  // Short strings are stored in the string object, which with its cached
+  // hash fits in 64 bytes on 64-bit targets
+#if UINTPTR_MAX > 0xFFFFFFFF
+  test_assert(class_getInstanceSize([NXString class]) <= 64);
+#endif
+  NXString *string = [NXString stringWithFormat:@"%d", 12345];
+  test_assert(is_inline(string));
+  test_assert([string capacity] == NXSTRING_INLINE_SIZE);
+  test_cstrings_equal([string cStr], "12345");
+  test_assert([string appendCString:"67890"]);
+  test_assert(is_inline(string));
+  test_cstrings_equal([string cStr], "1234567890");
+
+  // Strings which outgrow the object move their data to the zone
+  test_assert([string appendCString:"ABCDEF"]);
+  test_assert(is_inline(string) == NO);
+  test_assert([string capacity] > NXSTRING_INLINE_SIZE);
+  test_cstrings_equal([string cStr], "1234567890ABCDEF");
+
+  // A string of the largest inline size fits, and one byte more does not
+  NXString *full = [NXString stringWithFormat:@"%s", "12345678901"];
+  test_assert(is_inline(full));
+  test_assert(strlen([full cStr]) == NXSTRING_INLINE_SIZE - 1);
+  NXString *over = [NXString stringWithFormat:@"%s", "123456789012"];
+  test_assert(is_inline(over) == NO);
+  test_cstrings_equal([over cStr], "123456789012");
+
+  // Short strings with a capacity, and mutable copies of constant strings
+  NXString *capacity = [NXString stringWithCapacity:8];
+  test_assert(is_inline(capacity));
+  test_assert([capacity appendCString:"short"]);
+  test_cstrings_equal([capacity cStr], "short");
+  NXString *copy = [NXString stringWithString:@"const"];
+  test_assert([copy toUppercase]);
+  test_assert(is_inline(copy));
+  test_cstrings_equal([copy cStr], "CONST");
+
+  // Clean up
+  [pool release];
+  return 0;
+}
@@ -0,0 +1,195 @@
+#include <Foundation/Foundation.h>
+#include <runtime-sys/sys.h>
+#include <string.h>
+#include <tests/tests.h>
+
+// Number of payloads in the benchmark
+#ifdef SYSTEM_NAME_PICO
+#define PAYLOADS 1000
+#else
+#define PAYLOADS 20000
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// FORWARD DECLARATIONS
+
+int test_json_writer(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// MAIN
+
+int main(void) {
+  NXZone *zone = [NXZone zoneWithSize:64 * 1024];
+  test_assert(zone != nil);
+
+  // Run the test for the JSON writer
+  int returnValue = TestMain("NXFoundation_34", test_json_writer);
+
+  // Clean up
+  [zone release];
+
+  // Return the result of the test
+  return returnValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// HELPERS
+
+// Output collected by the sink
+static char sink_output[2048];
+static size_t sink_length;
+static size_t sink_calls;
+
+// Append the output of a writer to sink_output
+static BOOL sink(void *context, const char *bytes, size_t length) {
+  test_assert(context == &sink_calls);
+  if (sink_length + length >= sizeof(sink_output)) {
+    return NO;
+  }
+  sys_memcpy(sink_output + sink_length, bytes, length);
+  sink_length += length;
+  sink_output[sink_length] = '\0';
+  sink_calls++;
+  return YES;
+}
+
+// Reject all output
+static BOOL full_sink(void *context, const char *bytes, size_t length) {
+  (void)context;
+  (void)bytes;
+  (void)length;
+  return NO;
+}
+
+// Return a payload similar to a sensor reading
+static NXMap *payload(int32_t i) {
+  NXArray *readings = [NXArray
+      arrayWithObjects:[NXNumber numberWithInt32:i],
+                       [NXNumber numberWithInt32:-i * 3],
+                       [NXNumber numberWithUnsignedInt32:(uint32_t)i * 1000],
+                       [NXString stringWithCString:"temperature \"C\""],
+                       [NXNumber trueValue], [NXNull nullValue], nil];
+  return [NXMap mapWithObjectsAndKeys:readings, @"readings", nil];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TESTS
+
+int test_json_writer(void) {
+  NXAutoreleasePool *pool = [[NXAutoreleasePool alloc] init];
+
+  // Strings are quoted, and special characters are escaped
+  NXString *plain = [NXString stringWithCString:"Hello World"];
+  test_cstrings_equal([[plain JSONString] cStr], "\"Hello World\"");
+  NXString *empty = [NXString stringWithCString:""];
+  test_cstrings_equal([[empty JSONString] cStr], "\"\"");
+  NXString *special =
+      [NXString stringWithCString:"a\"b\\c\b\f\n\r\t\x01\x1F\x7F"];
+  test_cstrings_equal([[special JSONString] cStr],
+                      "\"a\\\"b\\\\c\\b\\f\\n\\r\\t\\u0001\\u001F\x7F\"");
+
+  // Bytes after the last escape, and UTF-8 sequences, are copied unchanged
+  NXString *utf8 =
+      [NXString stringWithCString:"caf\xC3\xA9\n\xE2\x82\xAC 5"];
+  test_cstrings_equal([[utf8 JSONString] cStr],
+                      "\"caf\xC3\xA9\\n\xE2\x82\xAC 5\"");
+
+  // A long string is returned without copying it into a new buffer
+  NXString *longString = [NXString stringWithCapacity:1001];
+  for (int i = 0; i < 100; i++) {
+    test_assert([longString appendCString:"0123456789"]);
+  }
+  NXString *longJSON = [longString JSONString];
+  test_assert([longJSON length] == 1002);
+  test_assert([longJSON capacity] > [longJSON length]);
+
+  // Numbers of each type, and the limits of 64-bit numbers
+  test_cstrings_equal([[[NXNumber numberWithInt16:-32768] JSONString] cStr],
+                      "-32768");
+  test_cstrings_equal([[[NXNumber numberWithInt64:INT64_MIN] JSONString] cStr],
+                      "-9223372036854775808");
+  test_cstrings_equal(
+      [[[NXNumber numberWithUnsignedInt64:UINT64_MAX] JSONString] cStr],
+      "18446744073709551615");
+  test_cstrings_equal([[[NXNumber zeroValue] JSONString] cStr], "0");
+  test_cstrings_equal([[[NXNumber falseValue] JSONString] cStr], "false");
+
+  // Nested arrays and maps are written with the same separators as before
+  NXMap *map = payload(7);
+  const char *expected = "{\"readings\": [7, -21, 7000, "
+                         "\"temperature \\\"C\\\"\", true, null]}";
+  test_cstrings_equal([[map JSONString] cStr], expected);
+  NXArray *nested =
+      [NXArray arrayWithObjects:[[NXArray new] autorelease],
+                                [[NXMap new] autorelease], map, nil];
+  test_cstrings_equal([[nested JSONString] cStr],
+                      "[[], {}, {\"readings\": [7, -21, 7000, "
+                      "\"temperature \\\"C\\\"\", true, null]}]");
+
+  // Objects without JSONProtocol are written as their quoted description
+  NXZone *other = [NXZone defaultZone];
+  NXArray *described = [NXArray arrayWithObjects:other, nil];
+  test_cstrings_equal([[described JSONString] cStr], "[\"NXZone\"]");
+
+  // A writer can write several values, and is empty once its string is
+  // returned
+  NXJSONWriter *writer = [NXJSONWriter writerWithCapacity:4];
+  test_assert(writer != nil);
+  test_assert([writer writeObject:nil]);
+  test_assert([writer writeBytes:", " length:2]);
+  test_assert([writer writeQuotedBytes:"A\0B" length:3]);
+  test_assert([writer writeCString:", "]);
+  test_assert([writer writeInt64:-1]);
+  test_assert([writer length] == 20);
+  test_cstrings_equal([[writer string] cStr], "null, \"A\\u0000B\", -1");
+  test_assert([writer length] == 0);
+  test_assert([writer writeObject:map]);
+  test_cstrings_equal([[writer string] cStr], expected);
+  test_cstrings_equal([[writer string] cStr], "");
+
+  // A writer with a sink passes the same output in chunks
+  NXJSONWriter *sinkWriter = [NXJSONWriter writerWithSink:sink
+                                                  context:&sink_calls];
+  test_assert(sinkWriter != nil);
+  for (int i = 0; i < 4; i++) {
+    test_assert([sinkWriter writeObject:map]);
+  }
+  test_assert([sinkWriter writeObject:longString]);
+  test_assert([sinkWriter flush]);
+  test_assert([sinkWriter string] == nil);
+  test_assert(sink_length == 4 * strlen(expected) + 1002);
+  test_assert([sinkWriter length] == sink_length);
+  test_assert(strncmp(sink_output, expected, strlen(expected)) == 0);
+  test_assert(sink_output[sink_length - 1] == '"');
+  test_assert(sink_calls > 1);
+  sys_printf("NXFoundation_34: sink bytes=%u calls=%u\n",
+             (unsigned)sink_length, (unsigned)sink_calls);
+
+  // A sink which fails stops the writer
+  NXJSONWriter *failWriter = [NXJSONWriter writerWithSink:full_sink
+                                                  context:NULL];
+  test_assert([failWriter writeObject:map]);
+  test_assert([failWriter writeObject:longString] == NO);
+  test_assert([failWriter writeObject:nil] == NO);
+  test_assert([failWriter flush] == NO);
+
+  // Report the time to write payloads
+  NXJSONWriter *bench = [NXJSONWriter writerWithCapacity:256];
+  size_t bytes = 0;
+  uint64_t start = sys_date_get_timestamp();
+  for (int32_t i = 0; i < PAYLOADS; i++) {
+    NXAutoreleasePool *inner = [[NXAutoreleasePool alloc] init];
+    test_assert([bench writeObject:payload(i)]);
+    NXString *json = [bench string];
+    test_assert(json != nil);
+    bytes += [json length];
+    [inner release];
+  }
+  uint64_t ms = sys_date_get_timestamp() - start;
+  sys_printf("NXFoundation_34: payloads=%u bytes=%u time=%ums\n",
+             (unsigned)PAYLOADS, (unsigned)bytes, (unsigned)ms);
+
+  // Clean up
+  [pool release];
+  return 0;
+}
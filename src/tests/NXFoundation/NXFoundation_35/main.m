@@ -0,0 +1,259 @@
+#include <Foundation/Foundation.h>
+#include <runtime-sys/sys.h>
+#include <string.h>
+#include <tests/tests.h>
+
+// Number of payloads in the benchmark corpus, and times it is parsed
+#ifdef SYSTEM_NAME_PICO
+#define PAYLOADS 100
+#define ROUNDS 5
+#else
+#define PAYLOADS 1000
+#define ROUNDS 50
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// FORWARD DECLARATIONS
+
+int test_json_parser(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// MAIN
+
+int main(void) {
+  NXZone *zone = [NXZone zoneWithSize:64 * 1024];
+  test_assert(zone != nil);
+
+  // Run the test for the JSON parser
+  int returnValue = TestMain("NXFoundation_35", test_json_parser);
+
+  // Clean up
+  [zone release];
+
+  // Return the result of the test
+  return returnValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// HELPERS
+
+// A delegate which counts events and collects the strings it receives
+@interface Counter : NXObject <JSONDelegate> {
+@public
+  unsigned int events[NXJSONEventArrayEnd + 1];
+  char strings[64];
+  size_t length;
+  BOOL stop;
+}
+@end
+
+@implementation Counter
+- (id)init {
+  self = [super init];
+  if (self) {
+    sys_memset(events, 0, sizeof(events));
+    strings[0] = '\0';
+    length = 0;
+    stop = NO;
+  }
+  return self;
+}
+
+- (BOOL)parser:(NXJSON *)parser
+      didParse:(NXJSONEvent)event
+         bytes:(const char *)bytes
+        length:(size_t)size {
+  test_assert(parser != nil);
+  events[event]++;
+  if (event == NXJSONEventString || event == NXJSONEventKey) {
+    test_assert(bytes[size] == '\0');
+    test_assert(length + size + 1 < sizeof(strings));
+    sys_memcpy(strings + length, bytes, size);
+    length += size;
+    strings[length++] = ',';
+    strings[length] = '\0';
+  }
+  return stop ? NO : YES;
+}
+@end
+
+// Append a payload similar to a sensor reading to the corpus
+static void payload(NXData *corpus, int32_t i) {
+  char buf[256];
+  size_t length = sys_sprintf(
+      buf, sizeof(buf),
+      "{\"device\": \"sensor-%d\", \"seq\": %d, \"ok\": %s, "
+      "\"readings\": [%d, -%d, %d, 21.%d, null], "
+      "\"unit\": \"temperature \\\"C\\\"\", \"tags\": {\"room\": \"lab\"}}\n",
+      (int)(i % 16), (int)i, (i & 1) ? "true" : "false", (int)(i * 7),
+      (int)(i % 100), (int)(i * 1000), (int)(i % 10));
+  test_assert(length < sizeof(buf));
+  test_assert([corpus appendBytes:buf size:length]);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TESTS
+
+int test_json_parser(void) {
+  NXAutoreleasePool *pool = [[NXAutoreleasePool alloc] init];
+
+  // Values of each type are parsed into objects
+  NXArray *array = [NXJSON
+      objectWithString:@"[\"caf\\u00e9\\n\", 0, -7, true, false, null, [], {}]"];
+  test_assert(array != nil);
+  test_assert([array isKindOfClass:[NXArray class]]);
+  test_assert([array count] == 8);
+  test_cstrings_equal([[array objectAtIndex:0] cStr], "caf\xC3\xA9\n");
+  test_assert([[array objectAtIndex:1] int64Value] == 0);
+  test_assert([[array objectAtIndex:2] int64Value] == -7);
+  test_assert([array objectAtIndex:3] == [NXNumber trueValue]);
+  test_assert([array objectAtIndex:4] == [NXNumber falseValue]);
+  test_assert([array objectAtIndex:5] == [NXNull nullValue]);
+  test_assert([[array objectAtIndex:6] isKindOfClass:[NXArray class]]);
+  test_assert([[array objectAtIndex:7] isKindOfClass:[NXMap class]]);
+  test_cstrings_equal([[array JSONString] cStr],
+                      "[\"caf\xC3\xA9\\n\", 0, -7, true, false, null, [], {}]");
+
+  // Nested maps can be looked up by key
+  NXMap *map = [NXJSON
+      objectWithString:@" {\"a\": {\"b\": [1, {\"c\": \"d\"}]}, \"e\": 2} "];
+  test_assert([map isKindOfClass:[NXMap class]]);
+  test_assert([map count] == 2);
+  test_assert([[map objectForKey:@"e"] int64Value] == 2);
+  NXArray *b = [[map objectForKey:@"a"] objectForKey:@"b"];
+  test_cstrings_equal([[b JSONString] cStr], "[1, {\"c\": \"d\"}]");
+
+  // The limits of 64-bit integers are numbers, and other numbers are strings
+  NXArray *numbers =
+      [NXJSON objectWithString:@"[18446744073709551615, -9223372036854775808, "
+                               @"18446744073709551616, 1.5, -2e10]"];
+  test_assert([numbers count] == 5);
+  test_assert([[numbers objectAtIndex:0] unsignedInt64Value] == UINT64_MAX);
+  test_assert([[numbers objectAtIndex:1] int64Value] == INT64_MIN);
+  test_cstrings_equal([[numbers objectAtIndex:2] cStr],
+                      "18446744073709551616");
+  test_cstrings_equal([[numbers objectAtIndex:3] cStr], "1.5");
+  test_cstrings_equal([[numbers objectAtIndex:4] cStr], "-2e10");
+
+  // Invalid JSON returns nil, and the parser reports where it failed
+  test_assert([NXJSON objectWithString:@""] == nil);
+  test_assert([NXJSON objectWithString:@"[1,]"] == nil);
+  test_assert([NXJSON objectWithString:@"{\"a\" 1}"] == nil);
+  test_assert([NXJSON objectWithString:@"[1] 2"] == nil);
+  test_assert([NXJSON objectWithString:@"01"] == nil);
+  NXJSON *parser = [[[NXJSON alloc] init] autorelease];
+  test_assert([parser parseBytes:"[tru" length:4]);
+  test_assert([parser error] == nil);
+  test_assert([parser parseBytes:"x]" length:2] == NO);
+  test_assert([parser object] == nil);
+  test_cstrings_equal([[parser error] cStr], "invalid literal at offset 5");
+
+  // Input in chunks of one byte is parsed to the same objects
+  const char *text = "{\"list\": [123, \"a\\\"b\", {\"x\": null}, -45]}";
+  [parser reset];
+  test_assert([parser error] == nil);
+  for (size_t i = 0; text[i] != '\0'; i++) {
+    test_assert([parser parseBytes:text + i length:1]);
+    test_assert([parser object] == nil);
+  }
+  test_assert([parser finish]);
+  test_cstrings_equal([[[parser object] JSONString] cStr],
+                      "{\"list\": [123, \"a\\\"b\", {\"x\": null}, -45]}");
+
+  // A delegate receives the events, and no objects are created
+  Counter *counter = [[Counter new] autorelease];
+  NXJSON *sax = [[[NXJSON alloc] initWithDelegate:counter] autorelease];
+  test_assert([sax parseBytes:text length:10]);
+  test_assert([sax parseBytes:text + 10 length:strlen(text) - 10]);
+  test_assert([sax finish]);
+  test_assert([sax object] == nil);
+  test_assert(counter->events[NXJSONEventObjectStart] == 2);
+  test_assert(counter->events[NXJSONEventObjectEnd] == 2);
+  test_assert(counter->events[NXJSONEventArrayStart] == 1);
+  test_assert(counter->events[NXJSONEventNumber] == 2);
+  test_assert(counter->events[NXJSONEventNull] == 1);
+  test_cstrings_equal(counter->strings, "list,a\"b,x,");
+
+  // A delegate can stop the parser
+  counter->stop = YES;
+  [sax reset];
+  test_assert([sax parseBytes:text length:strlen(text)] == NO);
+  test_cstrings_equal([[sax error] cStr], "stopped by callback at offset 0");
+
+  // Strings reference the data when it is parsed in place
+  NXData *data = [NXData dataWithString:@"{\"key\": [\"tab\\there\", \"plain\"]}"];
+  NXMap *inplace = [NXJSON objectWithData:data
+                                     zone:nil
+                                  options:NXJSONOptionNoCopy];
+  test_assert(inplace != nil);
+  NXArray *values = [inplace objectForKey:@"key"];
+  const char *start = [data bytes];
+  const char *end = start + [data size];
+  for (unsigned int i = 0; i < [values count]; i++) {
+    const char *cStr = [[values objectAtIndex:i] cStr];
+    test_assert(cStr >= start && cStr < end);
+  }
+  test_cstrings_equal([[values objectAtIndex:0] cStr], "tab\there");
+  test_cstrings_equal([[values objectAtIndex:1] cStr], "plain");
+
+  // Objects are allocated from a zone, and freed when released
+  NXZone *zone = [NXZone zoneWithSize:16 * 1024];
+  test_assert(zone != nil);
+  size_t used = [zone bytesUsed];
+  NXData *copied = [NXData dataWithString:@"{\"a\": [\"a string longer than "
+                                          @"the inline buffer\", {}]}"];
+  NXMap *zoned = [[NXJSON objectWithData:copied
+                                    zone:zone
+                                 options:NXJSONOptionNone] retain];
+  test_assert(zoned != nil);
+  size_t peak = [zone bytesUsed];
+  test_assert(peak > used);
+  [zoned release];
+  test_assert([zone bytesUsed] < peak);
+  [zone release];
+
+  // Report the throughput of parsing a corpus of sensor payloads, copying
+  // strings and in place
+  NXData *corpus = [NXData dataWithCapacity:PAYLOADS * 200];
+  test_assert(corpus != nil);
+  test_assert([corpus appendBytes:"[" size:1]);
+  for (int32_t i = 0; i < PAYLOADS; i++) {
+    if (i > 0) {
+      test_assert([corpus appendBytes:"," size:1]);
+    }
+    payload(corpus, i);
+  }
+  test_assert([corpus appendBytes:"]" size:1]);
+  for (int nocopy = 0; nocopy < 2; nocopy++) {
+    size_t bytes = 0;
+    uint64_t start = sys_date_get_timestamp();
+    for (int round = 0; round < ROUNDS; round++) {
+      NXAutoreleasePool *inner = [[NXAutoreleasePool alloc] init];
+      NXData *input = corpus;
+      if (nocopy) {
+        // Parsing in place modifies the data, so parse a copy
+        input = [NXData dataWithBytes:[corpus bytes] size:[corpus size]];
+      }
+      NXArray *result =
+          [NXJSON objectWithData:input
+                            zone:nil
+                         options:nocopy ? NXJSONOptionNoCopy
+                                        : NXJSONOptionNone];
+      test_assert([result count] == PAYLOADS);
+      bytes += [corpus size];
+      [inner release];
+    }
+    uint64_t ms = sys_date_get_timestamp() - start;
+    if (ms == 0) {
+      ms = 1;
+    }
+    sys_printf("NXFoundation_35: %s bytes=%u time=%ums rate=%uKB/s "
+               "(%uMB/s)\n",
+               nocopy ? "nocopy" : "copy", (unsigned)bytes, (unsigned)ms,
+               (unsigned)(bytes / ms), (unsigned)(bytes / ms / 1000));
+  }
+
+  // Clean up
+  [pool release];
+  return 0;
+}
@@ -0,0 +1,104 @@
+#include <Foundation/Foundation.h>
+#include <runtime-sys/sys.h>
+#include <tests/tests.h>
+
+// Number of keys and lookups in the benchmark
+#ifdef SYSTEM_NAME_PICO
+#define KEYS 100
+#define LOOKUPS 10000
+#else
+#define KEYS 1000
+#define LOOKUPS 1000000
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// FORWARD DECLARATIONS
+
+int test_string_hash(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// MAIN
+
+int main(void) {
+  NXZone *zone = [NXZone zoneWithSize:64 * 1024];
+  test_assert(zone != nil);
+
+  // Run the test for string hashes
+  int returnValue = TestMain("NXFoundation_36", test_string_hash);
+
+  // Clean up
+  [zone release];
+
+  // Return the result of the test
+  return returnValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TESTS
+
+int test_string_hash(void) {
+  NXAutoreleasePool *pool = [[NXAutoreleasePool alloc] init];
+
+  // Equal strings have the same hash, whatever their class
+  NXString *string = [NXString stringWithCString:"temperature"];
+  NXString *copy = [NXString stringWithFormat:@"%s", "temperature"];
+  test_assert([string hash] == (uint32_t)sys_hash_djb2("temperature"));
+  test_assert([string hash] == [copy hash]);
+  test_assert([string hash] == [@"temperature" hash]);
+  NXString *empty = [[NXString new] autorelease];
+  test_assert([empty hash] == [@"" hash]);
+
+  // The hash is cached, and changes when the string changes
+  uintptr_t hash = [copy hash];
+  test_assert([copy hash] == hash);
+  test_assert([copy appendCString:"2"]);
+  test_assert([copy hash] != hash);
+  test_assert([copy hash] == (uint32_t)sys_hash_djb2("temperature2"));
+  test_assert([copy toUppercase]);
+  test_assert([copy hash] == (uint32_t)sys_hash_djb2("TEMPERATURE2"));
+  test_assert([copy trimPrefix:@"TEMP" suffix:@"2"]);
+  test_assert([copy hash] == (uint32_t)sys_hash_djb2("ERATURE"));
+
+  // Equality uses the length and the cached hashes before the content
+  NXString *other = [NXString stringWithCString:"humidity"];
+  NXString *same = [NXString stringWithFormat:@"%s", "humidity"];
+  test_assert([other isEqual:same]);
+  test_assert([same isEqual:other]);
+  test_assert([other isEqual:@"humidity"]);
+  test_assert([other isEqual:string] == NO);
+  test_assert([other isEqual:@"humidit"] == NO);
+  test_assert([other isEqual:[NXNumber zeroValue]] == NO);
+  test_assert([same appendCString:"!"]);
+  test_assert([other isEqual:same] == NO);
+
+  // Maps find keys of either class
+  NXMap *map = [NXMap mapWithCapacity:4];
+  test_assert([map setObject:string forKey:string]);
+  test_assert([map setObject:other forKey:@"humidity"]);
+  test_assert([map objectForKey:@"temperature"] == string);
+  test_assert([map objectForKey:other] == other);
+  test_assert([map removeObjectForKey:[NXString stringWithCString:"humidity"]]);
+  test_assert([map objectForKey:@"humidity"] == nil);
+  test_assert([map count] == 1);
+
+  // Report the time to look up keys in a map
+  NXMap *bench = [NXMap mapWithCapacity:KEYS];
+  NXArray *keys = [NXArray arrayWithCapacity:KEYS];
+  for (int i = 0; i < KEYS; i++) {
+    NXString *key = [NXString stringWithFormat:@"sensor/%d/temperature", i];
+    test_assert([bench setObject:key forKey:key]);
+    test_assert([keys append:key]);
+  }
+  uint64_t start = sys_date_get_timestamp();
+  for (int i = 0; i < LOOKUPS; i++) {
+    NXString *key = [keys objectAtIndex:i % KEYS];
+    test_assert([bench objectForKey:key] == key);
+  }
+  uint64_t ms = sys_date_get_timestamp() - start;
+  sys_printf("NXFoundation_36: keys=%u lookups=%u time=%ums\n",
+             (unsigned)KEYS, (unsigned)LOOKUPS, (unsigned)ms);
+
+  // Clean up
+  [pool release];
+  return 0;
+}
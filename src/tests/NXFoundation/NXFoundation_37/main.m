@@ -0,0 +1,124 @@
+#include <Foundation/Foundation.h>
+#include <runtime-sys/sys.h>
+#include <tests/tests.h>
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE CATEGORIES
+
+// The accessor for the allocation statistics, which is private to Foundation
+@interface NXZone (Private)
+- (BOOL)profileClass:(Class)cls count:(size_t *)count bytes:(size_t *)bytes;
+@end
+
+///////////////////////////////////////////////////////////////////////////////
+// TEST CLASSES
+
+@interface Small : NXObject {
+  int _value;
+}
+@end
+
+@implementation Small
+@end
+
+@interface Large : NXObject {
+  char _data[200];
+}
+@end
+
+@implementation Large
+@end
+
+///////////////////////////////////////////////////////////////////////////////
+// FORWARD DECLARATIONS
+
+int test_zone_profile(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// MAIN
+
+int main(void) {
+  NXZone *zone = [NXZone zoneWithSize:64 * 1024];
+  test_assert(zone != nil);
+
+  // Run the test for the allocation statistics
+  int returnValue = TestMain("NXFoundation_37", test_zone_profile);
+
+  // Clean up
+  [zone release];
+
+  // Return the result of the test
+  return returnValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// HELPERS
+
+// Return YES if the live allocations for a class are as expected
+static BOOL check_class(NXZone *zone, Class cls, size_t count, size_t bytes) {
+  size_t liveCount = 0, liveBytes = 0;
+  if ([zone profileClass:cls count:&liveCount bytes:&liveBytes] == NO) {
+    return NO;
+  }
+  return liveCount == count && liveBytes == bytes ? YES : NO;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TESTS
+
+int test_zone_profile(void) {
+  NXZone *zone = [NXZone defaultZone];
+  size_t smallSize = class_getInstanceSize([Small class]);
+  size_t largeSize = class_getInstanceSize([Large class]);
+
+  // Classes which have not been allocated have no live allocations
+  test_assert(check_class(zone, [Small class], 0, 0));
+  test_assert(check_class(zone, [Large class], 0, 0));
+  size_t rawCount = 0, rawBytes = 0;
+  test_assert([zone profileClass:Nil count:&rawCount bytes:&rawBytes]);
+
+  // Objects are counted by class
+  Small *small[3];
+  Large *large[2];
+  for (int i = 0; i < 3; i++) {
+    small[i] = [[Small allocWithZone:zone] init];
+    test_assert(small[i] != nil);
+  }
+  for (int i = 0; i < 2; i++) {
+    large[i] = [[Large allocWithZone:zone] init];
+    test_assert(large[i] != nil);
+  }
+  test_assert(check_class(zone, [Small class], 3, 3 * smallSize));
+  test_assert(check_class(zone, [Large class], 2, 2 * largeSize));
+  test_assert(check_class(zone, Nil, rawCount, rawBytes));
+
+  // Memory which is not an object is counted with its requested size, which
+  // changes when it is reallocated
+  void *block = [zone allocWithSize:24];
+  test_assert(block != NULL);
+  test_assert(check_class(zone, Nil, rawCount + 1, rawBytes + 24));
+  block = [zone reallocWithPtr:block size:1000];
+  test_assert(block != NULL);
+  test_assert(check_class(zone, Nil, rawCount + 1, rawBytes + 1000));
+  block = [zone reallocWithPtr:block size:100];
+  test_assert(block != NULL);
+  test_assert(check_class(zone, Nil, rawCount + 1, rawBytes + 100));
+
+  // Freed objects and memory are no longer counted
+  [small[0] release];
+  [large[1] release];
+  test_assert(check_class(zone, [Small class], 2, 2 * smallSize));
+  test_assert(check_class(zone, [Large class], 1, largeSize));
+  [zone free:block];
+  test_assert(check_class(zone, Nil, rawCount, rawBytes));
+
+  // The report lists the classes with live objects
+  [zone dumpProfile:0];
+
+  [small[1] release];
+  [small[2] release];
+  [large[0] release];
+  test_assert(check_class(zone, [Small class], 0, 0));
+  test_assert(check_class(zone, [Large class], 0, 0));
+  return 0;
+}
@@ -0,0 +1,40 @@
+#include <objc/objc.h>
+#include <runtime-sys/sys.h>
+#include <tests/tests.h>
+
+int test_runtime_38(void);
+
+int main(void) { return TestMain("test_runtime_38", test_runtime_38); }
+
+int test_runtime_38(void) {
+  // Selectors with the same name are equal
+  SEL selector = @selector(alloc);
+  SEL registered = sel_registerName("alloc");
+  test_assert(registered != NULL);
+  test_assert(sel_isEqual(selector, registered));
+  test_assert(sel_getName(selector) == sel_getName(registered));
+  test_assert(sel_isEqual(sel_getUid("alloc"), selector));
+
+  // Unregistered selectors are registered by sel_getUid, the same as
+  // sel_registerName
+  SEL uid = sel_getUid("runtime38NotRegistered");
+  test_assert(uid != NULL);
+  test_cstrings_equal(sel_getName(uid), "runtime38NotRegistered");
+  test_assert(sel_registerName("runtime38NotRegistered") == uid);
+
+  // Registering a name copies it, and registering it again returns the
+  // same selector
+  char name[] = "runtime38Registered";
+  SEL copied = sel_registerName(name);
+  test_assert(copied != NULL);
+  name[0] = 'X';
+  test_cstrings_equal(sel_getName(copied), "runtime38Registered");
+  test_assert(sel_registerName("runtime38Registered") == copied);
+  test_assert(sel_getUid("runtime38Registered") == copied);
+  test_assert(sel_isEqual(copied, selector) == NO);
+
+  // Registered selectors can be used for method lookup
+  test_assert(class_metaclassRespondsToSelector([Object class], registered));
+  test_assert(class_respondsToSelector([Object class], copied) == NO);
+  return 0;
+}
@@ -0,0 +1,104 @@
+#include <objc/objc.h>
+#include <runtime-sys/sys.h>
+#include <tests/tests.h>
+
+static int initialized = 0;
+
+@interface Counter : Object {
+  int _count;
+}
++ (int)answer;
+- (int)count;
+- (void)increment;
+- (int)value;
+@end
+
+@implementation Counter
++ (void)initialize {
+  initialized++;
+}
++ (int)answer {
+  return 42;
+}
+- (int)count {
+  return _count;
+}
+- (void)increment {
+  _count++;
+}
+- (int)value {
+  return 1;
+}
+@end
+
+@interface Counter (Replaced)
+- (int)value;
+@end
+
+@implementation Counter (Replaced)
+- (int)value {
+  return 2;
+}
+@end
+
+@interface SubCounter : Counter
+@end
+
+@implementation SubCounter
+@end
+
+int test_runtime_39(void);
+
+int main(void) { return TestMain("test_runtime_39", test_runtime_39); }
+
+int test_runtime_39(void) {
+  // Fetching an IMP sends +initialize to the class, before any message
+  // is sent to it. The class is looked up by name, since [Counter class]
+  // would itself be a message.
+  test_assert(initialized == 0);
+  Class cls = objc_lookupClass("Counter");
+  test_assert(cls != Nil);
+  test_assert(initialized == 0);
+  IMP imp = class_getMethodImplementation(cls, @selector(increment));
+  test_assert(imp != NULL);
+  test_assert(initialized == 1);
+
+  // Calling the IMP directly is the same as sending the message
+  Counter *counter = [[Counter alloc] init];
+  test_assert(counter != nil);
+  for (int i = 0; i < 1000; i++) {
+    ((void (*)(id, SEL))imp)(counter, @selector(increment));
+  }
+  test_assert([counter count] == 1000);
+
+  // Category methods replace the class methods
+  IMP value = [counter methodForSelector:@selector(value)];
+  test_assert(value != NULL);
+  test_assert(((int (*)(id, SEL))value)(counter, @selector(value)) == 2);
+  test_assert(value == [Counter instanceMethodForSelector:@selector(value)]);
+
+  // Inherited methods return the superclass implementation
+  test_assert([SubCounter instanceMethodForSelector:@selector(increment)] ==
+              imp);
+  test_assert(class_getMethodImplementation([SubCounter class],
+                                            @selector(value)) == value);
+
+  // Class methods
+  IMP answer = [Counter methodForSelector:@selector(answer)];
+  test_assert(answer != NULL);
+  test_assert(((int (*)(id, SEL))answer)([Counter class],
+                                         @selector(answer)) == 42);
+  test_assert(class_getClassMethodImplementation([SubCounter class],
+                                                 @selector(answer)) == answer);
+  test_assert([Counter instanceMethodForSelector:@selector(answer)] == NULL);
+
+  // Unknown selectors and Nil classes return NULL
+  test_assert(class_getMethodImplementation(
+                  [Counter class], sel_registerName("runtime39Unknown")) ==
+              NULL);
+  test_assert(class_getMethodImplementation(Nil, @selector(increment)) ==
+              NULL);
+
+  [counter dealloc];
+  return 0;
+}
@@ -0,0 +1,125 @@
+#include <objc/objc.h>
+#include <runtime-sys/sys.h>
+#include <tests/tests.h>
+
+int test_runtime_40(void);
+
+int main(void) { return TestMain("test_runtime_40", test_runtime_40); }
+
+/* Test protocol conformance is consistent across compilation units, and when
+ * it is checked repeatedly. */
+
+@protocol Named
+- (const char *)shapeName;
+@end
+
+@protocol Drawable <Named>
+- (void)draw;
+@end
+
+@protocol Unused
+- (void)unused;
+@end
+
+// Base is adopted by a class, but Derived is not, so the list of Derived is
+// not uniqued. Neither Loose nor Looser is adopted by any class.
+@protocol Base
+- (void)base;
+@end
+
+@protocol Derived <Base>
+- (void)derived;
+@end
+
+@protocol Loose
+- (void)loose;
+@end
+
+@protocol Looser <Loose>
+- (void)looser;
+@end
+
+@interface Shape : Object <Drawable>
+@end
+
+@implementation Shape
+- (const char *)shapeName {
+  return "shape";
+}
+- (void)draw {
+}
+@end
+
+@interface Square : Shape
+@end
+
+@implementation Square
+@end
+
+@interface Based : Object <Base>
+@end
+
+@implementation Based
+- (void)base {
+}
+@end
+
+Protocol *runtime_40_drawable(void);
+Protocol *runtime_40_named(void);
+Protocol *runtime_40_derived(void);
+Protocol *runtime_40_looser(void);
+
+int test_runtime_40(void) {
+  Protocol *drawable = runtime_40_drawable();
+  Protocol *named = runtime_40_named();
+  test_assert(drawable != NULL);
+  test_assert(named != NULL);
+  test_cstrings_equal(proto_getName((objc_protocol_t *)drawable), "Drawable");
+
+  // Repeated checks return the same result, whichever copy of the protocol
+  // is used
+  for (int i = 0; i < 100; i++) {
+    test_assert([Shape conformsTo:@protocol(Drawable)]);
+    test_assert([Shape conformsTo:drawable]);
+    test_assert([Square conformsTo:@protocol(Named)]);
+    test_assert([Square conformsTo:named]);
+    test_assert([Square conformsTo:@protocol(Unused)] == NO);
+    test_assert([Object conformsTo:drawable] == NO);
+  }
+
+  // Protocol incorporation is also checked across copies
+  test_assert(proto_conformsTo((objc_protocol_t *)drawable,
+                               (objc_protocol_t *)@protocol(Named)));
+  test_assert(proto_conformsTo((objc_protocol_t *)@protocol(Drawable),
+                               (objc_protocol_t *)named));
+  test_assert(proto_conformsTo((objc_protocol_t *)named,
+                               (objc_protocol_t *)@protocol(Drawable)) == NO);
+
+  // Protocols incorporated by a protocol which no class adopts are checked
+  // across copies, whether or not the incorporated protocol is registered
+  Protocol *derived = runtime_40_derived();
+  Protocol *looser = runtime_40_looser();
+  test_assert(derived != NULL);
+  test_assert(looser != NULL);
+  for (int i = 0; i < 2; i++) {
+    test_assert(proto_conformsTo((objc_protocol_t *)derived,
+                                 (objc_protocol_t *)@protocol(Base)));
+    test_assert(proto_conformsTo((objc_protocol_t *)looser,
+                                 (objc_protocol_t *)@protocol(Loose)));
+    test_assert(proto_conformsTo((objc_protocol_t *)@protocol(Looser),
+                                 (objc_protocol_t *)@protocol(Loose)));
+    test_assert(proto_conformsTo((objc_protocol_t *)derived,
+                                 (objc_protocol_t *)@protocol(Loose)) == NO);
+    test_assert([Based conformsTo:@protocol(Base)]);
+    test_assert([Based conformsTo:derived] == NO);
+    test_assert([Based conformsTo:@protocol(Loose)] == NO);
+  }
+
+  // Instances conform to the protocols of their class
+  Square *square = [[Square alloc] init];
+  test_assert(square != nil);
+  test_assert([square conformsTo:drawable]);
+  test_assert([square conformsTo:@protocol(Unused)] == NO);
+  [square dealloc];
+  return 0;
+}
@@ -0,0 +1,35 @@
+#include <objc/objc.h>
+
+/* The same protocols, referred to from another compilation unit */
+
+@protocol Named
+- (const char *)shapeName;
+@end
+
+@protocol Drawable <Named>
+- (void)draw;
+@end
+
+@protocol Base
+- (void)base;
+@end
+
+@protocol Derived <Base>
+- (void)derived;
+@end
+
+@protocol Loose
+- (void)loose;
+@end
+
+@protocol Looser <Loose>
+- (void)looser;
+@end
+
+Protocol *runtime_40_drawable(void) { return @protocol(Drawable); }
+
+Protocol *runtime_40_named(void) { return @protocol(Named); }
+
+Protocol *runtime_40_derived(void) { return @protocol(Derived); }
+
+Protocol *runtime_40_looser(void) { return @protocol(Looser); }
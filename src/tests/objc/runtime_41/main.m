@@ -0,0 +1,80 @@
+#include <objc/objc.h>
+#include <runtime-sys/sys.h>
+#include <tests/tests.h>
+
+@interface Base : Object
+- (int)inherited;
+@end
+
+@implementation Base
+- (int)inherited {
+  return 1;
+}
+@end
+
+@interface Probe : Base
+- (int)ping;
+@end
+
+@implementation Probe
+- (int)ping {
+  return 2;
+}
+@end
+
+int test_runtime_41(void);
+
+int main(void) { return TestMain("test_runtime_41", test_runtime_41); }
+
+int test_runtime_41(void) {
+  uint32_t sends = 0, lookups = 0, hops = 0;
+
+  // The instance is created before the counters are reset, so that only the
+  // messages below are counted
+  Probe *probe = [[Probe alloc] init];
+  test_assert(probe != nil);
+  objc_profile_reset();
+  test_assert(objc_profile_counters([Probe class], @selector(ping), &sends,
+                                    &lookups, &hops));
+  test_assert(sends == 0 && lookups == 0 && hops == 0);
+
+  // Each message is counted, and only the first misses the dispatch table
+  int sum = 0;
+  for (int i = 0; i < 100; i++) {
+    sum += [probe ping];
+  }
+  test_assert(sum == 200);
+  test_assert(objc_profile_counters([Probe class], @selector(ping), &sends,
+                                    &lookups, &hops));
+  test_assert(sends == 100);
+  test_assert(lookups == 1);
+  test_assert(hops == 0);
+
+  // A lookup of an inherited method walks to the superclass once
+  for (int i = 0; i < 10; i++) {
+    sum += [probe inherited];
+  }
+  test_assert(sum == 210);
+  test_assert(objc_profile_counters([Probe class], @selector(inherited),
+                                    &sends, &lookups, &hops));
+  test_assert(sends == 10);
+  test_assert(lookups == 1);
+  test_assert(hops == 1);
+
+  // Messages which were not sent have no counters
+  test_assert(objc_profile_counters([Base class], @selector(ping), &sends,
+                                    &lookups, &hops));
+  test_assert(sends == 0 && lookups == 0);
+
+  // The dump lists the messages in order of sends
+  objc_profile_dump(4);
+
+  // Resetting clears the counters
+  objc_profile_reset();
+  test_assert(objc_profile_counters([Probe class], @selector(ping), &sends,
+                                    &lookups, &hops));
+  test_assert(sends == 0 && lookups == 0 && hops == 0);
+
+  [probe dealloc];
+  return 0;
+}
@@ -0,0 +1,112 @@
+#include <objc/objc.h>
+#include <runtime-sys/sys.h>
+#include <tests/tests.h>
+
+/* Test that more classes and categories can be registered than the initial
+ * size of the runtime tables. */
+
+// Number of classes and categories defined below
+#define CLASSES 48
+
+@interface Object (Numbered)
+- (int)number;
+- (int)doubled;
++ (int)classNumber;
+@end
+
+// Define a class which returns its number, and a category which adds a
+// method to it
+#define NUMBERED_CLASS(n)                                                      \
+  @interface Numbered##n : Object                                             \
+  @end                                                                         \
+  @implementation Numbered##n                                                  \
+  -(int)number {                                                               \
+    return n;                                                                  \
+  }                                                                            \
+  +(int)classNumber {                                                          \
+    return n;                                                                  \
+  }                                                                            \
+  @end                                                                         \
+  @interface Numbered##n(Doubled)                                              \
+  @end                                                                         \
+  @implementation Numbered##n(Doubled)                                         \
+  -(int)doubled {                                                              \
+    return n * 2;                                                              \
+  }                                                                            \
+  @end
+
+NUMBERED_CLASS(0)
+NUMBERED_CLASS(1)
+NUMBERED_CLASS(2)
+NUMBERED_CLASS(3)
+NUMBERED_CLASS(4)
+NUMBERED_CLASS(5)
+NUMBERED_CLASS(6)
+NUMBERED_CLASS(7)
+NUMBERED_CLASS(8)
+NUMBERED_CLASS(9)
+NUMBERED_CLASS(10)
+NUMBERED_CLASS(11)
+NUMBERED_CLASS(12)
+NUMBERED_CLASS(13)
+NUMBERED_CLASS(14)
+NUMBERED_CLASS(15)
+NUMBERED_CLASS(16)
+NUMBERED_CLASS(17)
+NUMBERED_CLASS(18)
+NUMBERED_CLASS(19)
+NUMBERED_CLASS(20)
+NUMBERED_CLASS(21)
+NUMBERED_CLASS(22)
+NUMBERED_CLASS(23)
+NUMBERED_CLASS(24)
+NUMBERED_CLASS(25)
+NUMBERED_CLASS(26)
+NUMBERED_CLASS(27)
+NUMBERED_CLASS(28)
+NUMBERED_CLASS(29)
+NUMBERED_CLASS(30)
+NUMBERED_CLASS(31)
+NUMBERED_CLASS(32)
+NUMBERED_CLASS(33)
+NUMBERED_CLASS(34)
+NUMBERED_CLASS(35)
+NUMBERED_CLASS(36)
+NUMBERED_CLASS(37)
+NUMBERED_CLASS(38)
+NUMBERED_CLASS(39)
+NUMBERED_CLASS(40)
+NUMBERED_CLASS(41)
+NUMBERED_CLASS(42)
+NUMBERED_CLASS(43)
+NUMBERED_CLASS(44)
+NUMBERED_CLASS(45)
+NUMBERED_CLASS(46)
+NUMBERED_CLASS(47)
+
+int test_runtime_42(void);
+
+int main(void) { return TestMain("test_runtime_42", test_runtime_42); }
+
+int test_runtime_42(void) {
+  // Every class is found by name, and its own and category methods are
+  // dispatched
+  for (int n = 0; n < CLASSES; n++) {
+    char name[32];
+    sys_sprintf(name, sizeof(name), "Numbered%d", n);
+    Class cls = objc_lookupClass(name);
+    test_assert(cls != Nil);
+    test_cstrings_equal(class_getName(cls), name);
+    test_assert([cls classNumber] == n);
+
+    id object = [[cls alloc] init];
+    test_assert(object != nil);
+    test_assert([object number] == n);
+    test_assert([object doubled] == n * 2);
+    [object dealloc];
+  }
+
+  // Classes which were not defined are not found
+  test_assert(objc_lookupClass("Numbered48") == Nil);
+  return 0;
+}
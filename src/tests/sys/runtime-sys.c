@@ -24,6 +24,10 @@ int main(void) {
   return_code |= test_sys_15();
   return_code |= test_sys_16();
   return_code |= test_sys_17();
+  return_code |= test_sys_18();
+  return_code |= test_sys_19();
+  return_code |= test_sys_20();
+  return_code |= test_sys_21();
 
   // End tests
   if (return_code == 0) {
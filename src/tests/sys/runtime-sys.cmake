@@ -18,6 +18,10 @@ add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/sys_14)
 add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/sys_15)
 add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/sys_16)
 add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/sys_17)
+add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/sys_18)
+add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/sys_19)
+add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/sys_20)
+add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/sys_21)
 
 # On the Pico, we combine the tests into a single executable which 
 # so all tests can be run together.
@@ -43,7 +47,11 @@ if(CMAKE_SYSTEM_NAME STREQUAL "PICO")
         sys_14
         sys_15
         sys_16
-    sys_17
+        sys_17
+        sys_18
+        sys_19
+        sys_20
+        sys_21
     )
     pico_add_extra_outputs(tests-runtime-sys)
     pico_enable_stdio_usb(tests-runtime-sys 1)
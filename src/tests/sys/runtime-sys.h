@@ -18,3 +18,7 @@ int test_sys_14(void);
 int test_sys_15(void);
 int test_sys_16(void);
 int test_sys_17(void);
+int test_sys_18(void);
+int test_sys_19(void);
+int test_sys_20(void);
+int test_sys_21(void);
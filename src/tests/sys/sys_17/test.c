@@ -54,6 +54,20 @@ int test_sys_17(void) {
   if (sys_atomic_dec(&a) != 41)
     return 4;
 
+  // Acquire and release orderings, and compare-and-swap
+  sys_atomic_set_release(&a, 7);
+  if (sys_atomic_get_acquire(&a) != 7)
+    return 10;
+  uint32_t expected = 6;
+  if (sys_atomic_cas(&a, &expected, 8) || expected != 7)
+    return 11;
+  while (!sys_atomic_cas(&a, &expected, 8)) {
+    if (expected != 7)
+      return 12;
+  }
+  if (sys_atomic_get(&a) != 8)
+    return 13;
+
   // Concurrent increment/decrement
   sys_atomic_set(&a, 0);
   const uint32_t iterations = 100000;
@@ -0,0 +1,4 @@
+#include "../runtime-sys.h"
+#include <tests/tests.h>
+
+int main(void) { return TestMain("test_sys_18", test_sys_18); }
@@ -0,0 +1,150 @@
+#include <objc/objc.h>
+#include <runtime-sys/sys.h>
+#include <tests/tests.h>
+
+// Maximum number of threads in the benchmark
+#ifdef SYSTEM_NAME_PICO
+#define MAX_THREADS 2
+#define ITERATIONS 20000
+#else
+#define MAX_THREADS 8
+#define ITERATIONS 200000
+#endif
+
+// An object to lock, padded so that objects do not share a cache line
+typedef struct {
+  void *isa;
+  uint8_t pad[56];
+} sync_object_t __attribute__((aligned(64)));
+
+typedef struct {
+  sys_waitgroup_t *wg;
+  id obj;          // Object to synchronize on
+  uint32_t *count; // Counter protected by the object lock
+  uint32_t iterations;
+  int errors;
+} worker_args_t;
+
+static sync_object_t shared_object;
+static sync_object_t thread_objects[MAX_THREADS];
+
+static void worker_fn(void *arg) {
+  worker_args_t *w = (worker_args_t *)arg;
+  for (uint32_t i = 0; i < w->iterations; i++) {
+    if (objc_sync_enter(w->obj) != 0) {
+      w->errors++;
+      continue;
+    }
+    (*w->count)++;
+    if (objc_sync_exit(w->obj) != 0) {
+      w->errors++;
+    }
+  }
+  if (w->wg != NULL) {
+    sys_waitgroup_done(w->wg);
+  }
+}
+
+// Start a worker on another thread, or return false
+static bool start_worker(worker_args_t *args) {
+#ifdef SYSTEM_NAME_PICO
+  return sys_thread_create_on_core(worker_fn, args, 1);
+#else
+  return sys_thread_create(worker_fn, args);
+#endif
+}
+
+// Run the workers, with one on the calling thread, and return the elapsed
+// time in milliseconds, or -1 on error
+static int64_t run_workers(worker_args_t *args, int nthreads) {
+  sys_waitgroup_t wg = sys_waitgroup_init();
+  uint64_t start = sys_date_get_timestamp();
+  for (int i = 1; i < nthreads; i++) {
+    args[i].wg = &wg;
+    sys_waitgroup_add(&wg, 1);
+    if (!start_worker(&args[i])) {
+      sys_printf("sys_18: failed to create thread %d\n", i);
+      sys_waitgroup_done(&wg);
+      sys_waitgroup_finalize(&wg);
+      return -1;
+    }
+  }
+  args[0].wg = NULL;
+  worker_fn(&args[0]);
+  sys_waitgroup_finalize(&wg);
+  return (int64_t)(sys_date_get_timestamp() - start);
+}
+
+// Benchmark the throughput of objc_sync_enter/exit with the given number of
+// threads. When shared is true, all threads lock the same object, otherwise
+// each thread locks its own object.
+static int benchmark(int nthreads, bool shared) {
+  worker_args_t args[MAX_THREADS];
+  uint32_t counts[MAX_THREADS];
+  uint32_t shared_count = 0;
+  for (int i = 0; i < nthreads; i++) {
+    counts[i] = 0;
+    args[i].obj = shared ? (id)&shared_object : (id)&thread_objects[i];
+    args[i].count = shared ? &shared_count : &counts[i];
+    args[i].iterations = ITERATIONS;
+    args[i].errors = 0;
+  }
+
+  int64_t ms = run_workers(args, nthreads);
+  if (ms < 0) {
+    return 1;
+  }
+
+  // Check the counters, which are only correct if the lock excludes other
+  // threads
+  uint32_t total = shared_count;
+  for (int i = 0; i < nthreads; i++) {
+    total += counts[i];
+    if (args[i].errors != 0) {
+      sys_printf("sys_18: thread %d had %d errors\n", i, args[i].errors);
+      return 1;
+    }
+  }
+  if (total != (uint32_t)nthreads * ITERATIONS) {
+    sys_printf("sys_18: expected count %u, got %u\n",
+               (unsigned)nthreads * ITERATIONS, (unsigned)total);
+    return 1;
+  }
+
+  uint64_t ops = (uint64_t)nthreads * ITERATIONS;
+  sys_printf("sys_18: %s threads=%d ops=%u time=%ums ops/ms=%u\n",
+             shared ? "shared " : "private", nthreads, (unsigned)ops,
+             (unsigned)ms, (unsigned)(ms > 0 ? ops / (uint64_t)ms : ops));
+  return 0;
+}
+
+int test_sys_18(void) {
+  sync_object_t a, b;
+
+  // nil objects cannot be locked
+  test_assert(objc_sync_enter(nil) != 0);
+  test_assert(objc_sync_exit(nil) != 0);
+
+  // An object which is not locked cannot be unlocked
+  test_assert(objc_sync_exit((id)&a) != 0);
+
+  // Locks are recursive, and can be nested
+  test_assert(objc_sync_enter((id)&a) == 0);
+  test_assert(objc_sync_enter((id)&a) == 0);
+  test_assert(objc_sync_enter((id)&b) == 0);
+  test_assert(objc_sync_exit((id)&b) == 0);
+  test_assert(objc_sync_exit((id)&a) == 0);
+  test_assert(objc_sync_exit((id)&a) == 0);
+  test_assert(objc_sync_exit((id)&a) != 0);
+
+  // Throughput from one thread up to the number of cores
+  int nthreads = sys_thread_numcores();
+  if (nthreads > MAX_THREADS) {
+    nthreads = MAX_THREADS;
+  }
+  for (int n = 1; n <= nthreads; n++) {
+    test_assert(benchmark(n, false) == 0);
+    test_assert(benchmark(n, true) == 0);
+  }
+  return 0;
+}
@@ -0,0 +1,143 @@
+#include "../../../runtime-sys/all/hashtable.h"
+#include <runtime-sys/sys.h>
+#include <tests/tests.h>
+
+// Number of keys and operations in the benchmark
+#ifdef SYSTEM_NAME_PICO
+#define KEYS 256
+#define OPERATIONS 100000
+#else
+#define KEYS 4096
+#define OPERATIONS 4000000
+#endif
+
+// Keys are small integers stored in the key pointer
+static bool key_equals(void *keyptr, void *other_keyptr) {
+  return keyptr == other_keyptr;
+}
+
+// Mix the bits of a key, so that consecutive keys are spread out
+static uintptr_t hash_key(uintptr_t key) {
+  uint32_t x = (uint32_t)key;
+  x ^= x >> 16;
+  x *= 0x7feb352d;
+  x ^= x >> 15;
+  x *= 0x846ca68b;
+  x ^= x >> 16;
+  return x;
+}
+
+// Return the entry for a key, or NULL
+static sys_hashtable_entry_t *get(sys_hashtable_t *table, uintptr_t key) {
+  return sys_hashtable_get_key(table, hash_key(key), (void *)key);
+}
+
+// Put a key with a value, and return true if the key is new
+static bool put(sys_hashtable_t *table, uintptr_t key, uintptr_t value) {
+  bool samekey = false;
+  sys_hashtable_entry_t *entry =
+      sys_hashtable_put(table, hash_key(key), (void *)key, &samekey);
+  test_assert(entry != NULL);
+  entry->value = value;
+  return samekey == false;
+}
+
+// Delete a key, and return true if it was in the table
+static bool delete(sys_hashtable_t *table, uintptr_t key) {
+  return sys_hashtable_delete_key(table, hash_key(key), (void *)key) != NULL;
+}
+
+int test_sys_19(void) {
+  // A table grows as keys are added, and keeps every key
+  sys_hashtable_t *table = sys_hashtable_init(4, key_equals);
+  test_assert(table != NULL);
+  for (uintptr_t key = 1; key <= 1000; key++) {
+    test_assert(put(table, key, key * 10));
+  }
+  test_assert(sys_hashtable_count(table) == 1000);
+  test_assert(sys_hashtable_capacity(table) >= 1000);
+  test_assert(sys_hashtable_capacity(table) <= 4 * 1000);
+  for (uintptr_t key = 1; key <= 1000; key++) {
+    sys_hashtable_entry_t *entry = get(table, key);
+    test_assert(entry != NULL);
+    test_assert(entry->value == key * 10);
+  }
+  test_assert(get(table, 1001) == NULL);
+
+  // Deleting and adding keys reuses the table without growing it, because
+  // tombstones are dropped when the table is rebuilt
+  size_t capacity = sys_hashtable_capacity(table);
+  for (uintptr_t key = 1; key <= 100000; key++) {
+    test_assert(delete(table, key));
+    test_assert(put(table, key + 1000, key));
+  }
+  test_assert(sys_hashtable_count(table) == 1000);
+  test_assert(sys_hashtable_capacity(table) == capacity);
+  for (uintptr_t key = 1; key <= 100000; key++) {
+    test_assert(get(table, key) == NULL);
+  }
+  for (uintptr_t key = 100001; key <= 101000; key++) {
+    test_assert(get(table, key) != NULL);
+  }
+  sys_hashtable_finalize(table);
+
+  // Keys stored in the entry move with it when the table grows
+  table = sys_hashtable_init(1, NULL);
+  test_assert(table != NULL);
+  for (uintptr_t i = 1; i <= 64; i++) {
+    sys_hashtable_entry_t *entry = sys_hashtable_put(table, i, NULL, NULL);
+    test_assert(entry != NULL);
+    sys_sprintf(entry->keybuf, sizeof(entry->keybuf), "key%u", (unsigned)i);
+    entry->keyptr = entry->keybuf;
+    entry->value = i;
+  }
+  for (uintptr_t i = 1; i <= 64; i++) {
+    char key[SYS_HASHTABLE_KEY_SIZE];
+    sys_sprintf(key, sizeof(key), "key%u", (unsigned)i);
+    sys_hashtable_entry_t *entry = sys_hashtable_get_key(table, i, NULL);
+    test_assert(entry != NULL);
+    test_assert(entry->keyptr == entry->keybuf);
+    test_assert(sys_strcmp(entry->keyptr, key) == 0);
+  }
+  sys_hashtable_finalize(table);
+
+  // Report the time for mixed lookups, inserts and deletes, and check that
+  // the table does not grow beyond the number of keys
+  table = sys_hashtable_init(16, key_equals);
+  test_assert(table != NULL);
+  bool present[KEYS] = {false};
+  size_t count = 0;
+  uint32_t seed = 1;
+  uint64_t start = sys_date_get_timestamp();
+  for (uint32_t i = 0; i < OPERATIONS; i++) {
+    seed = seed * 1664525 + 1013904223;
+    uintptr_t key = (seed >> 8) % KEYS;
+    switch (seed >> 30) {
+    case 0:
+      if (put(table, key + 1, i + 1)) {
+        present[key] = true;
+        count++;
+      }
+      break;
+    case 1:
+      if (delete(table, key + 1)) {
+        test_assert(present[key]);
+        present[key] = false;
+        count--;
+      }
+      break;
+    default:
+      test_assert((get(table, key + 1) != NULL) == present[key]);
+      break;
+    }
+  }
+  uint64_t ms = sys_date_get_timestamp() - start;
+  test_assert(sys_hashtable_count(table) == count);
+  test_assert(sys_hashtable_capacity(table) <= 4 * KEYS);
+  sys_printf("sys_19: operations=%u keys=%u capacity=%u time=%ums\n",
+             (unsigned)OPERATIONS, (unsigned)count,
+             (unsigned)sys_hashtable_capacity(table), (unsigned)ms);
+  sys_hashtable_finalize(table);
+
+  return 0;
+}
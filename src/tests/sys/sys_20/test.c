@@ -0,0 +1,177 @@
+#include <runtime-sys/sys.h>
+#include <tests/tests.h>
+
+// Number of keys and lookups in the benchmark
+#ifdef SYSTEM_NAME_PICO
+#define KEYS 512
+#define LOOKUPS 100000
+#else
+#define KEYS 50000
+#define LOOKUPS 10000000
+#endif
+
+// Keys are small integers stored in the key pointer
+static bool key_equals(void *keyptr, void *other_keyptr) {
+  return keyptr == other_keyptr;
+}
+
+// Mix the bits of a key, as a hash function for strings or objects would
+static uintptr_t hash_key(uintptr_t key) {
+  uint32_t x = (uint32_t)key;
+  x ^= x >> 16;
+  x *= 0x7feb352d;
+  x ^= x >> 15;
+  x *= 0x846ca68b;
+  x ^= x >> 16;
+  return x;
+}
+
+// Put a key with a value, and return true if the key is new
+static bool put(sys_hashtable_t *table, uintptr_t hash, uintptr_t key,
+                uintptr_t value) {
+  bool samekey = false;
+  sys_hashtable_entry_t *entry =
+      sys_hashtable_put(table, hash, (void *)key, &samekey);
+  test_assert(entry != NULL);
+  entry->value = value;
+  return samekey == false;
+}
+
+// Return the value for a key, or zero
+static uintptr_t get(sys_hashtable_t *table, uintptr_t hash, uintptr_t key) {
+  sys_hashtable_entry_t *entry =
+      sys_hashtable_get_key(table, hash, (void *)key);
+  return entry ? entry->value : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PREVIOUS LAYOUT
+
+// The previous layout of the table, with linear probing over the entries by
+// modulo of the hash, and a flag in each entry, for comparison
+typedef struct {
+  size_t size;
+  sys_hashtable_entry_t *entries;
+} linear_t;
+
+static void linear_put(linear_t *table, uintptr_t hash, uintptr_t key,
+                       uintptr_t value) {
+  size_t index = hash % table->size;
+  for (size_t i = 0; i < table->size; i++) {
+    sys_hashtable_entry_t *entry = &table->entries[index];
+    if (entry->flags == 0) {
+      entry->flags = 1;
+      entry->hash = hash;
+      entry->keyptr = (void *)key;
+      entry->value = value;
+      return;
+    }
+    index = (index + 1) % table->size;
+  }
+  test_assert(false); // The table is full
+}
+
+static uintptr_t linear_get(linear_t *table, uintptr_t hash, uintptr_t key) {
+  size_t index = hash % table->size;
+  for (size_t i = 0; i < table->size; i++) {
+    sys_hashtable_entry_t *entry = &table->entries[index];
+    if (entry->flags == 0) {
+      return 0;
+    }
+    if (entry->hash == hash && key_equals((void *)key, entry->keyptr)) {
+      return entry->value;
+    }
+    index = (index + 1) % table->size;
+  }
+  return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TESTS
+
+int test_sys_20(void) {
+  // Keys with the same hash, including zero, are found by comparing keys
+  sys_hashtable_t *table = sys_hashtable_init(8, key_equals);
+  test_assert(table != NULL);
+  for (uintptr_t key = 1; key <= 100; key++) {
+    test_assert(put(table, 0, key, key));
+  }
+  test_assert(sys_hashtable_count(table) == 100);
+  for (uintptr_t key = 1; key <= 100; key += 2) {
+    test_assert(sys_hashtable_delete_key(table, 0, (void *)key) != NULL);
+  }
+  for (uintptr_t key = 1; key <= 100; key++) {
+    test_assert(get(table, 0, key) == ((key & 1) ? 0 : key));
+  }
+  test_assert(get(table, 0, 101) == 0);
+  for (uintptr_t key = 1; key <= 100; key += 2) {
+    test_assert(put(table, 0, key, key));
+  }
+  test_assert(sys_hashtable_count(table) == 100);
+  sys_hashtable_finalize(table);
+
+  // Consecutive hashes are spread over the groups, and every key is found
+  // after deleting and adding keys
+  table = sys_hashtable_init(1, key_equals);
+  test_assert(table != NULL);
+  for (uintptr_t key = 1; key <= KEYS; key++) {
+    test_assert(put(table, key, key, key * 3));
+  }
+  test_assert(sys_hashtable_count(table) == KEYS);
+  size_t capacity = sys_hashtable_capacity(table);
+  test_assert((capacity & (capacity - 1)) == 0);
+  for (uintptr_t key = 1; key <= KEYS; key += 3) {
+    test_assert(sys_hashtable_delete_key(table, key, (void *)key) != NULL);
+  }
+  for (uintptr_t key = 1; key <= KEYS; key++) {
+    test_assert(get(table, key, key) == ((key % 3 == 1) ? 0 : key * 3));
+  }
+  for (uintptr_t key = 1; key <= KEYS; key += 3) {
+    test_assert(put(table, key, key, key * 3));
+  }
+  for (uintptr_t key = 1; key <= KEYS; key++) {
+    test_assert(get(table, key, key) == key * 3);
+    test_assert(get(table, key + KEYS, key + KEYS) == 0);
+  }
+  test_assert(sys_hashtable_capacity(table) == capacity);
+  sys_hashtable_finalize(table);
+
+  // Report the time for lookups of keys which are in the table, and keys
+  // which are not, compared to the previous layout of the same size
+  table = sys_hashtable_init(1, key_equals);
+  test_assert(table != NULL);
+  for (uintptr_t key = 1; key <= KEYS; key++) {
+    test_assert(put(table, hash_key(key), key, key));
+  }
+  capacity = sys_hashtable_capacity(table);
+  linear_t linear = {capacity, sys_malloc(capacity *
+                                          sizeof(sys_hashtable_entry_t))};
+  test_assert(linear.entries != NULL);
+  sys_memset(linear.entries, 0, capacity * sizeof(sys_hashtable_entry_t));
+  for (uintptr_t key = 1; key <= KEYS; key++) {
+    linear_put(&linear, hash_key(key), key, key);
+  }
+  for (int layout = 0; layout < 2; layout++) {
+    uint32_t seed = 1;
+    uintptr_t sum = 0;
+    uint64_t start = sys_date_get_timestamp();
+    for (uint32_t i = 0; i < LOOKUPS; i++) {
+      seed = seed * 1664525 + 1013904223;
+      uintptr_t key = 1 + (seed >> 8) % (2 * KEYS);
+      if (layout == 0) {
+        sum += linear_get(&linear, hash_key(key), key);
+      } else {
+        sum += get(table, hash_key(key), key);
+      }
+    }
+    uint64_t ms = sys_date_get_timestamp() - start;
+    test_assert(sum > 0);
+    sys_printf("sys_20: layout=%s keys=%u capacity=%u lookups=%u time=%ums\n",
+               layout ? "group" : "linear", (unsigned)KEYS,
+               (unsigned)capacity, (unsigned)LOOKUPS, (unsigned)ms);
+  }
+  sys_free(linear.entries);
+  sys_hashtable_finalize(table);
+
+  return 0;
+}
@@ -0,0 +1,124 @@
+#include <runtime-sys/sys.h>
+#include <tests/tests.h>
+
+// Number of events pushed by the timer callback
+#define EVENTS 200
+
+// Capacity of the queue, and the number of payloads in the pool
+#define CAPACITY 8
+#define SLOTS (CAPACITY + 2)
+
+// Payload of an event
+typedef struct {
+  uint32_t sequence;
+  uint32_t check;
+} payload_t;
+
+// Shared between the timer callback and the consumer
+typedef struct {
+  sys_event_queue_t queue;
+  sys_event_pool_t pool;
+  sys_timer_t timer;
+  sys_atomic_t sequence;
+  sys_atomic_t produced;
+  sys_atomic_t dropped;
+} test_data_t;
+
+// Timer callback, which allocates payloads from the pool and pushes them
+// into the queue, until all the events have been produced. Callbacks may
+// overlap, so each payload claims a unique sequence number.
+static void timer_callback(sys_timer_t *timer) {
+  test_data_t *data = (test_data_t *)timer->userdata;
+  if (sys_atomic_get(&data->produced) >= EVENTS) {
+    sys_event_queue_shutdown(&data->queue);
+    return;
+  }
+
+  // The pool may be empty while the consumer holds the payloads
+  payload_t *payload = sys_event_pool_alloc(&data->pool);
+  if (payload == NULL) {
+    sys_atomic_inc(&data->dropped);
+    return;
+  }
+  payload->sequence = sys_atomic_inc(&data->sequence) - 1;
+  payload->check = ~payload->sequence;
+  if (sys_event_queue_try_push(&data->queue, payload)) {
+    sys_atomic_inc(&data->produced);
+  } else {
+    sys_event_pool_free(&data->pool, payload);
+    sys_atomic_inc(&data->dropped);
+  }
+}
+
+int test_sys_21(void) {
+  // Every slot is distinct and aligned, and the pool does not grow
+  sys_event_pool_t pool = sys_event_pool_init(12, 40);
+  test_assert(sys_event_pool_valid(&pool));
+  void *slots[40];
+  for (int i = 0; i < 40; i++) {
+    slots[i] = sys_event_pool_alloc(&pool);
+    test_assert(slots[i] != NULL);
+    test_assert(((uintptr_t)slots[i] & 7) == 0);
+    for (int j = 0; j < i; j++) {
+      test_assert(slots[i] != slots[j]);
+    }
+    sys_memset(slots[i], 0xFF, 12);
+  }
+  test_assert(sys_event_pool_alloc(&pool) == NULL);
+  test_assert(sys_event_pool_used(&pool) == 40);
+
+  // A freed slot is allocated again
+  sys_event_pool_free(&pool, slots[35]);
+  test_assert(sys_event_pool_used(&pool) == 39);
+  test_assert(sys_event_pool_alloc(&pool) == slots[35]);
+  for (int i = 0; i < 40; i++) {
+    sys_event_pool_free(&pool, slots[i]);
+  }
+  sys_event_pool_free(&pool, NULL);
+  test_assert(sys_event_pool_used(&pool) == 0);
+  sys_event_pool_finalize(&pool);
+  test_assert(sys_event_pool_valid(&pool) == false);
+  test_assert(sys_event_pool_alloc(&pool) == NULL);
+
+  // Payloads are allocated in a timer callback while this thread frees them
+  static test_data_t data = {0};
+  data.queue = sys_event_queue_init(CAPACITY);
+  data.pool = sys_event_pool_init(sizeof(payload_t), SLOTS);
+  sys_atomic_init(&data.sequence, 0);
+  sys_atomic_init(&data.produced, 0);
+  sys_atomic_init(&data.dropped, 0);
+  test_assert(sys_event_queue_valid(&data.queue));
+  test_assert(sys_event_pool_valid(&data.pool));
+  data.timer = sys_timer_init(1, &data, timer_callback);
+  test_assert(sys_timer_start(&data.timer));
+
+  uint32_t consumed = 0;
+  while (true) {
+    payload_t *payload = sys_event_queue_pop(&data.queue);
+    if (payload == NULL) {
+      break;
+    }
+    test_assert(payload->check == ~payload->sequence);
+    consumed++;
+
+    // Hold some of the payloads, so the pool runs out while the timer fires
+    if (consumed % 50 == 0) {
+      sys_sleep(20);
+    }
+    sys_event_pool_free(&data.pool, payload);
+  }
+  test_assert(sys_timer_finalize(&data.timer));
+
+  // Wait for a callback which is still running, then every event which was
+  // pushed has been consumed, and every payload returned to the pool
+  sys_sleep(20);
+  test_assert(consumed >= EVENTS);
+  test_assert(consumed == sys_atomic_get(&data.produced));
+  test_assert(sys_event_pool_used(&data.pool) == 0);
+  sys_printf("sys_21: consumed=%u dropped=%u\n", (unsigned)consumed,
+             (unsigned)sys_atomic_get(&data.dropped));
+
+  sys_event_pool_finalize(&data.pool);
+  sys_event_queue_finalize(&data.queue);
+  return 0;
+}